@@ -0,0 +1,48 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGO_SERIAL_AGGREGATE_V2_H_
+#define DINGO_SERIAL_AGGREGATE_V2_H_
+
+#include <cstdint>
+
+#include "value.h"
+
+namespace dingodb {
+namespace serialV2 {
+
+/*
+ * COUNT, SUM, MIN and MAX of one numeric column.
+ *
+ * RecordDecoderV2::Aggregate adds to the result it is given, so a stream of
+ * batches is aggregated by passing the same result to every call.
+ */
+struct AggregateResult {
+  // Rows seen, i.e. COUNT(*).
+  int64_t rows{0};
+  // Non null values, i.e. COUNT(column).
+  int64_t count{0};
+  // SUM of integer and long columns, wrapping on overflow.
+  int64_t long_sum{0};
+  // SUM of float and double columns.
+  double double_sum{0};
+  // Null until a non null value is seen, then of the column type.
+  Value min;
+  Value max;
+};
+
+}  // namespace serialV2
+}  // namespace dingodb
+
+#endif
@@ -0,0 +1,370 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "arrow_export.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace dingodb {
+namespace serialV2 {
+
+namespace {
+
+struct SchemaPrivate {
+  std::string format;
+  std::string name;
+  std::vector<ArrowSchema*> children;
+  ArrowSchema* dictionary{nullptr};
+};
+
+struct ArrayPrivate {
+  ColumnVector column;
+  // Bit packed copy of column.bools.
+  std::vector<uint8_t> bits;
+  // Row offsets of a list column into its flattened child.
+  std::vector<int32_t> list_offsets;
+  const void* buffers[3]{nullptr, nullptr, nullptr};
+  std::vector<ArrowArray*> children;
+  ArrowArray* dictionary{nullptr};
+};
+
+// Children are released and freed by their parent unless the consumer moved
+// them out, which leaves their release callback null.
+void ReleaseSchema(ArrowSchema* schema) {
+  auto* private_data = static_cast<SchemaPrivate*>(schema->private_data);
+  for (auto* child : private_data->children) {
+    if (child->release != nullptr) {
+      child->release(child);
+    }
+    delete child;
+  }
+  if (auto* dictionary = private_data->dictionary; dictionary != nullptr) {
+    if (dictionary->release != nullptr) {
+      dictionary->release(dictionary);
+    }
+    delete dictionary;
+  }
+  delete private_data;
+  schema->release = nullptr;
+}
+
+void ReleaseArray(ArrowArray* array) {
+  auto* private_data = static_cast<ArrayPrivate*>(array->private_data);
+  for (auto* child : private_data->children) {
+    if (child->release != nullptr) {
+      child->release(child);
+    }
+    delete child;
+  }
+  if (auto* dictionary = private_data->dictionary; dictionary != nullptr) {
+    if (dictionary->release != nullptr) {
+      dictionary->release(dictionary);
+    }
+    delete dictionary;
+  }
+  delete private_data;
+  array->release = nullptr;
+}
+
+// Checked before anything is allocated, the exporters below assume it.
+bool IsExportable(const ColumnVector& column) {
+  if (column.dictionary) {
+    return column.type == BaseSchema::kString;
+  }
+  return column.type >= BaseSchema::kBool &&
+         column.type <= BaseSchema::kStringList;
+}
+
+BaseSchema::Type ElementType(BaseSchema::Type type) {
+  switch (type) {
+    case BaseSchema::kBoolList:
+      return BaseSchema::kBool;
+    case BaseSchema::kIntegerList:
+      return BaseSchema::kInteger;
+    case BaseSchema::kFloatList:
+      return BaseSchema::kFloat;
+    case BaseSchema::kLongList:
+      return BaseSchema::kLong;
+    case BaseSchema::kDoubleList:
+      return BaseSchema::kDouble;
+    case BaseSchema::kStringList:
+      return BaseSchema::kString;
+    default:
+      throw std::runtime_error("Unsupported schema type.");
+  }
+}
+
+const char* ArrowFormat(BaseSchema::Type type) {
+  switch (type) {
+    case BaseSchema::kBool:
+      return "b";
+    case BaseSchema::kInteger:
+      return "i";
+    case BaseSchema::kFloat:
+      return "f";
+    case BaseSchema::kLong:
+      return "l";
+    case BaseSchema::kDouble:
+      return "g";
+    case BaseSchema::kString:
+      return "z";
+    default:
+      return "+l";
+  }
+}
+
+void ExportSchema(const char* format, const std::string& name, int64_t flags,
+                  std::vector<ArrowSchema*>&& children, ArrowSchema* out,
+                  ArrowSchema* dictionary = nullptr) {
+  auto* private_data = new SchemaPrivate();
+  private_data->format = format;
+  private_data->name = name;
+  private_data->children = std::move(children);
+  private_data->dictionary = dictionary;
+
+  out->format = private_data->format.c_str();
+  out->name = private_data->name.c_str();
+  out->metadata = nullptr;
+  out->flags = flags;
+  out->n_children = private_data->children.size();
+  out->children = private_data->children.data();
+  out->dictionary = dictionary;
+  out->release = ReleaseSchema;
+  out->private_data = private_data;
+}
+
+void ExportColumnSchema(const ColumnVector& column, const std::string& name,
+                        ArrowSchema* out) {
+  BaseSchema::Type type = column.type;
+  if (column.dictionary) {
+    // int32 codes indexing a binary dictionary.
+    auto* dictionary = new ArrowSchema();
+    ExportSchema(ArrowFormat(type), "", 0, {}, dictionary);
+    ExportSchema(ArrowFormat(BaseSchema::kInteger), name, ARROW_FLAG_NULLABLE,
+                 {}, out, dictionary);
+    return;
+  }
+  std::vector<ArrowSchema*> children;
+  if (type >= BaseSchema::kBoolList) {
+    children.push_back(new ArrowSchema());
+    ExportSchema(ArrowFormat(ElementType(type)), "item", 0, {},
+                 children.back());
+  }
+  ExportSchema(ArrowFormat(type), name, ARROW_FLAG_NULLABLE,
+               std::move(children), out);
+}
+
+int64_t CountNull(const ColumnVector& column) {
+  int64_t not_null = 0;
+  for (uint8_t bits : column.validity) {
+    not_null += __builtin_popcount(bits);
+  }
+  return static_cast<int64_t>(column.size) - not_null;
+}
+
+// Element rows of a flattened list and dictionary entries are never null.
+void SetAllNotNull(ColumnVector& column) {
+  if (column.validity.empty()) {
+    return;
+  }
+  std::fill(column.validity.begin(), column.validity.end(), 0xff);
+  if (column.size % 8 != 0) {
+    column.validity.back() = (1 << (column.size % 8)) - 1;
+  }
+}
+
+// Flatten the Value rows of a list column into child, offsets[row] being the
+// first element of row in child.
+template <typename E>
+void FlattenList(const ColumnVector& column, std::vector<int32_t>& offsets,
+                 ColumnVector& child) {
+  offsets.resize(column.size + 1);
+  offsets[0] = 0;
+  for (size_t row = 0; row < column.size; ++row) {
+    const auto* list = std::get_if<std::vector<E>>(&column.values[row]);
+    offsets[row + 1] = offsets[row] + (list != nullptr ? list->size() : 0);
+  }
+
+  child.Reset(ElementType(column.type), offsets.back());
+  SetAllNotNull(child);
+  size_t pos = 0;
+  for (const auto& value : column.values) {
+    const auto* list = std::get_if<std::vector<E>>(&value);
+    if (list == nullptr) {
+      continue;
+    }
+    for (const auto& element : *list) {
+      if constexpr (std::is_same_v<E, bool>) {
+        child.bools[pos] = element;
+      } else if constexpr (std::is_same_v<E, int32_t>) {
+        child.ints[pos] = element;
+      } else if constexpr (std::is_same_v<E, float>) {
+        child.floats[pos] = element;
+      } else if constexpr (std::is_same_v<E, int64_t>) {
+        child.longs[pos] = element;
+      } else if constexpr (std::is_same_v<E, double>) {
+        child.doubles[pos] = element;
+      } else {
+        child.bytes.append(element);
+        child.offsets[pos + 1] = child.bytes.size();
+      }
+      ++pos;
+    }
+  }
+}
+
+void ExportColumn(ColumnVector&& column, ArrowArray* out) {
+  auto* private_data = new ArrayPrivate();
+  private_data->column = std::move(column);
+  auto& data = private_data->column;
+  const void** buffers = private_data->buffers;
+
+  buffers[0] = data.validity.data();
+  out->n_buffers = 2;
+  switch (data.type) {
+    case BaseSchema::kBool:
+      private_data->bits.assign((data.size + 7) / 8, 0);
+      for (size_t row = 0; row < data.size; ++row) {
+        if (data.bools[row]) {
+          private_data->bits[row >> 3] |= 1 << (row & 7);
+        }
+      }
+      buffers[1] = private_data->bits.data();
+      break;
+    case BaseSchema::kInteger:
+      buffers[1] = data.ints.data();
+      break;
+    case BaseSchema::kFloat:
+      buffers[1] = data.floats.data();
+      break;
+    case BaseSchema::kLong:
+      buffers[1] = data.longs.data();
+      break;
+    case BaseSchema::kDouble:
+      buffers[1] = data.doubles.data();
+      break;
+    case BaseSchema::kString:
+      if (data.dictionary) {
+        ColumnVector entries;
+        entries.Reset(BaseSchema::kString, data.DictionarySize());
+        SetAllNotNull(entries);
+        entries.offsets.swap(data.offsets);
+        entries.bytes.swap(data.bytes);
+        private_data->dictionary = new ArrowArray();
+        ExportColumn(std::move(entries), private_data->dictionary);
+        buffers[1] = data.codes.data();
+        break;
+      }
+      buffers[1] = data.offsets.data();
+      buffers[2] = data.bytes.data();
+      out->n_buffers = 3;
+      break;
+    default: {
+      ColumnVector child;
+      auto& offsets = private_data->list_offsets;
+      switch (data.type) {
+        case BaseSchema::kBoolList:
+          FlattenList<bool>(data, offsets, child);
+          break;
+        case BaseSchema::kIntegerList:
+          FlattenList<int32_t>(data, offsets, child);
+          break;
+        case BaseSchema::kFloatList:
+          FlattenList<float>(data, offsets, child);
+          break;
+        case BaseSchema::kLongList:
+          FlattenList<int64_t>(data, offsets, child);
+          break;
+        case BaseSchema::kDoubleList:
+          FlattenList<double>(data, offsets, child);
+          break;
+        case BaseSchema::kStringList:
+          FlattenList<std::string>(data, offsets, child);
+          break;
+        default:
+          throw std::runtime_error("Unsupported schema type.");
+      }
+      buffers[1] = offsets.data();
+      private_data->children.push_back(new ArrowArray());
+      ExportColumn(std::move(child), private_data->children.back());
+      break;
+    }
+  }
+
+  out->length = data.size;
+  out->null_count = CountNull(data);
+  out->offset = 0;
+  out->n_children = private_data->children.size();
+  out->buffers = buffers;
+  out->children = private_data->children.data();
+  out->dictionary = private_data->dictionary;
+  out->release = ReleaseArray;
+  out->private_data = private_data;
+}
+
+}  // namespace
+
+int ExportArrowBatch(std::vector<ColumnVector>&& columns,
+                     const std::vector<std::string>& names,
+                     ArrowSchema* schema, ArrowArray* array) {
+  if (names.size() != columns.size()) {
+    return -1;
+  }
+  size_t rows = columns.empty() ? 0 : columns[0].size;
+  for (const auto& column : columns) {
+    if (column.size != rows || !IsExportable(column)) {
+      return -1;
+    }
+  }
+
+  std::vector<ArrowSchema*> child_schemas;
+  child_schemas.reserve(columns.size());
+  for (size_t i = 0; i < columns.size(); ++i) {
+    child_schemas.push_back(new ArrowSchema());
+    ExportColumnSchema(columns[i], names[i], child_schemas.back());
+  }
+  ExportSchema("+s", "", 0, std::move(child_schemas), schema);
+
+  auto* private_data = new ArrayPrivate();
+  private_data->children.reserve(columns.size());
+  for (auto& column : columns) {
+    private_data->children.push_back(new ArrowArray());
+    ExportColumn(std::move(column), private_data->children.back());
+  }
+  columns.clear();
+
+  array->length = rows;
+  array->null_count = 0;
+  array->offset = 0;
+  array->n_buffers = 1;
+  array->n_children = private_data->children.size();
+  array->buffers = private_data->buffers;
+  array->children = private_data->children.data();
+  array->dictionary = nullptr;
+  array->release = ReleaseArray;
+  array->private_data = private_data;
+
+  return 0;
+}
+
+}  // namespace serialV2
+}  // namespace dingodb
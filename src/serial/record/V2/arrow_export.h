@@ -0,0 +1,95 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGO_SERIAL_ARROW_EXPORT_V2_H_
+#define DINGO_SERIAL_ARROW_EXPORT_V2_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "column_vector.h"
+
+// Arrow C data interface, the structs are part of the Arrow ABI and are
+// declared here as the specification asks so no Arrow library is needed.
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+struct ArrowSchema {
+  // Array type description
+  const char* format;
+  const char* name;
+  const char* metadata;
+  int64_t flags;
+  int64_t n_children;
+  struct ArrowSchema** children;
+  struct ArrowSchema* dictionary;
+
+  // Release callback
+  void (*release)(struct ArrowSchema*);
+  // Opaque producer-specific data
+  void* private_data;
+};
+
+struct ArrowArray {
+  // Array data description
+  int64_t length;
+  int64_t null_count;
+  int64_t offset;
+  int64_t n_buffers;
+  int64_t n_children;
+  const void** buffers;
+  struct ArrowArray** children;
+  struct ArrowArray* dictionary;
+
+  // Release callback
+  void (*release)(struct ArrowArray*);
+  // Opaque producer-specific data
+  void* private_data;
+};
+
+#endif  // ARROW_C_DATA_INTERFACE
+
+namespace dingodb {
+namespace serialV2 {
+
+/*
+ * Export a decoded batch as one Arrow struct array, columns[i] becoming the
+ * child named names[i].
+ *
+ * The columns are moved into the exported array and their buffers are handed
+ * out as is, except bools which Arrow bit packs and list columns which are
+ * flattened into a child array. Types map as
+ *   kBool "b", kInteger "i", kFloat "f", kLong "l", kDouble "g",
+ *   kString "z", k*List "+l" of the element type.
+ * Strings are exported as binary since nothing checks they are valid UTF-8.
+ * Dictionary string columns export their codes as "i" with the distinct
+ * strings as a "z" dictionary.
+ * The consumer owns schema and array and must call their release callbacks.
+ * Returns -1 if names or the column sizes do not match or a column has an
+ * unknown type, nothing is exported then.
+ */
+int ExportArrowBatch(std::vector<ColumnVector>&& columns,
+                     const std::vector<std::string>& names,
+                     ArrowSchema* schema /*output*/,
+                     ArrowArray* array /*output*/);
+
+}  // namespace serialV2
+}  // namespace dingodb
+
+#endif
@@ -0,0 +1,139 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "codec_plan.h"
+
+#include <vector>
+
+namespace dingodb {
+namespace serialV2 {
+
+static int FixedWidth(BaseSchema::Type type) {
+  switch (type) {
+    case BaseSchema::kBool:
+      return 1;
+    case BaseSchema::kInteger:
+    case BaseSchema::kFloat:
+      return 4;
+    case BaseSchema::kLong:
+    case BaseSchema::kDouble:
+      return 8;
+    default:
+      return 0;
+  }
+}
+
+static bool UsesDeltaValue(const CodecOp& op) {
+  return op.schema != nullptr && !op.is_key && op.schema->IsDeltaValue() &&
+         (op.type == BaseSchema::kIntegerList ||
+          op.type == BaseSchema::kLongList);
+}
+
+// Delta lists are never compact.
+static bool UsesCompactValue(const CodecOp& op) {
+  if (op.schema == nullptr || op.is_key || !op.schema->IsCompactValue() ||
+      UsesDeltaValue(op)) {
+    return false;
+  }
+  return op.type == BaseSchema::kInteger || op.type == BaseSchema::kLong ||
+         op.type == BaseSchema::kIntegerList ||
+         op.type == BaseSchema::kLongList;
+}
+
+CodecPlan CodecPlan::Build(const std::vector<BaseSchemaPtr>& schemas) {
+  CodecPlan plan;
+  plan.columns.resize(schemas.size());
+
+  // The encoder lays value columns out in schema order, so the n-th value
+  // schema is expected in the n-th slot of the ids/offsets table. Fixed
+  // block values move the fixed width columns ahead as SortSchema does, but
+  // keep both groups in schema order so appended columns land at the end.
+  int value_slot = 0;
+  for (size_t i = 0; i < schemas.size(); ++i) {
+    const auto& schema = schemas[i];
+    CodecOp& op = plan.columns[i];
+    op.position = i;
+    if (schema == nullptr) {
+      continue;
+    }
+
+    op.type = schema->GetType();
+    op.index = schema->GetIndex();
+    op.is_key = schema->IsKey();
+    op.nullable = schema->AllowNull();
+    op.schema = schema.get();
+    op.delta = UsesDeltaValue(op);
+    op.compact = UsesCompactValue(op);
+    op.fixed_width = op.compact ? 0 : FixedWidth(op.type);
+
+    if (op.is_key) {
+      plan.keys.push_back(op);
+    } else {
+      op.value_slot = value_slot++;
+      if (op.fixed_width > 0) {
+        op.fixed_offset = plan.fixed_block_size;
+        plan.fixed_block_size += op.fixed_width;
+      } else {
+        op.var_slot = plan.var_values.size();
+      }
+      plan.values.push_back(op);
+      (op.fixed_width > 0 ? plan.fixed_values : plan.var_values).push_back(op);
+    }
+  }
+
+  for (const auto& op : plan.values) {
+    if (static_cast<size_t>(op.index) >= plan.value_slot_by_id.size()) {
+      plan.value_slot_by_id.resize(op.index + 1, -1);
+    }
+    plan.value_slot_by_id[op.index] = op.value_slot;
+  }
+
+  return plan;
+}
+
+void CodecPlan::SetCompactValues(bool compact) {
+  for (auto* ops : {&columns, &values, &var_values}) {
+    for (auto& op : *ops) {
+      op.compact = compact && UsesCompactValue(op);
+    }
+  }
+}
+
+bool CodecPlan::HasCompactValues() const {
+  for (const auto& op : values) {
+    if (op.compact) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void CodecPlan::SetDeltaLists(bool delta) {
+  for (auto* ops : {&columns, &values, &var_values}) {
+    for (auto& op : *ops) {
+      op.delta = delta && UsesDeltaValue(op);
+    }
+  }
+}
+
+void CodecPlan::SetPackedBoolLists(bool packed) {
+  for (auto* ops : {&columns, &values, &var_values}) {
+    for (auto& op : *ops) {
+      op.packed = packed && op.type == BaseSchema::kBoolList;
+    }
+  }
+}
+
+}  // namespace serialV2
+}  // namespace dingodb
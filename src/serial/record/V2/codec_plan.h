@@ -0,0 +1,326 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGO_SERIAL_CODEC_PLAN_V2_H_
+#define DINGO_SERIAL_CODEC_PLAN_V2_H_
+
+#include <any>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "serial/schema/V2/boolean_list_schema.h"
+#include "serial/schema/V2/boolean_schema.h"
+#include "serial/schema/V2/double_list_schema.h"
+#include "serial/schema/V2/double_schema.h"
+#include "serial/schema/V2/float_list_schema.h"
+#include "serial/schema/V2/float_schema.h"
+#include "serial/schema/V2/integer_list_schema.h"
+#include "serial/schema/V2/integer_schema.h"
+#include "serial/schema/V2/long_list_schema.h"
+#include "serial/schema/V2/long_schema.h"
+#include "serial/schema/V2/string_list_schema.h"
+#include "serial/schema/V2/string_schema.h"
+#include "value.h"
+
+namespace dingodb {
+namespace serialV2 {
+
+/*
+ * One column of a codec plan.
+ *
+ * The schema pointer is borrowed from the schema vector owned by the encoder
+ * or decoder that built the plan, so running a plan never touches a
+ * shared_ptr refcount.
+ */
+struct CodecOp {
+  BaseSchema::Type type{BaseSchema::kBool};
+  // Position of the column in the schema vector.
+  int position{0};
+  // Column id, i.e. BaseSchema::GetIndex().
+  int index{0};
+  bool is_key{false};
+  bool nullable{false};
+  // Encoded value length of fixed width types, 0 for variable width ones.
+  int fixed_width{0};
+  // Expected slot in the value ids/offsets table, -1 for key columns.
+  int value_slot{-1};
+  // Offset in the fixed block of a fixed block value for fixed width value
+  // columns, slot in its variable width offsets table for the others, -1
+  // otherwise.
+  int fixed_offset{-1};
+  int var_slot{-1};
+  // Bool list written in the bit packed form.
+  bool packed{false};
+  // Int, long or list of them written in the compact form when the value
+  // header is flagged VALUE_COMPACT. Such columns are variable width.
+  bool compact{false};
+  // Int or long list written delta packed when that is smaller.
+  bool delta{false};
+  BaseSchema* schema{nullptr};
+};
+
+/*
+ * Schema vector compiled once into flat arrays of ops.
+ *
+ * columns holds one op per schema position (schema is nullptr for holes),
+ * keys and values hold the key and value columns in encoding order.
+ */
+struct CodecPlan {
+  std::vector<CodecOp> columns;
+  std::vector<CodecOp> keys;
+  std::vector<CodecOp> values;
+  // values index of each column id, -1 for ids of key columns and holes.
+  std::vector<int> value_slot_by_id;
+  // values split into fixed and variable width columns, each in schema
+  // order, and the bytes of all fixed width values.
+  std::vector<CodecOp> fixed_values;
+  std::vector<CodecOp> var_values;
+  int fixed_block_size{0};
+
+  static CodecPlan Build(const std::vector<BaseSchemaPtr>& schemas);
+
+  // Mark every bool list column for the bit packed form, or clear it.
+  void SetPackedBoolLists(bool packed);
+  // Mark the value columns whose schema asks for the compact form, or clear
+  // them all. Their width stays variable either way.
+  void SetCompactValues(bool compact);
+  bool HasCompactValues() const;
+  // Mark the list columns whose schema asks for the delta form, or clear
+  // them all.
+  void SetDeltaLists(bool delta);
+};
+
+/*
+ * Call f with the schema of op cast to its concrete DingoSchema<T>.
+ *
+ * The specializations are final, so member calls made through the cast
+ * pointer are direct calls instead of virtual ones.
+ */
+template <typename F>
+inline auto VisitSchema(const CodecOp& op, F&& f) {
+  switch (op.type) {
+    case BaseSchema::kBool:
+      return f(static_cast<DingoSchema<bool>*>(op.schema));
+    case BaseSchema::kInteger:
+      return f(static_cast<DingoSchema<int32_t>*>(op.schema));
+    case BaseSchema::kFloat:
+      return f(static_cast<DingoSchema<float>*>(op.schema));
+    case BaseSchema::kLong:
+      return f(static_cast<DingoSchema<int64_t>*>(op.schema));
+    case BaseSchema::kDouble:
+      return f(static_cast<DingoSchema<double>*>(op.schema));
+    case BaseSchema::kString:
+      return f(static_cast<DingoSchema<std::string>*>(op.schema));
+    case BaseSchema::kBoolList:
+      return f(static_cast<DingoSchema<std::vector<bool>>*>(op.schema));
+    case BaseSchema::kIntegerList:
+      return f(static_cast<DingoSchema<std::vector<int32_t>>*>(op.schema));
+    case BaseSchema::kFloatList:
+      return f(static_cast<DingoSchema<std::vector<float>>*>(op.schema));
+    case BaseSchema::kLongList:
+      return f(static_cast<DingoSchema<std::vector<int64_t>>*>(op.schema));
+    case BaseSchema::kDoubleList:
+      return f(static_cast<DingoSchema<std::vector<double>>*>(op.schema));
+    case BaseSchema::kStringList:
+      return f(static_cast<DingoSchema<std::vector<std::string>>*>(op.schema));
+    default:
+      throw std::runtime_error("Unsupported schema type.");
+  }
+}
+
+// Types with a compact value form, see BaseSchema::SetCompactValue.
+template <typename T>
+inline constexpr bool kHasCompactValue =
+    std::is_same_v<T, int32_t> || std::is_same_v<T, int64_t> ||
+    std::is_same_v<T, std::vector<int32_t>> ||
+    std::is_same_v<T, std::vector<int64_t>>;
+
+// Types with a delta value form, see BaseSchema::SetDeltaValue.
+template <typename T>
+inline constexpr bool kHasDeltaValue =
+    std::is_same_v<T, std::vector<int32_t>> ||
+    std::is_same_v<T, std::vector<int64_t>>;
+
+// Typed access for Value records. A decoded column reuses the storage of the
+// alternative already held by out, so decoding into the same record again
+// does not reallocate strings and lists.
+template <typename T>
+inline int EncodeKeyAs(DingoSchema<T>* schema, const Value& column, Buf& buf) {
+  return schema->EncodeKey(ValueDataPtr<T>(column), buf);
+}
+
+template <typename T>
+inline T& ValueStorage(Value& out) {
+  T* data = std::get_if<T>(&out);
+  return data != nullptr ? *data : out.template emplace<T>();
+}
+
+template <typename T>
+inline void DecodeKeyAs(DingoSchema<T>* schema, BufView& buf, Value& out) {
+  if (!schema->DecodeKey(buf, ValueStorage<T>(out))) {
+    out = Value();
+  }
+}
+
+// Decode a value column into data, compact tells whether it was written in
+// the compact form, i.e. ValueHeader::IsCompact.
+template <typename T>
+inline void DecodeValueData(DingoSchema<T>* schema, bool compact, BufView& buf,
+                            T& data) {
+  if constexpr (kHasCompactValue<T>) {
+    if (compact) {
+      schema->DecodeCompactValue(buf, data);
+      return;
+    }
+  }
+  schema->DecodeValue(buf, data);
+}
+
+template <typename T>
+inline void DecodeValueAs(DingoSchema<T>* schema, BufView& buf, Value& out,
+                          bool compact = false) {
+  DecodeValueData(schema, compact, buf, ValueStorage<T>(out));
+}
+
+template <typename T>
+inline std::any DecodeValueAny(DingoSchema<T>* schema, BufView& buf,
+                               bool compact) {
+  if constexpr (kHasCompactValue<T>) {
+    if (compact) {
+      T data;
+      schema->DecodeCompactValue(buf, data);
+      return std::any(std::move(data));
+    }
+  }
+  return schema->DecodeValue(buf);
+}
+
+template <typename T>
+inline const T* ColumnDataPtr(const std::any& column) {
+  return AnyDataPtr<T>(column);
+}
+
+template <typename T>
+inline const T* ColumnDataPtr(const Value& column) {
+  return ValueDataPtr<T>(column);
+}
+
+template <typename T, typename C>
+inline int GetEncodedKeySizeAs(DingoSchema<T>* schema, const C& column) {
+  return schema->GetEncodedKeySize(ColumnDataPtr<T>(column));
+}
+
+// Value columns go through op, which may ask for the packed bool list, the
+// delta or the compact form.
+template <typename T, typename C>
+inline int GetEncodedValueSizeAs(const CodecOp& op, DingoSchema<T>* schema,
+                                 const C& column) {
+  if constexpr (std::is_same_v<T, std::vector<bool>>) {
+    if (op.packed) {
+      return schema->GetEncodedPackedValueSize(ColumnDataPtr<T>(column));
+    }
+  }
+  if constexpr (kHasDeltaValue<T>) {
+    if (op.delta) {
+      return schema->GetEncodedDeltaValueSize(ColumnDataPtr<T>(column));
+    }
+  }
+  if constexpr (kHasCompactValue<T>) {
+    if (op.compact) {
+      return schema->GetEncodedCompactValueSize(ColumnDataPtr<T>(column));
+    }
+  }
+  return schema->GetEncodedValueSize(ColumnDataPtr<T>(column));
+}
+
+template <typename T, typename C>
+inline int EncodeValueAs(const CodecOp& op, DingoSchema<T>* schema,
+                         const C& column, Buf& buf) {
+  if constexpr (std::is_same_v<T, std::vector<bool>>) {
+    if (op.packed) {
+      return schema->EncodePackedValue(ColumnDataPtr<T>(column), buf);
+    }
+  }
+  if constexpr (kHasDeltaValue<T>) {
+    if (op.delta) {
+      return schema->EncodeDeltaValue(ColumnDataPtr<T>(column), buf);
+    }
+  }
+  if constexpr (kHasCompactValue<T>) {
+    if (op.compact) {
+      return schema->EncodeCompactValue(ColumnDataPtr<T>(column), buf);
+    }
+  }
+  return schema->EncodeValue(ColumnDataPtr<T>(column), buf);
+}
+
+// Column codec for both record representations.
+template <typename C>
+inline int GetEncodedKeyColumnSize(const CodecOp& op, const C& column) {
+  return VisitSchema(
+      op, [&](auto* schema) { return GetEncodedKeySizeAs(schema, column); });
+}
+
+template <typename C>
+inline int GetEncodedValueColumnSize(const CodecOp& op, const C& column) {
+  return VisitSchema(op, [&](auto* schema) {
+    return GetEncodedValueSizeAs(op, schema, column);
+  });
+}
+
+inline int EncodeKeyColumn(const CodecOp& op, const std::any& column,
+                           Buf& buf) {
+  return VisitSchema(
+      op, [&](auto* schema) { return schema->EncodeKey(column, buf); });
+}
+
+inline int EncodeKeyColumn(const CodecOp& op, const Value& column, Buf& buf) {
+  return VisitSchema(
+      op, [&](auto* schema) { return EncodeKeyAs(schema, column, buf); });
+}
+
+template <typename C>
+inline int EncodeValueColumn(const CodecOp& op, const C& column, Buf& buf) {
+  return VisitSchema(
+      op, [&](auto* schema) { return EncodeValueAs(op, schema, column, buf); });
+}
+
+inline void DecodeKeyColumn(const CodecOp& op, BufView& buf, std::any& out) {
+  out = VisitSchema(op, [&](auto* schema) { return schema->DecodeKey(buf); });
+}
+
+inline void DecodeKeyColumn(const CodecOp& op, BufView& buf, Value& out) {
+  VisitSchema(op, [&](auto* schema) { DecodeKeyAs(schema, buf, out); });
+}
+
+inline void DecodeValueColumn(const CodecOp& op, BufView& buf, std::any& out,
+                              bool compact = false) {
+  out = VisitSchema(
+      op, [&](auto* schema) { return DecodeValueAny(schema, buf, compact); });
+}
+
+inline void DecodeValueColumn(const CodecOp& op, BufView& buf, Value& out,
+                              bool compact = false) {
+  VisitSchema(op,
+              [&](auto* schema) { DecodeValueAs(schema, buf, out, compact); });
+}
+
+}  // namespace serialV2
+}  // namespace dingodb
+
+#endif
@@ -0,0 +1,159 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGO_SERIAL_COLUMN_VECTOR_V2_H_
+#define DINGO_SERIAL_COLUMN_VECTOR_V2_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+#include "serial/schema/V2/base_schema.h"
+#include "value.h"
+
+namespace dingodb {
+namespace serialV2 {
+
+/*
+ * One decoded column of a batch of rows.
+ *
+ * Fixed width columns keep one slot per row in the vector matching their
+ * type, null rows are left 0. String columns pack the bytes of every row
+ * into one arena, row i being bytes[offsets[i], offsets[i + 1]). List columns
+ * fall back to one Value per row. Bit i of validity is set when row i is not
+ * null.
+ *
+ * Dictionary string columns, see RecordDecoderV2::SetDictionaryBatch, keep
+ * each distinct string of the batch once, entry c being bytes[offsets[c],
+ * offsets[c + 1]), and codes[i] is the entry of row i, 0 for null rows.
+ * Codes are dense from 0 in order of first appearance, so they can key a
+ * group by directly.
+ *
+ * Reset keeps the capacity of every buffer, so a ColumnVector reused across
+ * batches stops allocating once it has seen the largest one. The lists of a
+ * list column are emptied in place for that, so a null row holds either
+ * null or an empty list, check validity to tell them apart.
+ */
+struct ColumnVector {
+  BaseSchema::Type type{BaseSchema::kBool};
+  size_t size{0};
+  std::vector<uint8_t> validity;
+
+  std::vector<uint8_t> bools;
+  std::vector<int32_t> ints;
+  std::vector<float> floats;
+  std::vector<int64_t> longs;
+  std::vector<double> doubles;
+
+  std::vector<uint32_t> offsets;
+  std::string bytes;
+  bool dictionary{false};
+  std::vector<int32_t> codes;
+
+  std::vector<Value> values;
+
+  void Reset(BaseSchema::Type column_type, size_t rows,
+             bool dictionary_strings = false) {
+    type = column_type;
+    size = rows;
+    dictionary = dictionary_strings && type == BaseSchema::kString;
+    validity.assign((rows + 7) / 8, 0);
+
+    bools.clear();
+    ints.clear();
+    floats.clear();
+    longs.clear();
+    doubles.clear();
+    offsets.clear();
+    bytes.clear();
+    codes.clear();
+
+    switch (type) {
+      case BaseSchema::kBool:
+        bools.resize(rows);
+        break;
+      case BaseSchema::kInteger:
+        ints.resize(rows);
+        break;
+      case BaseSchema::kFloat:
+        floats.resize(rows);
+        break;
+      case BaseSchema::kLong:
+        longs.resize(rows);
+        break;
+      case BaseSchema::kDouble:
+        doubles.resize(rows);
+        break;
+      case BaseSchema::kString:
+        if (dictionary) {
+          offsets.push_back(0);
+          codes.resize(rows);
+        } else {
+          offsets.resize(rows + 1);
+        }
+        break;
+      default:
+        ResetLists(rows);
+        break;
+    }
+  }
+
+  bool IsNull(size_t row) const {
+    return (validity[row >> 3] & (1 << (row & 7))) == 0;
+  }
+  void SetNotNull(size_t row) { validity[row >> 3] |= 1 << (row & 7); }
+
+  std::string_view GetString(size_t row) const {
+    if (dictionary) {
+      return IsNull(row) ? std::string_view() : GetEntry(codes[row]);
+    }
+    return GetEntry(row);
+  }
+
+  // Empty the lists of the first rows instead of destroying them, entries of
+  // another type become null.
+  void ResetLists(size_t rows) {
+    values.resize(rows);
+    for (auto& value : values) {
+      if (value.index() != static_cast<size_t>(type) + 1) {
+        value = Value();
+        continue;
+      }
+      std::visit(
+          [](auto& list) {
+            using L = std::decay_t<decltype(list)>;
+            if constexpr (std::is_class_v<L> &&
+                          !std::is_same_v<L, std::monostate>) {
+              list.clear();
+            }
+          },
+          value);
+    }
+  }
+
+  size_t DictionarySize() const { return dictionary ? offsets.size() - 1 : 0; }
+  std::string_view GetEntry(size_t code) const {
+    return std::string_view(bytes.data() + offsets[code],
+                            offsets[code + 1] - offsets[code]);
+  }
+};
+
+}  // namespace serialV2
+}  // namespace dingodb
+
+#endif
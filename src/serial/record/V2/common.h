@@ -21,11 +21,19 @@
 
 namespace dingodb {
 namespace serialV2 {
-enum idUnit { ID_1_BYTE = 0x01, ID_2_BYTE = 0x02 };
+// ID_IMPLIED marks a dense V3 value: no ids are stored, the n-th value column
+// of the schema is in the n-th slot and nulls are kept in a bitmap.
+enum idUnit { ID_IMPLIED = 0x00, ID_1_BYTE = 0x01, ID_2_BYTE = 0x02 };
 
 enum offsetUnitFlag { OFFSET_2_BYTE = 0x02, OFFSET_4_BYTE = 0x04 };
 
-enum codecVersion { CODEC_VERSION_V1 = 0x01, CODEC_VERSION_V2 = 0x02 };
+// V3 only changes the value header: a units byte follows the schema version
+// and ids / offsets are stored in those units.
+enum codecVersion {
+  CODEC_VERSION_V1 = 0x01,
+  CODEC_VERSION_V2 = 0x02,
+  CODEC_VERSION_V3 = 0x03
+};
 
 inline int CalcIdUnit(int not_null_id_cnt, int null_id_cnt) {
   return (not_null_id_cnt + null_id_cnt) < 255 ? ID_1_BYTE : ID_2_BYTE;
@@ -36,7 +44,7 @@ inline void WriteCountInfo(Buf& buf, int pos, int not_null_cnt, int null_cnt) {
   buf.WriteShort(pos + 2, null_cnt);
 }
 
-inline void GetCountInfo(Buf& buf, int& pos, int& not_null_cnt, int& null_cnt) {
+inline void GetCountInfo(BufView& buf, int& pos, int& not_null_cnt, int& null_cnt) {
   null_cnt = buf.ReadShort(pos - 2);
   not_null_cnt = buf.ReadShort(pos - 4);
   pos -= 4;
@@ -47,11 +55,48 @@ inline void WriteOffsetUnit(Buf& buf, const int pos,
   buf.WriteByte(pos, offset_unit);
 }
 
-inline void GetOffsetUnit(Buf& buf, int& pos, int& offset_unit) {
+inline void GetOffsetUnit(BufView& buf, int& pos, int& offset_unit) {
   offset_unit = buf.Read(pos - 1);
   pos -= 1;
 }
 
+// Units byte of the V3 value header, the id unit in the high nibble and the
+// offset unit in the low one. The top bit flags a sparse value, whose tables
+// only hold the non null columns, sorted by id. VALUE_FIXED_BLOCK flags a
+// value whose fixed width columns sit in a block at constant offsets.
+// VALUE_COMPACT flags a value whose compact columns (see
+// BaseSchema::SetCompactValue) are written in their varint form.
+// VALUE_DEFLATED flags a value whose bytes past the units byte are deflated,
+// offset units being even leaves the low bit free for it.
+enum valueUnitsFlag {
+  VALUE_DEFLATED = 0x01,
+  VALUE_FIXED_BLOCK = 0x08,
+  VALUE_COMPACT = 0x40,
+  VALUE_SPARSE = 0x80
+};
+
+inline uint8_t MakeValueUnits(int id_unit, int offset_unit) {
+  return (id_unit << 4) | offset_unit;
+}
+
+inline int GetValueIdUnit(uint8_t units) { return (units >> 4) & 0x03; }
+
+inline bool IsSparseValue(uint8_t units) { return units & VALUE_SPARSE; }
+
+inline bool IsFixedBlockValue(uint8_t units) {
+  return units & VALUE_FIXED_BLOCK;
+}
+
+inline bool IsCompactValue(uint8_t units) { return units & VALUE_COMPACT; }
+
+inline bool IsDeflatedValue(uint8_t units) { return units & VALUE_DEFLATED; }
+
+inline int GetValueOffsetUnit(uint8_t units) { return units & 0x06; }
+
+// Bytes of the null bitmap of a dense value, bit i of byte i / 8 is set when
+// slot i is null.
+inline int NullBitmapSize(int col_cnt) { return (col_cnt + 7) / 8; }
+
 }  // namespace serialV2
 }  // namespace dingodb
 
@@ -16,8 +16,13 @@
 
 #include <algorithm>
 #include <cstdint>
-#include <map>
+#include <functional>
 #include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -30,52 +35,183 @@ namespace serialV2 {
 // The worker buffer capacity.
 constexpr int kBufInitCapacity = 2048;
 
-using CastAndDecodeOrSkipFuncPointer =
-    void (*)(BaseSchemaPtr schema, Buf& key_buf, Buf& value_buf,
-             std::vector<std::any>& record, int record_index, bool skip,
-             std::map<int, int>& id_offset_map);
+// Decode the column described by op into out. Value columns are located
+// through the value header, missing and null ones decode to null.
+template <typename Out>
+static inline void DecodeColumn(const CodecOp& op, BufView& key_buf,
+                                BufView& value_buf,
+                                const ValueHeader& value_header, Out& out) {
+  if (op.is_key) {
+    DecodeKeyColumn(op, key_buf, out);
+    return;
+  }
+
+  int offset = value_header.FindOffset(value_buf, op);
+  if (offset == -1) {
+    out = Out();
+  } else {
+    value_buf.SetReadOffset(offset);
+    DecodeValueColumn(op, value_buf, out, value_header.IsCompact(op));
+  }
+}
+
+// Store a decoded scalar in row of its column vector.
+static inline void StoreCell(ColumnVector& column, size_t row, bool data) {
+  column.bools[row] = data;
+}
+static inline void StoreCell(ColumnVector& column, size_t row, int32_t data) {
+  column.ints[row] = data;
+}
+static inline void StoreCell(ColumnVector& column, size_t row, float data) {
+  column.floats[row] = data;
+}
+static inline void StoreCell(ColumnVector& column, size_t row, int64_t data) {
+  column.longs[row] = data;
+}
+static inline void StoreCell(ColumnVector& column, size_t row, double data) {
+  column.doubles[row] = data;
+}
+
+/*
+ * Codes of the distinct strings of a dictionary column. Open addressing over
+ * the codes, the strings themselves are only kept in the column, so the
+ * table stays valid while its byte arena grows.
+ */
+class StringDictionary {
+ public:
+  int32_t Add(ColumnVector& column, std::string_view data) {
+    if (2 * (column.DictionarySize() + 1) > slots_.size()) {
+      Grow(column);
+    }
+    size_t mask = slots_.size() - 1;
+    size_t slot = std::hash<std::string_view>()(data) & mask;
+    for (; slots_[slot] != 0; slot = (slot + 1) & mask) {
+      int32_t code = slots_[slot] - 1;
+      if (column.GetEntry(code) == data) {
+        return code;
+      }
+    }
+    int32_t code = column.DictionarySize();
+    column.bytes.append(data);
+    column.offsets.push_back(column.bytes.size());
+    slots_[slot] = code + 1;
+    return code;
+  }
+
+ private:
+  void Grow(const ColumnVector& column) {
+    slots_.assign(std::max<size_t>(16, 2 * slots_.size()), 0);
+    size_t mask = slots_.size() - 1;
+    for (size_t code = 0; code < column.DictionarySize(); ++code) {
+      size_t slot = std::hash<std::string_view>()(column.GetEntry(code)) & mask;
+      while (slots_[slot] != 0) {
+        slot = (slot + 1) & mask;
+      }
+      slots_[slot] = code + 1;
+    }
+  }
+
+  // code + 1 of the entry in each slot, 0 for an empty one.
+  std::vector<int32_t> slots_;
+};
 
+// Decode one key or value column of row into column. String values are read
+// in place and appended to the byte arena or looked up in dictionary, string
+// keys go through scratch, lists fall back to one Value per row.
 template <typename T>
-void CastAndDecodeOrSkip(BaseSchemaPtr schema, Buf& key_buf, Buf& value_buf,
-                         std::vector<std::any>& record, int record_index,
-                         bool is_skip, std::map<int, int>& id_offset_map) {
-  auto dingo_schema = std::dynamic_pointer_cast<DingoSchema<T>>(schema);
-  if (is_skip) {
-    if (schema->IsKey()) {
-      dingo_schema->SkipKey(key_buf);
+static inline void DecodeCell(DingoSchema<T>* schema, bool is_key,
+                              bool compact, BufView& buf, size_t row,
+                              ColumnVector& column, std::string& scratch,
+                              StringDictionary& dictionary) {
+  if constexpr (std::is_same_v<T, std::string>) {
+    std::string_view data;
+    if (is_key) {
+      if (!schema->DecodeKey(buf, scratch)) {
+        return;
+      }
+      data = scratch;
+    } else {
+      data = schema->ViewValue(buf);
     }
-  } else {
-    if (schema->IsKey()) {
-      record.at(record_index) = dingo_schema->DecodeKey(key_buf);
+    if (column.dictionary) {
+      column.codes[row] = dictionary.Add(column, data);
     } else {
-      if (value_buf.IsEnd()) {
-        record.at(record_index) = std::any();
-      } else {
-        int offset = id_offset_map[schema->GetIndex()];
-        if (offset != -1) {
-          record.at(record_index) = dingo_schema->DecodeValue(value_buf);
-        } else {
-          record.at(record_index) = std::any();
-        }
+      column.bytes.append(data);
+    }
+  } else if constexpr (std::is_arithmetic_v<T>) {
+    T data;
+    if (is_key) {
+      if (!schema->DecodeKey(buf, data)) {
+        return;
       }
+    } else {
+      DecodeValueData(schema, compact, buf, data);
     }
+    StoreCell(column, row, data);
+  } else {
+    DecodeValueAs(schema, buf, column.values[row], compact);
   }
+  column.SetNotNull(row);
 }
 
-CastAndDecodeOrSkipFuncPointer cast_and_decode_or_skip_func_ptrs[] = {
-    CastAndDecodeOrSkip<bool>,
-    CastAndDecodeOrSkip<int32_t>,
-    CastAndDecodeOrSkip<float>,
-    CastAndDecodeOrSkip<int64_t>,
-    CastAndDecodeOrSkip<double>,
-    CastAndDecodeOrSkip<std::string>,
-    CastAndDecodeOrSkip<std::vector<bool>>,
-    CastAndDecodeOrSkip<std::vector<int32_t>>,
-    CastAndDecodeOrSkip<std::vector<float>>,
-    CastAndDecodeOrSkip<std::vector<int64_t>>,
-    CastAndDecodeOrSkip<std::vector<double>>,
-    CastAndDecodeOrSkip<std::vector<std::string>>,
-};
+// Three way comparison of a column with a predicate operand.
+template <typename T>
+static inline int CompareTo(const T& data, const T& operand) {
+  return data < operand ? -1 : (operand < data ? 1 : 0);
+}
+
+static inline int CompareTo(std::string_view data, std::string_view operand) {
+  return data.compare(operand);
+}
+
+// Evaluate op on a non null column, get maps an operand to what data
+// compares to.
+template <typename D, typename O, typename Get>
+static inline bool EvaluateTerm(Predicate::Op op, const D& data,
+                                const std::vector<O>& operands, Get get) {
+  switch (op) {
+    case Predicate::kEqual:
+      return CompareTo(data, get(operands[0])) == 0;
+    case Predicate::kLess:
+      return CompareTo(data, get(operands[0])) < 0;
+    case Predicate::kLessEqual:
+      return CompareTo(data, get(operands[0])) <= 0;
+    case Predicate::kBetween:
+      return CompareTo(data, get(operands[0])) >= 0 &&
+             CompareTo(data, get(operands[1])) <= 0;
+    case Predicate::kIn:
+      for (const auto& operand : operands) {
+        if (CompareTo(data, get(operand)) == 0) {
+          return true;
+        }
+      }
+      return false;
+    default:
+      return false;
+  }
+}
+
+// Evaluate a value term on the column buf is positioned at. Fixed width
+// columns are a single load, strings are compared in place.
+template <typename T>
+static inline bool EvaluateValueTerm(DingoSchema<T>* schema,
+                                     const RecordFilter::Term& term,
+                                     bool compact, BufView& buf) {
+  if constexpr (std::is_same_v<T, std::string>) {
+    std::string_view data = schema->ViewValue(buf);
+    return EvaluateTerm(
+        term.op, data, term.values,
+        [](const Value& v) -> const std::string& { return std::get<T>(v); });
+  } else if constexpr (std::is_arithmetic_v<T>) {
+    T data;
+    DecodeValueData(schema, compact, buf, data);
+    return EvaluateTerm(term.op, data, term.values,
+                        [](const Value& v) { return std::get<T>(v); });
+  } else {
+    // List columns are rejected by CompileFilter.
+    return false;
+  }
+}
 
 RecordDecoderV2::RecordDecoderV2(int schema_version,
                                  const std::vector<BaseSchemaPtr>& schemas,
@@ -92,118 +228,119 @@ RecordDecoderV2::RecordDecoderV2(int schema_version,
   FormatSchema(schemas_, le);
   key_buf_ = Buf(kBufInitCapacity, le);
   value_buf_ = Buf(kBufInitCapacity, le);
+  plan_ = CodecPlan::Build(schemas_);
 }
 
-inline bool RecordDecoderV2::CheckPrefix(Buf& buf) const {
+inline bool RecordDecoderV2::CheckPrefix(BufView& buf) const {
   // skip name space
   buf.Skip(1);
   return buf.ReadLong() == common_id_;
 }
 
-inline bool RecordDecoderV2::CheckReverseTag(Buf& buf) const {
-  if (buf.ReadInt(buf.Size() - 4) == codec_version_) {
+// Rows of every codec version from V2 up to codec_version_ are read, they
+// differ only in the value header.
+inline bool RecordDecoderV2::CheckReverseTag(BufView& buf) const {
+  int codec_version = buf.ReadInt(buf.Size() - 4);
+  if (codec_version >= CODEC_VERSION_V2 && codec_version <= codec_version_) {
     return true;
   }
   return false;
 }
 
-inline int RecordDecoderV2::GetCodecVersion(Buf& buf) const {
+inline int RecordDecoderV2::GetCodecVersion(BufView& buf) const {
   return buf.ReadInt(buf.Size() - 4);
 }
 
-inline bool RecordDecoderV2::CheckSchemaVersion(Buf& buf) const {
+inline bool RecordDecoderV2::CheckSchemaVersion(BufView& buf) const {
   return buf.ReadInt() <= schema_version_;
 }
 
-void DecodeOrSkip(BaseSchemaPtr schema, Buf& key_buf, Buf& value_buf,
-                  std::vector<std::any>& record, int record_index, bool skip,
-                  std::map<int, int>& id_offset_map) {
-  cast_and_decode_or_skip_func_ptrs[static_cast<int>(schema->GetType())](
-      schema, key_buf, value_buf, record, record_index, skip, id_offset_map);
-}
-
-int RecordDecoderV2::Decode(const std::string& key, const std::string& value,
-                            std::vector<std::any>& record /*output*/) {
-  Buf key_buf(key, this->le_);
-  Buf value_buf(value, this->le_);
-
-  if (!CheckPrefix(key_buf) || !CheckReverseTag(key_buf) ||
-      !CheckSchemaVersion(value_buf)) {
-    return -1;
+void RecordDecoderV2::InflateValue(BufView& key_buf, BufView& value_buf,
+                                   std::optional<Inflater>& inflater,
+                                   std::string& inflated) const {
+  // schema_version(4) | units(1) | raw_size(4) | deflated
+  if (GetCodecVersion(key_buf) < CODEC_VERSION_V3 || value_buf.Size() < 9 ||
+      !IsDeflatedValue(value_buf.Read(4))) {
+    return;
   }
 
-  //int cnt_not_null_col = value_buf.ReadShort();
-  //int cnt_null_col = value_buf.ReadShort();
-  //int total_col_cnt = cnt_not_null_col + cnt_null_col;
-
-  //int ids_pos =
-  //    8;  // schema_version(4 bytes) + col_cnt (2 bytes + 2bytes) = 8 bytes.
-  //int offset_pos = 8 + 2 * total_col_cnt;
-  //int data_pos = offset_pos + 4 * total_col_cnt;
-  ValueHeader value_header(value_buf);
-
-  if (value_header.total_col_cnt != value_header.cnt_null_col) {
-    value_buf.SetReadOffset(value_header.data_pos);
+  if (!inflater.has_value()) {
+    inflater.emplace(inflater_);
   }
-
-  //std::map<int, int> col_id_offset_map;
-  //for (int i = 0; i < total_col_cnt; ++i) {
-  //  col_id_offset_map[value_buf.ReadShort(ids_pos)] =
-  //      value_buf.ReadInt(offset_pos);
-  //  ids_pos += 2;
-  //  offset_pos += 4;
-  //}
-
-  record.resize(schemas_.size());
-  for (const auto& bs : schemas_) {
-    if (bs) {
-      DecodeOrSkip(bs, key_buf, value_buf, record, bs->GetIndex(), false,
-                   value_header.col_id_offset_map);
-    }
+  size_t raw_size = static_cast<uint32_t>(value_buf.ReadInt(5));
+  inflated.assign(value_buf.Data(), 5);
+  inflated[4] &= ~VALUE_DEFLATED;
+  if (!inflater->Inflate(value_buf.Data() + 9, value_buf.Size() - 9, raw_size,
+                         inflated)) {
+    throw std::runtime_error("Deflated value does not inflate.");
   }
+  value_buf = BufView(inflated, this->le_);
+  value_buf.Skip(4);
+}
 
-  return 0;
+void RecordDecoderV2::SetValueDictionary(std::string dictionary) {
+  inflater_.SetDictionary(std::move(dictionary));
+  inflate_scratch_.inflater.reset();
+}
+
+int RecordDecoderV2::Decode(const std::string& key, const std::string& value,
+                            std::vector<std::any>& record /*output*/) {
+  return Decode(std::string_view(key), std::string_view(value), record);
 }
 
 int RecordDecoderV2::Decode(std::string&& key, std::string&& value,
                             std::vector<std::any>& record) {
-  Buf key_buf(std::move(key), this->le_);
-  Buf value_buf(std::move(value), this->le_);
+  return Decode(std::string_view(key), std::string_view(value), record);
+}
 
-  if (!CheckPrefix(key_buf) || !CheckReverseTag(key_buf) ||
-      !CheckSchemaVersion(value_buf)) {
-    return -1;
-  }
+int RecordDecoderV2::Decode(std::string_view key, std::string_view value,
+                            std::vector<std::any>& record /*output*/) {
+  return DecodeRecord(key, value, record);
+}
 
-  //int cnt_not_null_col = value_buf.ReadShort();
-  //int cnt_null_col = value_buf.ReadShort();
-  //int total_col_cnt = cnt_not_null_col + cnt_null_col;
+int RecordDecoderV2::Decode(std::string_view key, std::string_view value,
+                            std::vector<Value>& record /*output*/) {
+  return DecodeRecord(key, value, record);
+}
 
-  //int ids_pos =
-  //    8;  // schema_version(4 bytes) + col_cnt (2 bytes + 2bytes) = 8 bytes.
-  //int offset_pos = 8 + 2 * total_col_cnt;
-  //int data_pos = offset_pos + 4 * total_col_cnt;
-  ValueHeader value_header(value_buf);
+template <typename R>
+int RecordDecoderV2::DecodeRecord(std::string_view key, std::string_view value,
+                                  std::vector<R>& record) {
+  BufView key_buf(key, this->le_);
+  BufView value_buf(value, this->le_);
 
-  if (value_header.total_col_cnt != value_header.cnt_null_col) {
-    // If not means all value fields are null.
-    value_buf.SetReadOffset(value_header.data_pos);
+  if (!CheckPrefix(key_buf) || !CheckReverseTag(key_buf) ||
+      !CheckSchemaVersion(value_buf)) {
+    return -1;
   }
 
-  //std::map<int, int> col_id_offset_map;
-  //for (int i = 0; i < value_header.total_col_cnt; ++i) {
-  //  col_id_offset_map[value_buf.ReadShort(value_header.ids_pos)] =
-  //      value_buf.ReadInt(value_header.offset_pos);
-  //  value_header.ids_pos += 2;
-  //  value_header.offset_pos += 4;
-  //}
+  InflateValue(key_buf, value_buf, inflate_scratch_);
+  ValueHeader value_header(value_buf, GetCodecVersion(key_buf));
 
   record.resize(schemas_.size());
-  for (const auto& bs : schemas_) {
-    if (bs) {
-      DecodeOrSkip(bs, key_buf, value_buf, record, bs->GetIndex(), false,
-                   value_header.col_id_offset_map);
+  for (const auto& op : plan_.keys) {
+    DecodeColumn(op, key_buf, value_buf, value_header, record.at(op.index));
+  }
+  if (value_header.sparse) {
+    // Walk the listed columns instead of searching for every column.
+    for (const auto& op : plan_.values) {
+      record.at(op.index) = R();
+    }
+    for (int i = 0; i < value_header.cnt_not_null_col; ++i) {
+      int id = value_header.ColumnId(value_buf, i);
+      if (static_cast<size_t>(id) >= plan_.value_slot_by_id.size() ||
+          plan_.value_slot_by_id[id] == -1) {
+        continue;
+      }
+      const auto& op = plan_.values[plan_.value_slot_by_id[id]];
+      value_buf.SetReadOffset(value_header.ColumnOffset(value_buf, i));
+      DecodeValueColumn(op, value_buf, record.at(op.index),
+                        value_header.IsCompact(op));
     }
+    return 0;
+  }
+  for (const auto& op : plan_.values) {
+    DecodeColumn(op, key_buf, value_buf, value_header, record.at(op.index));
   }
 
   return 0;
@@ -211,22 +348,33 @@ int RecordDecoderV2::Decode(std::string&& key, std::string&& value,
 
 int RecordDecoderV2::DecodeKey(const std::string& key,
                                std::vector<std::any>& record /*output*/) {
-  Buf key_buf(key, this->le_);
+  return DecodeKey(std::string_view(key), record);
+}
+
+int RecordDecoderV2::DecodeKey(std::string_view key,
+                               std::vector<std::any>& record /*output*/) {
+  return DecodeKeyRecord(key, record);
+}
+
+int RecordDecoderV2::DecodeKey(std::string_view key,
+                               std::vector<Value>& record /*output*/) {
+  return DecodeKeyRecord(key, record);
+}
+
+template <typename R>
+int RecordDecoderV2::DecodeKeyRecord(std::string_view key,
+                                     std::vector<R>& record) {
+  BufView key_buf(key, this->le_);
 
   if (!CheckPrefix(key_buf) || !CheckReverseTag(key_buf)) {
     return -1;
   }
 
-  std::map<int, int> id_offset_map;
-  int total_col_cnt = 0;
+  ValueHeader value_header;
 
   record.resize(schemas_.size());
-  int index = 0;
-  for (const auto& bs : schemas_) {
-    if (bs && bs->IsKey()) {
-      DecodeOrSkip(bs, key_buf, key_buf, record, index, false, id_offset_map);
-    }
-    index++;
+  for (const auto& op : plan_.keys) {
+    DecodeColumn(op, key_buf, key_buf, value_header, record.at(op.position));
   }
 
   return 0;
@@ -240,36 +388,37 @@ int RecordDecoderV2::Decode(const KeyValue& key_value,
 int RecordDecoderV2::Decode(const std::string& key, const std::string& value,
                             const std::vector<int>& column_indexes,
                             std::vector<std::any>& record) {
-  Buf key_buf(key, this->le_);
-  Buf value_buf(value, this->le_);
+  return Decode(std::string_view(key), std::string_view(value), column_indexes,
+                record);
+}
 
-  if (!CheckPrefix(key_buf) || !CheckReverseTag(key_buf) ||
-      !CheckSchemaVersion(value_buf)) {
-    return -1;
-  }
+int RecordDecoderV2::Decode(std::string_view key, std::string_view value,
+                            const std::vector<int>& column_indexes,
+                            std::vector<std::any>& record) {
+  return DecodeRecord(key, value, column_indexes, record);
+}
 
-  //int cnt_not_null_col = value_buf.ReadShort();
-  //int cnt_null_col = value_buf.ReadShort();
-  //int total_col_cnt = cnt_not_null_col + cnt_null_col;
+int RecordDecoderV2::Decode(std::string_view key, std::string_view value,
+                            const std::vector<int>& column_indexes,
+                            std::vector<Value>& record) {
+  return DecodeRecord(key, value, column_indexes, record);
+}
 
-  //int ids_pos =
-  //    8;  // schema_version(4 bytes) + col_cnt (2 bytes + 2bytes) = 8 bytes.
-  //int offset_pos = 8 + 2 * total_col_cnt;
-  //int data_pos = offset_pos + 4 * total_col_cnt;
-  ValueHeader value_header(value_buf);
+template <typename R>
+int RecordDecoderV2::DecodeRecord(std::string_view key, std::string_view value,
+                                  const std::vector<int>& column_indexes,
+                                  std::vector<R>& record) {
+  BufView key_buf(key, this->le_);
+  BufView value_buf(value, this->le_);
 
-  if (value_header.total_col_cnt != value_header.cnt_null_col) {
-    value_buf.SetReadOffset(value_header.data_pos);
+  if (!CheckPrefix(key_buf) || !CheckReverseTag(key_buf) ||
+      !CheckSchemaVersion(value_buf)) {
+    return -1;
   }
 
-  //std::map<int, int> col_id_offset_map;
-  //for (int i = 0; i < value_header.total_col_cnt; ++i) {
-  //  col_id_offset_map[value_buf.ReadShort(value_header.ids_pos)] =
-  //      value_buf.ReadInt(value_header.offset_pos);
-
-  //  value_header.ids_pos += 2;
-  //  value_header.offset_pos += 4;
-  //}
+  // Requested value columns are located through the offset table on demand.
+  InflateValue(key_buf, value_buf, inflate_scratch_);
+  ValueHeader value_header(value_buf, GetCodecVersion(key_buf));
 
   uint32_t size = column_indexes.size();
   record.resize(size);
@@ -284,25 +433,37 @@ int RecordDecoderV2::Decode(const std::string& key, const std::string& value,
   // sort indexed_mapping_index
   std::sort(col_index_mapping.begin(), col_index_mapping.end());
 
-  uint32_t decode_col_count = 0;
-  for (uint32_t i = 0; i < schemas_.size(); ++i) {
-    auto& schema = schemas_[i];
-    if (schema == nullptr) {
+  // Key columns are variable length, so they are walked in order but only up
+  // to the last requested one. Value columns seek straight to their data.
+  uint32_t next_key_col = 0;
+  for (size_t i = 0; i < col_index_mapping.size(); ++i) {
+    const auto& item = col_index_mapping[i];
+    uint32_t col = item.first;
+    if (col >= plan_.columns.size() || plan_.columns[col].schema == nullptr) {
       continue;
     }
-    if (decode_col_count == size) {
-      break;
-    }
-    auto& item = col_index_mapping[decode_col_count];
+    const auto& op = plan_.columns[col];
 
-    int offset = -1;
-    if (item.first == i) {
-      offset = item.second;
-      ++decode_col_count;
+    if (op.is_key) {
+      if (next_key_col > col) {
+        // Same key requested again, it sorts right after the first one.
+        record.at(item.second) = record.at(col_index_mapping[i - 1].second);
+        continue;
+      }
+      for (; next_key_col < col; ++next_key_col) {
+        const auto& skipped = plan_.columns[next_key_col];
+        if (skipped.schema != nullptr && skipped.is_key) {
+          VisitSchema(skipped,
+                      [&](auto* schema) { return schema->SkipKey(key_buf); });
+        }
+      }
+      DecodeColumn(op, key_buf, value_buf, value_header,
+                   record.at(item.second));
+      ++next_key_col;
+    } else {
+      DecodeColumn(op, key_buf, value_buf, value_header,
+                   record.at(item.second));
     }
-
-    DecodeOrSkip(schema, key_buf, value_buf, record, offset, offset == -1,
-                 value_header.col_id_offset_map);
   }
 
   return 0;
@@ -315,5 +476,403 @@ int RecordDecoderV2::Decode(const KeyValue& key_value,
                 record);
 }
 
+
+int RecordDecoderV2::DecodeBatch(const std::vector<KeyValue>& key_values,
+                                 const std::vector<int>& column_indexes,
+                                 std::vector<ColumnVector>& columns) {
+  size_t rows = key_values.size();
+  uint32_t size = column_indexes.size();
+
+  // (column, output) pairs of the valid projected columns in column order,
+  // so each key is walked once per row. Unknown columns stay all null.
+  std::vector<std::pair<uint32_t, uint32_t>> col_index_mapping;
+  col_index_mapping.reserve(size);
+  columns.resize(size);
+  for (uint32_t i = 0; i < size; ++i) {
+    uint32_t col = column_indexes[i];
+    if (col >= plan_.columns.size() || plan_.columns[col].schema == nullptr) {
+      columns[i].Reset(BaseSchema::kBool, rows);
+      continue;
+    }
+    columns[i].Reset(plan_.columns[col].type, rows, dictionary_batch_);
+    col_index_mapping.push_back(std::make_pair(col, i));
+  }
+  std::sort(col_index_mapping.begin(), col_index_mapping.end());
+
+  std::string scratch;
+  std::vector<StringDictionary> dictionaries(dictionary_batch_ ? size : 0);
+  StringDictionary unused;
+  for (size_t row = 0; row < rows; ++row) {
+    BufView key_buf(key_values[row].GetKey(), this->le_);
+    BufView value_buf(key_values[row].GetValue(), this->le_);
+
+    if (!CheckPrefix(key_buf) || !CheckReverseTag(key_buf) ||
+        !CheckSchemaVersion(value_buf)) {
+      return -1;
+    }
+
+    InflateValue(key_buf, value_buf, inflate_scratch_);
+    ValueHeader value_header(value_buf, GetCodecVersion(key_buf));
+
+    uint32_t next_key_col = 0;
+    size_t last_key_offset = 0;
+    for (const auto& item : col_index_mapping) {
+      uint32_t col = item.first;
+      const auto& op = plan_.columns[col];
+      auto& column = columns[item.second];
+      auto& dictionary =
+          column.dictionary ? dictionaries[item.second] : unused;
+
+      if (op.is_key) {
+        if (next_key_col > col) {
+          // Same key requested again, decode it from where it started.
+          key_buf.SetReadOffset(last_key_offset);
+        } else {
+          for (; next_key_col < col; ++next_key_col) {
+            const auto& skipped = plan_.columns[next_key_col];
+            if (skipped.schema != nullptr && skipped.is_key) {
+              VisitSchema(skipped, [&](auto* schema) {
+                return schema->SkipKey(key_buf);
+              });
+            }
+          }
+          last_key_offset = key_buf.ReadOffset();
+          ++next_key_col;
+        }
+        VisitSchema(op, [&](auto* schema) {
+          DecodeCell(schema, true, false, key_buf, row, column, scratch,
+                     dictionary);
+        });
+      } else {
+        int offset = value_header.FindOffset(value_buf, op);
+        if (offset != -1) {
+          value_buf.SetReadOffset(offset);
+          VisitSchema(op, [&](auto* schema) {
+            DecodeCell(schema, false, value_header.IsCompact(op), value_buf,
+                       row, column, scratch, dictionary);
+          });
+        }
+      }
+
+      if (op.type == BaseSchema::kString && !column.dictionary) {
+        column.offsets[row + 1] = column.bytes.size();
+      }
+    }
+  }
+
+  return 0;
+}
+
+
+int RecordDecoderV2::View(std::string_view key, std::string_view value,
+                          RecordView& view) const {
+  BufView key_buf(key, this->le_);
+  BufView value_buf(value, this->le_);
+
+  if (!CheckPrefix(key_buf) || !CheckReverseTag(key_buf) ||
+      !CheckSchemaVersion(value_buf)) {
+    return -1;
+  }
+
+  std::optional<Inflater> inflater;
+  InflateValue(key_buf, value_buf, inflater, view.inflated_value_);
+  view.Reset(&plan_, this->le_, key,
+             std::string_view(value_buf.Data(), value_buf.Size()),
+             key_buf.ReadOffset(),
+             ValueHeader(value_buf, GetCodecVersion(key_buf)));
+  return 0;
+}
+
+RecordFilter RecordDecoderV2::CompileFilter(
+    const std::vector<Predicate>& predicates) const {
+  RecordFilter filter;
+  for (const auto& predicate : predicates) {
+    if (predicate.column < 0 ||
+        static_cast<size_t>(predicate.column) >= plan_.columns.size() ||
+        plan_.columns[predicate.column].schema == nullptr) {
+      throw std::runtime_error("Predicate column not found.");
+    }
+    const auto& op = plan_.columns[predicate.column];
+    if (op.type >= BaseSchema::kBoolList) {
+      throw std::runtime_error("Predicate on list column is unsupported.");
+    }
+
+    size_t count = predicate.operands.size();
+    bool count_ok;
+    switch (predicate.op) {
+      case Predicate::kIsNull:
+        count_ok = count == 0;
+        break;
+      case Predicate::kBetween:
+        count_ok = count == 2;
+        break;
+      case Predicate::kIn:
+        count_ok = true;
+        break;
+      default:
+        count_ok = count == 1;
+        break;
+    }
+    if (!count_ok) {
+      throw std::runtime_error("Predicate operand count mismatch.");
+    }
+    for (const auto& operand : predicate.operands) {
+      if (IsNull(operand)) {
+        throw std::runtime_error("Predicate operand is null.");
+      }
+      if (GetValueType(operand) != op.type) {
+        throw std::runtime_error("Value type mismatch.");
+      }
+    }
+
+    RecordFilter::Term term;
+    term.column = op;
+    term.op = predicate.op;
+    if (op.is_key) {
+      auto encode = [&](const Value& operand) {
+        Buf buf(0, le_);
+        EncodeKeyColumn(op, operand, buf);
+        std::string key;
+        buf.GetString(key);
+        return key;
+      };
+      if (op.nullable) {
+        term.null_key = encode(Value());
+      }
+      for (const auto& operand : predicate.operands) {
+        term.keys.push_back(encode(operand));
+      }
+      filter.key_terms.push_back(std::move(term));
+    } else {
+      term.values = predicate.operands;
+      filter.value_terms.push_back(std::move(term));
+    }
+  }
+
+  std::stable_sort(filter.key_terms.begin(), filter.key_terms.end(),
+                   [](const auto& a, const auto& b) {
+                     return a.column.position < b.column.position;
+                   });
+  return filter;
+}
+
+int RecordDecoderV2::Match(std::string_view key, std::string_view value,
+                           const RecordFilter& filter) {
+  BufView key_buf(key, this->le_);
+  BufView value_buf(value, this->le_);
+
+  if (!CheckPrefix(key_buf) || !CheckReverseTag(key_buf) ||
+      !CheckSchemaVersion(value_buf)) {
+    return -1;
+  }
+
+  // Key columns are memcmp comparable, so the encoded bytes of each column
+  // compare directly to the encoded operands.
+  int next_key_col = 0;
+  std::string_view column;
+  for (const auto& term : filter.key_terms) {
+    const auto& op = term.column;
+    if (op.position >= next_key_col) {
+      for (; next_key_col < op.position; ++next_key_col) {
+        const auto& skipped = plan_.columns[next_key_col];
+        if (skipped.schema != nullptr && skipped.is_key) {
+          VisitSchema(skipped,
+                      [&](auto* schema) { return schema->SkipKey(key_buf); });
+        }
+      }
+      size_t start = key_buf.ReadOffset();
+      VisitSchema(op, [&](auto* schema) { return schema->SkipKey(key_buf); });
+      column = key.substr(start, key_buf.ReadOffset() - start);
+      ++next_key_col;
+    }
+
+    bool pass;
+    if (op.nullable && column == term.null_key) {
+      pass = term.op == Predicate::kIsNull;
+    } else {
+      pass = EvaluateTerm(
+          term.op, column, term.keys,
+          [](const std::string& s) { return std::string_view(s); });
+    }
+    if (!pass) {
+      return 0;
+    }
+  }
+
+  if (filter.value_terms.empty()) {
+    return 1;
+  }
+
+  InflateValue(key_buf, value_buf, inflate_scratch_);
+  ValueHeader value_header(value_buf, GetCodecVersion(key_buf));
+  for (const auto& term : filter.value_terms) {
+    const auto& op = term.column;
+    int offset = value_header.FindOffset(value_buf, op);
+    if (term.op == Predicate::kIsNull) {
+      if (offset != -1) {
+        return 0;
+      }
+      continue;
+    }
+    if (offset == -1) {
+      return 0;
+    }
+
+    value_buf.SetReadOffset(offset);
+    if (!VisitSchema(op, [&](auto* schema) {
+          return EvaluateValueTerm(schema, term, value_header.IsCompact(op),
+                                   value_buf);
+        })) {
+      return 0;
+    }
+  }
+
+  return 1;
+}
+
+int RecordDecoderV2::DecodeFiltered(
+    const std::vector<KeyValue>& key_values, const RecordFilter& filter,
+    const std::vector<int>& column_indexes,
+    std::vector<std::vector<std::any>>& records) {
+  return DecodeFilteredRecords(key_values, filter, column_indexes, records);
+}
+
+int RecordDecoderV2::DecodeFiltered(const std::vector<KeyValue>& key_values,
+                                    const RecordFilter& filter,
+                                    const std::vector<int>& column_indexes,
+                                    std::vector<std::vector<Value>>& records) {
+  return DecodeFilteredRecords(key_values, filter, column_indexes, records);
+}
+
+template <typename R>
+int RecordDecoderV2::DecodeFilteredRecords(
+    const std::vector<KeyValue>& key_values, const RecordFilter& filter,
+    const std::vector<int>& column_indexes,
+    std::vector<std::vector<R>>& records) {
+  size_t count = 0;
+  for (const auto& key_value : key_values) {
+    int ret = Match(key_value.GetKey(), key_value.GetValue(), filter);
+    if (ret == -1) {
+      return -1;
+    }
+    if (ret == 0) {
+      continue;
+    }
+
+    if (count == records.size()) {
+      records.emplace_back();
+    }
+    DecodeRecord(key_value.GetKey(), key_value.GetValue(), column_indexes,
+                 records[count++]);
+  }
+  records.resize(count);
+
+  return 0;
+}
+
+
+int RecordDecoderV2::Aggregate(const std::vector<KeyValue>& key_values,
+                               int column, AggregateResult& result) {
+  if (column < 0 || static_cast<size_t>(column) >= plan_.columns.size() ||
+      plan_.columns[column].schema == nullptr) {
+    throw std::runtime_error("Aggregate column not found.");
+  }
+  const auto& op = plan_.columns[column];
+  switch (op.type) {
+    case BaseSchema::kInteger:
+      return AggregateColumn(static_cast<DingoSchema<int32_t>*>(op.schema), op,
+                             key_values, result);
+    case BaseSchema::kLong:
+      return AggregateColumn(static_cast<DingoSchema<int64_t>*>(op.schema), op,
+                             key_values, result);
+    case BaseSchema::kFloat:
+      return AggregateColumn(static_cast<DingoSchema<float>*>(op.schema), op,
+                             key_values, result);
+    case BaseSchema::kDouble:
+      return AggregateColumn(static_cast<DingoSchema<double>*>(op.schema), op,
+                             key_values, result);
+    default:
+      throw std::runtime_error("Aggregate column must be numeric.");
+  }
+}
+
+template <typename T>
+int RecordDecoderV2::AggregateColumn(DingoSchema<T>* schema,
+                                     const CodecOp& op,
+                                     const std::vector<KeyValue>& key_values,
+                                     AggregateResult& result) {
+  using Sum = std::conditional_t<std::is_integral_v<T>, uint64_t, double>;
+
+  // Accumulate in locals of the column type, result is merged once.
+  int64_t rows = 0;
+  int64_t count = 0;
+  Sum sum = 0;
+  T min{};
+  T max{};
+
+  for (const auto& key_value : key_values) {
+    BufView key_buf(key_value.GetKey(), this->le_);
+    BufView value_buf(key_value.GetValue(), this->le_);
+
+    if (!CheckPrefix(key_buf) || !CheckReverseTag(key_buf) ||
+        !CheckSchemaVersion(value_buf)) {
+      return -1;
+    }
+    ++rows;
+
+    T data;
+    if (op.is_key) {
+      for (int col = 0; col < op.position; ++col) {
+        const auto& skipped = plan_.columns[col];
+        if (skipped.schema != nullptr && skipped.is_key) {
+          VisitSchema(skipped,
+                      [&](auto* schema) { return schema->SkipKey(key_buf); });
+        }
+      }
+      if (!schema->DecodeKey(key_buf, data)) {
+        continue;
+      }
+    } else {
+      InflateValue(key_buf, value_buf, inflate_scratch_);
+      ValueHeader value_header(value_buf, GetCodecVersion(key_buf));
+      int offset = value_header.FindOffset(value_buf, op);
+      if (offset == -1) {
+        continue;
+      }
+      value_buf.SetReadOffset(offset);
+      DecodeValueData(schema, value_header.IsCompact(op), value_buf, data);
+    }
+
+    if (count == 0 || data < min) {
+      min = data;
+    }
+    if (count == 0 || max < data) {
+      max = data;
+    }
+    sum += static_cast<Sum>(data);
+    ++count;
+  }
+
+  result.rows += rows;
+  if (count == 0) {
+    return 0;
+  }
+  result.count += count;
+  if constexpr (std::is_integral_v<T>) {
+    result.long_sum = static_cast<int64_t>(
+        static_cast<uint64_t>(result.long_sum) + sum);
+  } else {
+    result.double_sum += sum;
+  }
+  if (IsNull(result.min) || min < std::get<T>(result.min)) {
+    result.min = min;
+  }
+  if (IsNull(result.max) || std::get<T>(result.max) < max) {
+    result.max = max;
+  }
+
+  return 0;
+}
+
 }  // namespace serialV2
 }  // namespace dingodb
@@ -17,9 +17,17 @@
 
 #include <map>
 #include <memory>
+#include <string>
+#include <string_view>
 
+#include "aggregate.h"
 #include "any"
+#include "codec_plan.h"
+#include "column_vector.h"
 #include "common.h"
+#include "record_filter.h"
+#include "record_view.h"
+#include "value.h"
 
 #include "functional"  // IWYU pragma: keep
 #include "optional"    // IWYU pragma: keep
@@ -35,6 +43,7 @@
 #include "serial/schema/V2/long_schema.h"  // IWYU pragma: keep
 #include "serial/schema/V2/string_list_schema.h" // IWYU pragma: keep
 #include "serial/schema/V2/string_schema.h"  // IWYU pragma: keep
+#include "serial/utils/V2/deflate.h"
 #include "serial/utils/V2/keyvalue.h"        // IWYU pragma: keep
 #include "serial/utils/V2/utils.h" // IWYU pragma: keep
 #include "serial/utils/V2/utils.h"  // IWYU pragma: keep
@@ -69,29 +78,146 @@ class RecordDecoderV2 {
              std::vector<std::any>& record /*output*/);
   int Decode(std::string&& key, std::string&& value,
              std::vector<std::any>& record /*output*/);
+  // Decode straight from borrowed bytes, e.g. a storage engine slice, without
+  // copying them.
+  int Decode(std::string_view key, std::string_view value,
+             std::vector<std::any>& record /*output*/);
   int DecodeKey(const std::string& key,
                 std::vector<std::any>& record /*output*/);
+  int DecodeKey(std::string_view key, std::vector<std::any>& record /*output*/);
 
   int Decode(const KeyValue& key_value, const std::vector<int>& column_indexes,
              std::vector<std::any>& record /*output*/);
   int Decode(const std::string& key, const std::string& value,
              const std::vector<int>& column_indexes,
              std::vector<std::any>& record /*output*/);
-  int GetCodecVersion(Buf& buf) const;
+  int Decode(std::string_view key, std::string_view value,
+             const std::vector<int>& column_indexes,
+             std::vector<std::any>& record /*output*/);
+
+  // Decode into typed Value records. Strings and lists already held by the
+  // record are reused, so decoding many rows into one record keeps their
+  // storage.
+  int Decode(std::string_view key, std::string_view value,
+             std::vector<Value>& record /*output*/);
+  int DecodeKey(std::string_view key, std::vector<Value>& record /*output*/);
+  int Decode(std::string_view key, std::string_view value,
+             const std::vector<int>& column_indexes,
+             std::vector<Value>& record /*output*/);
+
+  // Decode the column_indexes columns of many rows into column vectors,
+  // columns[i] receives column column_indexes[i] of every row. No per cell
+  // std::any or Value is built for scalar and string columns, and reusing
+  // columns across batches reuses their buffers. Returns -1 if any row does
+  // not belong to this decoder.
+  int DecodeBatch(const std::vector<KeyValue>& key_values,
+                  const std::vector<int>& column_indexes,
+                  std::vector<ColumnVector>& columns /*output*/);
+  // Decode string columns of DecodeBatch as dictionary columns, which store
+  // each distinct string of the batch once and give every row its code, see
+  // ColumnVector. Meant for low cardinality columns such as a status.
+  void SetDictionaryBatch(bool dictionary) { dictionary_batch_ = dictionary; }
+  bool IsDictionaryBatch() const { return dictionary_batch_; }
+
+  // Validate the row and point view at it, its columns are then decoded on
+  // demand. key, value and this decoder must outlive the view. A deflated
+  // value is inflated into the view itself.
+  int View(std::string_view key, std::string_view value,
+           RecordView& view /*output*/) const;
+
+  // Compile predicates for Match and DecodeFiltered. Throws
+  // std::runtime_error for unknown or list columns and for operands that are
+  // null, miscounted or not of the column type.
+  RecordFilter CompileFilter(const std::vector<Predicate>& predicates) const;
+  // 1 if the row passes filter, 0 if not, -1 if it does not belong to this
+  // decoder. Key columns are compared on their encoded bytes and fixed width
+  // value columns are loaded straight from the offset table, no column is
+  // decoded into a record.
+  int Match(std::string_view key, std::string_view value,
+            const RecordFilter& filter);
+  // Decode the column_indexes columns of the rows passing filter, records
+  // receives one record per passing row in input order.
+  int DecodeFiltered(const std::vector<KeyValue>& key_values,
+                     const RecordFilter& filter,
+                     const std::vector<int>& column_indexes,
+                     std::vector<std::vector<std::any>>& records /*output*/);
+  int DecodeFiltered(const std::vector<KeyValue>& key_values,
+                     const RecordFilter& filter,
+                     const std::vector<int>& column_indexes,
+                     std::vector<std::vector<Value>>& records /*output*/);
+
+  // Add COUNT, SUM, MIN and MAX of the integer, long, float or double column
+  // at position column over key_values to result. Values are read in place
+  // through the offset table, no record is built. Returns -1 if a row does
+  // not belong to this decoder, throws std::runtime_error for other columns.
+  int Aggregate(const std::vector<KeyValue>& key_values, int column,
+                AggregateResult& result /*output*/);
+
+  // Preset dictionary of the encoder that deflated the values, see
+  // RecordEncoderV2::SetValueDictionary.
+  void SetValueDictionary(std::string dictionary);
+
+  int GetCodecVersion(BufView& buf) const;
 
  private:
-  bool CheckPrefix(Buf& buf) const;
-  bool CheckReverseTag(Buf& buf) const;
-  bool CheckSchemaVersion(Buf& buf) const;
+  template <typename R>
+  int DecodeRecord(std::string_view key, std::string_view value,
+                   std::vector<R>& record);
+  template <typename R>
+  int DecodeKeyRecord(std::string_view key, std::vector<R>& record);
+  // Where deflated values are inflated, the stream is set up by the first
+  // deflated value and reused by the ones after it.
+  struct InflateScratch {
+    std::optional<Inflater> inflater;
+    std::string value;
+  };
+
+  template <typename R>
+  int DecodeRecord(std::string_view key, std::string_view value,
+                   const std::vector<int>& column_indexes,
+                   std::vector<R>& record);
+  template <typename R>
+  int DecodeFilteredRecords(const std::vector<KeyValue>& key_values,
+                            const RecordFilter& filter,
+                            const std::vector<int>& column_indexes,
+                            std::vector<std::vector<R>>& records);
+
+  template <typename T>
+  int AggregateColumn(DingoSchema<T>* schema, const CodecOp& op,
+                      const std::vector<KeyValue>& key_values,
+                      AggregateResult& result);
+
+  bool CheckPrefix(BufView& buf) const;
+  bool CheckReverseTag(BufView& buf) const;
+  bool CheckSchemaVersion(BufView& buf) const;
+  // Point value_buf, read past the schema version, at the copy of a
+  // deflated value inflated into inflated, a copy of inflater_ set up in
+  // inflater on first use. Throws std::runtime_error when it does not
+  // inflate.
+  void InflateValue(BufView& key_buf, BufView& value_buf,
+                    std::optional<Inflater>& inflater,
+                    std::string& inflated) const;
+  void InflateValue(BufView& key_buf, BufView& value_buf,
+                    InflateScratch& scratch) const {
+    InflateValue(key_buf, value_buf, scratch.inflater, scratch.value);
+  }
 
   bool le_;
   Buf key_buf_;
   Buf value_buf_;
-  int codec_version_{CODEC_VERSION_V2};
+  // Newest codec version this decoder reads.
+  int codec_version_{CODEC_VERSION_V3};
   int schema_version_;
   long common_id_;
 
   std::vector<BaseSchemaPtr> schemas_;
+  // schemas_ compiled at construction, the decode loops run over it.
+  CodecPlan plan_;
+  bool dictionary_batch_{false};
+  // Dictionary deflated values are inflated with. The non const calls
+  // inflate through inflate_scratch_, View through its own copy.
+  Inflater inflater_;
+  InflateScratch inflate_scratch_;
 };
 
 }  // namespace serialV2
@@ -15,9 +15,13 @@
 
 #include <sys/types.h>
 
+#include <algorithm>
 #include <cstdint>
 #include <memory>
+#include <stdexcept>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "common.h"
 
@@ -27,9 +31,6 @@
 namespace dingodb {
 namespace serialV2 {
 
-// The worker buffer capacity.
-constexpr int kBufInitCapacity = 2048;
-
 RecordEncoderV2::RecordEncoderV2(int schema_version,
                                  const std::vector<BaseSchemaPtr>& schemas,
                                  long common_id)
@@ -43,6 +44,211 @@ RecordEncoderV2::RecordEncoderV2(int schema_version,
       common_id_(common_id),
       schemas_(schemas) {
   FormatSchema(schemas_, le);
+  plan_ = CodecPlan::Build(schemas_);
+  plan_.SetCompactValues(false);
+  plan_.SetDeltaLists(false);
+  BuildValueHeaders();
+}
+
+void RecordEncoderV2::SetCodecVersion(int codec_version) {
+  if (codec_version != CODEC_VERSION_V2 && codec_version != CODEC_VERSION_V3) {
+    throw std::runtime_error("Unsupported codec version.");
+  }
+  codec_version_ = codec_version;
+  if (codec_version_ < CODEC_VERSION_V3) {
+    dense_value_ = false;
+    fixed_block_value_ = false;
+    packed_bool_list_ = false;
+    plan_.SetPackedBoolLists(false);
+    deflate_threshold_ = 0;
+  }
+  plan_.SetCompactValues(codec_version_ >= CODEC_VERSION_V3);
+  plan_.SetDeltaLists(codec_version_ >= CODEC_VERSION_V3);
+  BuildValueHeaders();
+}
+
+void RecordEncoderV2::SetDenseValue(bool dense) {
+  if (dense && codec_version_ < CODEC_VERSION_V3) {
+    throw std::runtime_error("Dense values need codec version V3.");
+  }
+  dense_value_ = dense;
+  BuildValueHeaders();
+}
+
+void RecordEncoderV2::SetFixedBlockValue(bool fixed_block) {
+  if (fixed_block && codec_version_ < CODEC_VERSION_V3) {
+    throw std::runtime_error("Fixed block values need codec version V3.");
+  }
+  if (fixed_block && plan_.fixed_block_size > 0xFFFF) {
+    throw std::runtime_error("Fixed block exceeds 64KB.");
+  }
+  fixed_block_value_ = fixed_block;
+  BuildValueHeaders();
+}
+
+void RecordEncoderV2::SetPackedBoolList(bool packed) {
+  if (packed && codec_version_ < CODEC_VERSION_V3) {
+    throw std::runtime_error("Packed bool lists need codec version V3.");
+  }
+  packed_bool_list_ = packed;
+  plan_.SetPackedBoolLists(packed);
+  BuildValueHeaders();
+}
+
+void RecordEncoderV2::SetDeflateValue(size_t threshold) {
+  if (threshold > 0 && codec_version_ < CODEC_VERSION_V3) {
+    throw std::runtime_error("Deflated values need codec version V3.");
+  }
+  deflate_threshold_ = threshold;
+}
+
+void RecordEncoderV2::SetValueDictionary(std::string dictionary) {
+  deflater_.SetDictionary(std::move(dictionary));
+}
+
+void RecordEncoderV2::BuildValueHeaders() {
+  int max_index = -1;
+  for (const auto& op : plan_.values) {
+    max_index = std::max(max_index, op.index);
+  }
+
+  id_unit_ = ID_2_BYTE;
+  if (dense_value_ || fixed_block_value_) {
+    id_unit_ = ID_IMPLIED;
+  } else if (codec_version_ >= CODEC_VERSION_V3 && max_index < 255) {
+    id_unit_ = CalcIdUnit(plan_.values.size(), 0);
+  }
+
+  compact_value_ = plan_.HasCompactValues();
+
+  sparse_values_ = plan_.values;
+  std::sort(
+      sparse_values_.begin(), sparse_values_.end(),
+      [](const CodecOp& a, const CodecOp& b) { return a.index < b.index; });
+  sparse_id_unit_ = max_index < 255 ? ID_1_BYTE : ID_2_BYTE;
+
+  value_header_ = BuildValueHeader(OFFSET_4_BYTE);
+  short_value_header_.clear();
+  if (codec_version_ >= CODEC_VERSION_V3) {
+    short_value_header_ = BuildValueHeader(OFFSET_2_BYTE);
+  }
+}
+
+std::string RecordEncoderV2::BuildValueHeader(int offset_unit) const {
+  // schema_version | [units] | cnt_not_null | cnt_null | ids | offsets, only
+  // the counts and offsets change from row to row. Dense values end with the
+  // null bitmap, fixed block values with the size of the fixed block.
+  Buf buf(0, le_);
+  EncodeSchemaVersion(buf);
+  if (codec_version_ >= CODEC_VERSION_V3) {
+    buf.Write(MakeValueUnits(id_unit_, offset_unit) |
+              (fixed_block_value_ ? VALUE_FIXED_BLOCK : 0) |
+              (compact_value_ ? VALUE_COMPACT : 0));
+  }
+  buf.WriteShort(0);
+  buf.WriteShort(0);
+  if (id_unit_ == ID_IMPLIED) {
+    for (int i = 0; i < NullBitmapSize(plan_.values.size()); ++i) {
+      buf.Write(0);
+    }
+    if (fixed_block_value_) {
+      buf.WriteShort(plan_.fixed_block_size);
+    }
+
+    std::string header;
+    buf.GetString(header);
+    return header;
+  }
+  for (const auto& op : plan_.values) {
+    if (id_unit_ == ID_1_BYTE) {
+      buf.Write(op.index);
+    } else {
+      buf.WriteShort(op.index);
+    }
+  }
+  for (size_t i = 0; i < plan_.values.size(); ++i) {
+    if (offset_unit == OFFSET_2_BYTE) {
+      buf.WriteShort(0);
+    } else {
+      buf.WriteInt(0);
+    }
+  }
+
+  std::string header;
+  buf.GetString(header);
+  return header;
+}
+
+int RecordEncoderV2::ValueOffsetUnit(size_t data_size,
+                                     int cnt_not_null) const {
+  // 2 byte offsets as long as every offset stays below the 0xFFFF null
+  // marker.
+  if (codec_version_ >= CODEC_VERSION_V3 &&
+      ValueHeaderSize(OFFSET_2_BYTE, cnt_not_null) + data_size < 0xFFFF) {
+    return OFFSET_2_BYTE;
+  }
+  return OFFSET_4_BYTE;
+}
+
+const std::string& RecordEncoderV2::ValueHeaderTemplate(int offset_unit) const {
+  return offset_unit == OFFSET_2_BYTE ? short_value_header_ : value_header_;
+}
+
+void RecordEncoderV2::DeflateValue(size_t base, Buf& buf) {
+  // schema_version(4) | units(1) stay, raw_size(4) | deflated(rest) follow.
+  size_t size = buf.Size() - base;
+  if (deflate_threshold_ == 0 || size < deflate_threshold_ || size <= 4 + 5) {
+    return;
+  }
+  size_t raw_size = size - 5;
+  deflate_scratch_.clear();
+  if (!deflater_.Deflate(buf.Data() + base + 5, raw_size, raw_size - 5,
+                         deflate_scratch_)) {
+    return;
+  }
+
+  uint8_t units = buf.Read(base + 4);
+  buf.ReSize(base + 5);
+  buf.WriteByte(base + 4, units | VALUE_DEFLATED);
+  buf.WriteInt(raw_size);
+  buf.WriteString(deflate_scratch_);
+}
+
+bool RecordEncoderV2::UseSparseValue(int cnt_not_null) const {
+  if (codec_version_ < CODEC_VERSION_V3 || fixed_block_value_) {
+    return false;
+  }
+  // Table bytes with 2 byte offsets, sparse must save more than half.
+  int col_cnt = plan_.values.size();
+  int sparse_size = cnt_not_null * (sparse_id_unit_ + OFFSET_2_BYTE);
+  int size = dense_value_
+                 ? NullBitmapSize(col_cnt) + cnt_not_null * OFFSET_2_BYTE
+                 : col_cnt * (id_unit_ + OFFSET_2_BYTE);
+  return 2 * sparse_size < size;
+}
+
+size_t RecordEncoderV2::ValueHeaderSize(int offset_unit,
+                                        int cnt_not_null) const {
+  if (UseSparseValue(cnt_not_null)) {
+    // schema_version | units | cnt_not_null | cnt_null | ids | offsets
+    return 4 + 1 + 4 + cnt_not_null * (sparse_id_unit_ + offset_unit);
+  }
+  size_t size = ValueHeaderTemplate(offset_unit).size();
+  if (fixed_block_value_) {
+    size += plan_.fixed_block_size + offset_unit * plan_.var_values.size();
+  } else if (dense_value_) {
+    size += offset_unit * cnt_not_null;
+  }
+  return size;
+}
+
+std::string RecordEncoderV2::KeyPrefix(char prefix) const {
+  Buf buf(0, le_);
+  EncodePrefix(buf, prefix);
+
+  std::string output;
+  buf.GetString(output);
+  return output;
 }
 
 inline void RecordEncoderV2::EncodePrefix(Buf& buf, char prefix) const {
@@ -60,100 +266,409 @@ inline void RecordEncoderV2::EncodeSchemaVersion(Buf& buf) const {
 
 int RecordEncoderV2::Encode(char prefix, const std::vector<std::any>& record,
                             std::string& key, std::string& value) {
-  int ret = EncodeKey(prefix, record, key);
+  return EncodeRecord(prefix, record, key, value);
+}
+
+int RecordEncoderV2::Encode(char prefix, const std::vector<Value>& record,
+                            std::string& key, std::string& value) {
+  return EncodeRecord(prefix, record, key, value);
+}
+
+int RecordEncoderV2::EncodeKey(char prefix, const std::vector<std::any>& record,
+                               std::string& output) {
+  return EncodeKeyRecord(prefix, record, output);
+}
+
+int RecordEncoderV2::EncodeKey(char prefix, const std::vector<Value>& record,
+                               std::string& output) {
+  return EncodeKeyRecord(prefix, record, output);
+}
+
+int RecordEncoderV2::EncodeValue(const std::vector<std::any>& record,
+                                 std::string& output) {
+  return EncodeValueRecord(record, output);
+}
+
+int RecordEncoderV2::EncodeValue(const std::vector<Value>& record,
+                                 std::string& output) {
+  return EncodeValueRecord(record, output);
+}
+
+int RecordEncoderV2::ComputeEncodedSize(const std::vector<std::any>& record,
+                                        size_t& key_size, size_t& value_size) {
+  key_size = ComputeKeySize(record);
+  value_size = ComputeValueSize(record);
+  return 0;
+}
+
+int RecordEncoderV2::ComputeEncodedSize(const std::vector<Value>& record,
+                                        size_t& key_size, size_t& value_size) {
+  key_size = ComputeKeySize(record);
+  value_size = ComputeValueSize(record);
+  return 0;
+}
+
+template <typename R>
+size_t RecordEncoderV2::ComputeKeySize(const std::vector<R>& record) const {
+  // prefix(1) | common_id(8) | key columns | codec_version(4)
+  size_t size = 1 + 8 + 4;
+  for (const auto& op : plan_.keys) {
+    size += GetEncodedKeyColumnSize(op, record.at(op.position));
+  }
+
+  return size;
+}
+
+template <typename R>
+size_t RecordEncoderV2::ComputeValueSize(const std::vector<R>& record) const {
+  // value header | data
+  int cnt_not_null;
+  size_t data_size = ComputeValueDataSize(record, cnt_not_null);
+  return ValueHeaderSize(ValueOffsetUnit(data_size, cnt_not_null),
+                         cnt_not_null) +
+         data_size;
+}
+
+template <typename R>
+size_t RecordEncoderV2::ComputeValueDataSize(const std::vector<R>& record,
+                                             int& cnt_not_null) const {
+  size_t size = 0;
+  cnt_not_null = 0;
+  for (const auto& op : plan_.values) {
+    const auto& column = record.at(op.index);
+    if (!IsNull(column)) {
+      if (!fixed_block_value_ || op.fixed_offset == -1) {
+        size += GetEncodedValueColumnSize(op, column);
+      }
+      ++cnt_not_null;
+    }
+  }
+
+  return size;
+}
+
+template <typename R>
+int RecordEncoderV2::EncodeRecord(char prefix, const std::vector<R>& record,
+                                  std::string& key, std::string& value) {
+  int ret = EncodeKeyRecord(prefix, record, key);
   if (ret < 0) {
     return ret;
   }
-  ret = EncodeValue(record, value);
+  ret = EncodeValueRecord(record, value);
   if (ret < 0) {
     return ret;
   }
   return 0;
 }
 
-int RecordEncoderV2::EncodeKey(char prefix, const std::vector<std::any>& record,
-                               std::string& output) {
-  Buf buf(kBufInitCapacity, this->le_);
+template <typename R>
+int RecordEncoderV2::EncodeKeyRecord(char prefix, const std::vector<R>& record,
+                                     std::string& output) {
+  // Write into the storage of output, grown at most once to the exact size.
+  Buf buf(0, this->le_);
+  buf.Adopt(output);
+  buf.Reserve(ComputeKeySize(record));
 
-  // namespace | common_id | ... | codecVersion
-  EncodePrefix(buf, prefix);
+  AppendKey(KeyPrefix(prefix), record, buf);
 
-  // loop meta schemas.
-  for (int i = 0; i < schemas_.size(); ++i) {
-    const auto& schema = schemas_.at(i);
-
-    if (schema->IsKey()) {
-      const auto& column = record.at(i);
-      schema->EncodeKey(column, buf);
-    }
-  }
+  buf.GetString(output);
+  return output.size();
+}
 
-  EncodeCodecVersion(buf);
+template <typename R>
+int RecordEncoderV2::EncodeValueRecord(const std::vector<R>& record,
+                                       std::string& output) {
+  // Write into the storage of output, grown at most once to the exact size.
+  int cnt_not_null;
+  size_t data_size = ComputeValueDataSize(record, cnt_not_null);
+  Buf buf(0, this->le_);
+  buf.Adopt(output);
+  buf.Reserve(ValueHeaderSize(ValueOffsetUnit(data_size, cnt_not_null),
+                              cnt_not_null) +
+              data_size);
+
+  AppendValue(record, data_size, cnt_not_null, buf);
+  DeflateValue(0, buf);
 
   buf.GetString(output);
   return output.size();
 }
 
-int RecordEncoderV2::EncodeValue(const std::vector<std::any>& record,
-                                 std::string& output) {
-  Buf buf(kBufInitCapacity, this->le_);
+template <typename R>
+void RecordEncoderV2::AppendKey(const std::string& key_prefix,
+                                const std::vector<R>& record, Buf& buf) {
+  // namespace | common_id | ... | codecVersion
+  buf.WriteString(key_prefix);
 
-  // get total value size.
-  int col_cnt = 0;
-  for (const auto& schema : schemas_) {
-    col_cnt += (schema->IsKey() ? 0 : 1);
+  // loop key columns.
+  for (const auto& op : plan_.keys) {
+    const auto& column = record.at(op.position);
+    EncodeKeyColumn(op, column, buf);
   }
 
-  EncodeSchemaVersion(buf);
+  EncodeCodecVersion(buf);
+}
+
+template <typename R>
+void RecordEncoderV2::AppendValue(const std::vector<R>& record,
+                                  size_t data_size, int cnt_not_null,
+                                  Buf& buf) {
+  int offset_unit = ValueOffsetUnit(data_size, cnt_not_null);
+  if (UseSparseValue(cnt_not_null)) {
+    AppendSparseValue(record, offset_unit, cnt_not_null, buf);
+    return;
+  }
+  if (fixed_block_value_) {
+    AppendFixedBlockValue(record, offset_unit, cnt_not_null, buf);
+    return;
+  }
+  if (dense_value_) {
+    AppendDenseValue(record, offset_unit, cnt_not_null, buf);
+    return;
+  }
+
+  // Offsets in the header are relative to the start of the value.
+  size_t base = buf.Size();
 
   int cnt_not_null_col = 0;
   int cnt_null_col = 0;
 
-  int cnt_not_null_col_pos = 4;
+  int cnt_not_null_col_pos =
+      base + (codec_version_ >= CODEC_VERSION_V3 ? 4 + 1 : 4);
   int cnt_null_col_pos = cnt_not_null_col_pos + 2;
-  int ids_pos = cnt_null_col_pos + 2;
-  int offset_pos = ids_pos + col_cnt * 2;
-  int data_pos = offset_pos + col_cnt * 4;
+  int offset_pos = cnt_null_col_pos + 2 + plan_.values.size() * id_unit_;
 
-  buf.ReSize(data_pos);
+  buf.WriteString(ValueHeaderTemplate(offset_unit));
 
   // append data.
-  for (const auto& schema : schemas_) {
-    if (!schema->IsKey()) {
-      int index = schema->GetIndex();
-      const auto& column = record.at(index);
-      if (schema->isNull(column)) {
-        cnt_null_col++;
-
-        // write id
-        buf.WriteShort(ids_pos, index);
-        ids_pos += 2;
-
-        // write offset
-        buf.WriteInt(offset_pos, -1);
-        offset_pos += 4;
-      } else {
-        cnt_not_null_col++;
-
-        // write id
-        buf.WriteShort(ids_pos, index);
-        ids_pos += 2;
-
-        // write offset
-        buf.WriteInt(offset_pos, data_pos);
-        offset_pos += 4;
-
-        // write data.
-        data_pos += schema->EncodeValue(column, buf);
-      }
+  for (const auto& op : plan_.values) {
+    const auto& column = record.at(op.index);
+    int offset;
+    if (IsNull(column)) {
+      cnt_null_col++;
+      offset = -1;
+    } else {
+      cnt_not_null_col++;
+      offset = buf.Size() - base;
+    }
+
+    // write offset
+    if (offset_unit == OFFSET_2_BYTE) {
+      buf.WriteShort(offset_pos, offset);
+    } else {
+      buf.WriteInt(offset_pos, offset);
+    }
+    offset_pos += offset_unit;
+
+    if (offset != -1) {
+      // write data.
+      EncodeValueColumn(op, column, buf);
     }
   }
 
   buf.WriteShort(cnt_not_null_col_pos, cnt_not_null_col);
   buf.WriteShort(cnt_null_col_pos, cnt_null_col);
+}
 
-  buf.GetString(output);
-  return output.size();
+template <typename R>
+void RecordEncoderV2::AppendDenseValue(const std::vector<R>& record,
+                                       int offset_unit, int cnt_not_null,
+                                       Buf& buf) {
+  // Offsets in the header are relative to the start of the value.
+  size_t base = buf.Size();
+  const auto& header = ValueHeaderTemplate(offset_unit);
+  int cnt_pos = base + 4 + 1;
+  int bitmap_pos = cnt_pos + 4;
+  int offset_pos = base + header.size();
+
+  buf.WriteString(header);
+  buf.WriteShort(cnt_pos, cnt_not_null);
+  buf.WriteShort(cnt_pos + 2, plan_.values.size() - cnt_not_null);
+  for (int i = 0; i < cnt_not_null; ++i) {
+    if (offset_unit == OFFSET_2_BYTE) {
+      buf.WriteShort(0);
+    } else {
+      buf.WriteInt(0);
+    }
+  }
+
+  for (const auto& op : plan_.values) {
+    const auto& column = record.at(op.index);
+    if (IsNull(column)) {
+      int pos = bitmap_pos + (op.value_slot >> 3);
+      buf.WriteByte(pos, buf.Read(pos) | (1 << (op.value_slot & 7)));
+      continue;
+    }
+
+    if (offset_unit == OFFSET_2_BYTE) {
+      buf.WriteShort(offset_pos, buf.Size() - base);
+    } else {
+      buf.WriteInt(offset_pos, buf.Size() - base);
+    }
+    offset_pos += offset_unit;
+    EncodeValueColumn(op, column, buf);
+  }
+}
+
+template <typename R>
+void RecordEncoderV2::AppendFixedBlockValue(const std::vector<R>& record,
+                                            int offset_unit, int cnt_not_null,
+                                            Buf& buf) {
+  // Offsets in the header are relative to the start of the value.
+  size_t base = buf.Size();
+  int cnt_pos = base + 4 + 1;
+  int bitmap_pos = cnt_pos + 4;
+
+  buf.WriteString(ValueHeaderTemplate(offset_unit));
+  buf.WriteShort(cnt_pos, cnt_not_null);
+  buf.WriteShort(cnt_pos + 2, plan_.values.size() - cnt_not_null);
+
+  auto set_null = [&](const CodecOp& op) {
+    int pos = bitmap_pos + (op.value_slot >> 3);
+    buf.WriteByte(pos, buf.Read(pos) | (1 << (op.value_slot & 7)));
+  };
+
+  // Fixed width columns fill the block in order, nulls are zero filled.
+  for (const auto& op : plan_.fixed_values) {
+    const auto& column = record.at(op.index);
+    if (IsNull(column)) {
+      set_null(op);
+      for (int i = 0; i < op.fixed_width; ++i) {
+        buf.Write(0);
+      }
+      continue;
+    }
+    EncodeValueColumn(op, column, buf);
+  }
+
+  int offset_pos = buf.Size();
+  for (size_t i = 0; i < plan_.var_values.size(); ++i) {
+    if (offset_unit == OFFSET_2_BYTE) {
+      buf.WriteShort(0);
+    } else {
+      buf.WriteInt(0);
+    }
+  }
+
+  for (const auto& op : plan_.var_values) {
+    const auto& column = record.at(op.index);
+    int offset = -1;
+    if (IsNull(column)) {
+      set_null(op);
+    } else {
+      offset = buf.Size() - base;
+    }
+
+    if (offset_unit == OFFSET_2_BYTE) {
+      buf.WriteShort(offset_pos, offset);
+    } else {
+      buf.WriteInt(offset_pos, offset);
+    }
+    offset_pos += offset_unit;
+
+    if (offset != -1) {
+      EncodeValueColumn(op, column, buf);
+    }
+  }
+}
+
+template <typename R>
+void RecordEncoderV2::AppendSparseValue(const std::vector<R>& record,
+                                        int offset_unit, int cnt_not_null,
+                                        Buf& buf) {
+  // Offsets in the header are relative to the start of the value.
+  size_t base = buf.Size();
+  int ids_pos = base + 4 + 1 + 4;
+  int offset_pos = ids_pos + cnt_not_null * sparse_id_unit_;
+
+  EncodeSchemaVersion(buf);
+  buf.Write(MakeValueUnits(sparse_id_unit_, offset_unit) | VALUE_SPARSE |
+            (compact_value_ ? VALUE_COMPACT : 0));
+  buf.WriteShort(cnt_not_null);
+  buf.WriteShort(plan_.values.size() - cnt_not_null);
+  for (int i = 0; i < cnt_not_null * (sparse_id_unit_ + offset_unit); ++i) {
+    buf.Write(0);
+  }
+
+  for (const auto& op : sparse_values_) {
+    const auto& column = record.at(op.index);
+    if (IsNull(column)) {
+      continue;
+    }
+
+    if (sparse_id_unit_ == ID_1_BYTE) {
+      buf.WriteByte(ids_pos, op.index);
+    } else {
+      buf.WriteShort(ids_pos, op.index);
+    }
+    ids_pos += sparse_id_unit_;
+    if (offset_unit == OFFSET_2_BYTE) {
+      buf.WriteShort(offset_pos, buf.Size() - base);
+    } else {
+      buf.WriteInt(offset_pos, buf.Size() - base);
+    }
+    offset_pos += offset_unit;
+    EncodeValueColumn(op, column, buf);
+  }
+}
+
+int RecordEncoderV2::EncodeBatch(
+    char prefix, const std::vector<std::vector<std::any>>& records,
+    EncodedBatch& batch) {
+  return EncodeBatchRecords(prefix, records, batch);
+}
+
+int RecordEncoderV2::EncodeBatch(char prefix,
+                                 const std::vector<std::vector<Value>>& records,
+                                 EncodedBatch& batch) {
+  return EncodeBatchRecords(prefix, records, batch);
+}
+
+template <typename R>
+int RecordEncoderV2::EncodeBatchRecords(
+    char prefix, const std::vector<std::vector<R>>& records,
+    EncodedBatch& batch) {
+  batch.key_offsets.clear();
+  batch.value_offsets.clear();
+  batch.key_offsets.reserve(records.size() + 1);
+  batch.value_offsets.reserve(records.size() + 1);
+
+  size_t keys_size = 0;
+  size_t values_size = 0;
+  std::vector<size_t> data_sizes(records.size());
+  std::vector<int> not_null_counts(records.size());
+  for (size_t i = 0; i < records.size(); ++i) {
+    keys_size += ComputeKeySize(records[i]);
+    data_sizes[i] = ComputeValueDataSize(records[i], not_null_counts[i]);
+    values_size += ValueHeaderSize(ValueOffsetUnit(data_sizes[i],
+                                                   not_null_counts[i]),
+                                   not_null_counts[i]) +
+                   data_sizes[i];
+  }
+
+  // Both arenas reuse the storage of the previous batch.
+  Buf key_buf(0, this->le_);
+  key_buf.Adopt(batch.keys);
+  key_buf.Reserve(keys_size);
+  Buf value_buf(0, this->le_);
+  value_buf.Adopt(batch.values);
+  value_buf.Reserve(values_size);
+
+  std::string key_prefix = KeyPrefix(prefix);
+  for (size_t i = 0; i < records.size(); ++i) {
+    batch.key_offsets.push_back(key_buf.Size());
+    AppendKey(key_prefix, records[i], key_buf);
+
+    batch.value_offsets.push_back(value_buf.Size());
+    AppendValue(records[i], data_sizes[i], not_null_counts[i], value_buf);
+    DeflateValue(batch.value_offsets.back(), value_buf);
+  }
+  batch.key_offsets.push_back(key_buf.Size());
+  batch.value_offsets.push_back(value_buf.Size());
+
+  key_buf.GetString(batch.keys);
+  value_buf.GetString(batch.values);
+  return 0;
 }
 
 int RecordEncoderV2::EncodeMaxKeyPrefix(char prefix,
@@ -162,7 +677,9 @@ int RecordEncoderV2::EncodeMaxKeyPrefix(char prefix,
     return -1;
   }
 
-  Buf buf(kBufInitCapacity, this->le_);
+  // The prefix fits in the inline storage of output.
+  Buf buf(0, this->le_);
+  buf.Adopt(output);
   buf.Write(prefix);
   buf.WriteLong(common_id_ + 1);
 
@@ -172,7 +689,8 @@ int RecordEncoderV2::EncodeMaxKeyPrefix(char prefix,
 
 int RecordEncoderV2::EncodeMinKeyPrefix(char prefix,
                                         std::string& output) const {
-  Buf buf(kBufInitCapacity, this->le_);
+  Buf buf(0, this->le_);
+  buf.Adopt(output);
 
   buf.Write(prefix);
   buf.WriteLong(common_id_);
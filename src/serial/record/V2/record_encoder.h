@@ -18,9 +18,13 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <string_view>
+#include <vector>
 
 #include "any"
+#include "codec_plan.h"
 #include "common.h"
+#include "value.h"
 #include "functional"  // IWYU pragma: keep
 #include "optional"    // IWYU pragma: keep
 #include "serial/schema/V2/boolean_list_schema.h" // IWYU pragma: keep
@@ -35,6 +39,7 @@
 #include "serial/schema/V2/long_schema.h"  // IWYU pragma: keep
 #include "serial/schema/V2/string_list_schema.h" // IWYU pragma: keep
 #include "serial/schema/V2/string_schema.h"  // IWYU pragma: keep
+#include "serial/utils/V2/deflate.h"
 #include "serial/utils/V2/keyvalue.h"        // IWYU pragma: keep
 #include "serial/utils/V2/utils.h" // IWYU pragma: keep
 #include "serial/utils/V2/utils.h"  // IWYU pragma: keep
@@ -42,6 +47,32 @@
 namespace dingodb {
 namespace serialV2 {
 
+/*
+ * Keys and values of a batch of records, each packed back to back into one
+ * arena. The i-th key is keys[key_offsets[i], key_offsets[i + 1]), values
+ * likewise.
+ */
+struct EncodedBatch {
+  std::string keys;
+  std::string values;
+  std::vector<size_t> key_offsets;
+  std::vector<size_t> value_offsets;
+
+  size_t Size() const {
+    return key_offsets.empty() ? 0 : key_offsets.size() - 1;
+  }
+
+  std::string_view GetKey(size_t i) const {
+    return std::string_view(keys.data() + key_offsets[i],
+                            key_offsets[i + 1] - key_offsets[i]);
+  }
+
+  std::string_view GetValue(size_t i) const {
+    return std::string_view(values.data() + value_offsets[i],
+                            value_offsets[i + 1] - value_offsets[i]);
+  }
+};
+
 class RecordEncoderV2;
 using RecordEncoderPtr = std::shared_ptr<RecordEncoderV2>;
 
@@ -66,11 +97,138 @@ class RecordEncoderV2 {
                 std::string& output);
   int EncodeValue(const std::vector<std::any>& record, std::string& output);
 
+  // Encode typed Value records, same encoding as the std::any overloads.
+  int Encode(char prefix, const std::vector<Value>& record, std::string& key,
+             std::string& value);
+  int EncodeKey(char prefix, const std::vector<Value>& record,
+                std::string& output);
+  int EncodeValue(const std::vector<Value>& record, std::string& output);
+
+  // Encode many records into the two arenas of batch, reusing their storage.
+  // Everything invariant across the rows is prepared once per batch.
+  int EncodeBatch(char prefix,
+                  const std::vector<std::vector<std::any>>& records,
+                  EncodedBatch& batch);
+  int EncodeBatch(char prefix, const std::vector<std::vector<Value>>& records,
+                  EncodedBatch& batch);
+
+  // Exact sizes of the key and value Encode produces for record, e.g. for
+  // write buffer accounting before encoding. The value size is an upper
+  // bound when values are deflated.
+  int ComputeEncodedSize(const std::vector<std::any>& record,
+                         size_t& key_size, size_t& value_size);
+  int ComputeEncodedSize(const std::vector<Value>& record, size_t& key_size,
+                         size_t& value_size);
+
+  // CODEC_VERSION_V2 (the default) or CODEC_VERSION_V3, which writes the
+  // compact value header: 1 byte ids below 255 columns and 2 byte offsets for
+  // values under 64KB. V3 rows whose header shrinks by more than half when
+  // listing only their non null columns are written sparse. Keys carry the
+  // version, so rows of both versions can be decoded side by side. Throws
+  // std::runtime_error for other versions.
+  void SetCodecVersion(int codec_version);
+  int GetCodecVersion() const { return codec_version_; }
+
+  // V3 only: write dense values, which store no column ids, since every row
+  // holds the value columns in schema order, and keep nulls in a bitmap
+  // instead of offsets. Readers must have the writer's value columns in the
+  // same order, so later schema changes may only append value columns.
+  // Throws std::runtime_error below V3, going back to V2 turns it off.
+  void SetDenseValue(bool dense);
+  bool IsDenseValue() const { return dense_value_; }
+
+  // V3 only: write fixed block values, which put every fixed width value
+  // column (bool, int, float, long, double) at a constant offset of a block
+  // ahead of the variable width ones, so reading one is a single load. Null
+  // fixed width columns still take their bytes and rows are never written
+  // sparse. The same schema order rule as for dense values applies. Throws
+  // std::runtime_error below V3 or when the block exceeds 64KB, going back to
+  // V2 turns it off.
+  void SetFixedBlockValue(bool fixed_block);
+  bool IsFixedBlockValue() const { return fixed_block_value_; }
+
+  // V3 only: write bool list columns bit packed, 8 values per byte. The
+  // list itself marks the form, so it combines with every value layout.
+  // Throws std::runtime_error below V3, going back to V2 turns it off.
+  void SetPackedBoolList(bool packed);
+  bool IsPackedBoolList() const { return packed_bool_list_; }
+
+  // V3 only: deflate values of at least threshold bytes, 0 (the default)
+  // turns it off. The bytes past the units byte are deflated and the row is
+  // flagged VALUE_DEFLATED, rows that do not shrink are kept as they are.
+  // Throws std::runtime_error below V3, going back to V2 turns it off.
+  void SetDeflateValue(size_t threshold);
+  size_t GetDeflateThreshold() const { return deflate_threshold_; }
+  // Preset dictionary for deflated values, decoders need the same one, see
+  // RecordDecoderV2::SetValueDictionary.
+  void SetValueDictionary(std::string dictionary);
+  const std::string& GetValueDictionary() const {
+    return deflater_.GetDictionary();
+  }
+
   int EncodeMaxKeyPrefix(char prefix, std::string& output) const;
   int EncodeMinKeyPrefix(char prefix, std::string& output) const;
   void Refresh();
 
  private:
+  template <typename R>
+  size_t ComputeKeySize(const std::vector<R>& record) const;
+  template <typename R>
+  size_t ComputeValueSize(const std::vector<R>& record) const;
+  // Size of the value columns of record, the value header excluded, and the
+  // number of them that are not null. The fixed block of fixed block values
+  // counts as header.
+  template <typename R>
+  size_t ComputeValueDataSize(const std::vector<R>& record,
+                              int& cnt_not_null) const;
+
+  template <typename R>
+  int EncodeRecord(char prefix, const std::vector<R>& record, std::string& key,
+                   std::string& value);
+  template <typename R>
+  int EncodeKeyRecord(char prefix, const std::vector<R>& record,
+                      std::string& output);
+  template <typename R>
+  int EncodeValueRecord(const std::vector<R>& record, std::string& output);
+  template <typename R>
+  int EncodeBatchRecords(char prefix,
+                         const std::vector<std::vector<R>>& records,
+                         EncodedBatch& batch);
+
+  // Append one encoded key / value to buf.
+  template <typename R>
+  void AppendKey(const std::string& key_prefix, const std::vector<R>& record,
+                 Buf& buf);
+  template <typename R>
+  void AppendValue(const std::vector<R>& record, size_t data_size,
+                   int cnt_not_null, Buf& buf);
+  template <typename R>
+  void AppendDenseValue(const std::vector<R>& record, int offset_unit,
+                        int cnt_not_null, Buf& buf);
+  template <typename R>
+  void AppendFixedBlockValue(const std::vector<R>& record, int offset_unit,
+                             int cnt_not_null, Buf& buf);
+  template <typename R>
+  void AppendSparseValue(const std::vector<R>& record, int offset_unit,
+                         int cnt_not_null, Buf& buf);
+
+  // Deflate the value appended to buf at base if it is large enough and
+  // shrinks.
+  void DeflateValue(size_t base, Buf& buf);
+
+  // Whether a row with cnt_not_null non null value columns is written sparse.
+  bool UseSparseValue(int cnt_not_null) const;
+
+  // Offset unit of a value holding data_size bytes in cnt_not_null columns,
+  // the value header template using it and the full header size.
+  int ValueOffsetUnit(size_t data_size, int cnt_not_null) const;
+  const std::string& ValueHeaderTemplate(int offset_unit) const;
+  size_t ValueHeaderSize(int offset_unit, int cnt_not_null) const;
+  std::string BuildValueHeader(int offset_unit) const;
+  void BuildValueHeaders();
+
+  std::string KeyPrefix(char prefix) const;
+
   void EncodePrefix(Buf& buf, char prefix) const;
   void EncodeSchemaVersion(Buf& buf) const;
   void EncodeCodecVersion(Buf& buf) const;
@@ -85,6 +243,29 @@ class RecordEncoderV2 {
   long common_id_;
 
   std::vector<BaseSchemaPtr> schemas_;
+  // schemas_ compiled at construction, the encode loops run over it.
+  CodecPlan plan_;
+  bool dense_value_{false};
+  bool fixed_block_value_{false};
+  bool packed_bool_list_{false};
+  // Some value column is written compact, V3 only.
+  bool compact_value_{false};
+  // Values of at least this many bytes are deflated, 0 for none.
+  size_t deflate_threshold_{0};
+  Deflater deflater_;
+  std::string deflate_scratch_;
+  // Unit of the ids in the value header, ID_IMPLIED for dense and fixed
+  // block values.
+  int id_unit_{ID_2_BYTE};
+  // Value columns sorted by id and the id unit of sparse values.
+  std::vector<CodecOp> sparse_values_;
+  int sparse_id_unit_{ID_2_BYTE};
+  // Value header with every column id filled in and zero counts / offsets,
+  // with 4 byte offsets and, for V3, with 2 byte offsets. Dense headers stop
+  // after an all zero null bitmap, their offsets depend on the row, fixed
+  // block headers after the fixed block size.
+  std::string value_header_;
+  std::string short_value_header_;
 };
 
 }  // namespace serialV2
@@ -0,0 +1,70 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGO_SERIAL_RECORD_FILTER_V2_H_
+#define DINGO_SERIAL_RECORD_FILTER_V2_H_
+
+#include <string>
+#include <vector>
+
+#include "codec_plan.h"
+#include "value.h"
+
+namespace dingodb {
+namespace serialV2 {
+
+/*
+ * A simple predicate over one column.
+ *
+ * kEqual, kLess and kLessEqual take one operand, kBetween two inclusive
+ * bounds, kIn any number of candidates and kIsNull none. Operands hold the
+ * column type, a comparison with a null column is false.
+ */
+struct Predicate {
+  enum Op { kEqual, kLess, kLessEqual, kBetween, kIn, kIsNull };
+
+  // Position of the column in the schema vector.
+  int column{0};
+  Op op{kEqual};
+  std::vector<Value> operands;
+};
+
+/*
+ * Predicates compiled by RecordDecoderV2::CompileFilter, a row passes when
+ * all of them hold.
+ *
+ * Operands of key columns are stored key encoded, so they compare to the
+ * encoded key bytes with memcmp. The filter borrows the schemas of the
+ * decoder that compiled it.
+ */
+struct RecordFilter {
+  struct Term {
+    CodecOp column;
+    Predicate::Op op{Predicate::kEqual};
+    // Key columns: the encoded null and the encoded operands.
+    std::string null_key;
+    std::vector<std::string> keys;
+    // Value columns: the operands.
+    std::vector<Value> values;
+  };
+
+  // Key terms in column order, so a row's key is walked once.
+  std::vector<Term> key_terms;
+  std::vector<Term> value_terms;
+};
+
+}  // namespace serialV2
+}  // namespace dingodb
+
+#endif
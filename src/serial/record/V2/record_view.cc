@@ -0,0 +1,177 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "record_view.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <variant>
+
+namespace dingodb {
+namespace serialV2 {
+
+void RecordView::Reset(const CodecPlan* plan, bool le, std::string_view key,
+                       std::string_view value, int key_pos,
+                       const ValueHeader& value_header) {
+  plan_ = plan;
+  le_ = le;
+  key_ = key;
+  value_ = value;
+  value_header_ = value_header;
+
+  size_t size = plan->columns.size();
+  key_offsets_.resize(size);
+  next_key_col_ = 0;
+  key_cursor_ = key_pos;
+  key_cache_.resize(size);
+  key_cached_.assign(size, false);
+}
+
+const CodecOp& RecordView::Column(int col) const {
+  if (DINGO_UNLIKELY(plan_ == nullptr || col < 0 ||
+                     static_cast<size_t>(col) >= plan_->columns.size() ||
+                     plan_->columns[col].schema == nullptr)) {
+    throw std::runtime_error("Column not found.");
+  }
+  return plan_->columns[col];
+}
+
+const CodecOp& RecordView::Column(int col, BaseSchema::Type type) const {
+  const auto& op = Column(col);
+  if (DINGO_UNLIKELY(op.type != type)) {
+    throw std::runtime_error("Column type mismatch.");
+  }
+  return op;
+}
+
+const Value& RecordView::KeyColumn(const CodecOp& op) const {
+  auto& data = key_cache_[op.position];
+  if (key_cached_[op.position]) {
+    return data;
+  }
+
+  BufView buf(key_, le_);
+  buf.SetReadOffset(key_cursor_);
+  for (; next_key_col_ <= op.position; ++next_key_col_) {
+    const auto& column = plan_->columns[next_key_col_];
+    if (column.schema != nullptr && column.is_key) {
+      key_offsets_[next_key_col_] = buf.ReadOffset();
+      VisitSchema(column, [&](auto* schema) { return schema->SkipKey(buf); });
+    }
+  }
+  key_cursor_ = buf.ReadOffset();
+
+  buf.SetReadOffset(key_offsets_[op.position]);
+  DecodeKeyColumn(op, buf, data);
+  key_cached_[op.position] = true;
+  return data;
+}
+
+int RecordView::ValueOffset(const CodecOp& op) const {
+  BufView buf(value_, le_);
+  return value_header_.FindOffset(buf, op);
+}
+
+template <typename T>
+T RecordView::GetScalar(int col, BaseSchema::Type type) const {
+  const auto& op = Column(col, type);
+  if (op.is_key) {
+    const auto& data = KeyColumn(op);
+    if (DINGO_UNLIKELY(serialV2::IsNull(data))) {
+      throw std::runtime_error("Column is null.");
+    }
+    return std::get<T>(data);
+  }
+
+  int offset = ValueOffset(op);
+  if (DINGO_UNLIKELY(offset == -1)) {
+    throw std::runtime_error("Column is null.");
+  }
+  BufView buf(value_, le_);
+  buf.SetReadOffset(offset);
+  T data;
+  DecodeValueData(static_cast<DingoSchema<T>*>(op.schema),
+                  value_header_.IsCompact(op), buf, data);
+  return data;
+}
+
+bool RecordView::IsNull(int col) const {
+  const auto& op = Column(col);
+  if (op.is_key) {
+    return serialV2::IsNull(KeyColumn(op));
+  }
+  return ValueOffset(op) == -1;
+}
+
+bool RecordView::GetBool(int col) const {
+  return GetScalar<bool>(col, BaseSchema::kBool);
+}
+
+int32_t RecordView::GetInt32(int col) const {
+  return GetScalar<int32_t>(col, BaseSchema::kInteger);
+}
+
+float RecordView::GetFloat(int col) const {
+  return GetScalar<float>(col, BaseSchema::kFloat);
+}
+
+int64_t RecordView::GetInt64(int col) const {
+  return GetScalar<int64_t>(col, BaseSchema::kLong);
+}
+
+double RecordView::GetDouble(int col) const {
+  return GetScalar<double>(col, BaseSchema::kDouble);
+}
+
+std::string_view RecordView::GetString(int col) const {
+  const auto& op = Column(col, BaseSchema::kString);
+  if (op.is_key) {
+    const auto& data = KeyColumn(op);
+    if (DINGO_UNLIKELY(serialV2::IsNull(data))) {
+      throw std::runtime_error("Column is null.");
+    }
+    return std::get<std::string>(data);
+  }
+
+  int offset = ValueOffset(op);
+  if (DINGO_UNLIKELY(offset == -1)) {
+    throw std::runtime_error("Column is null.");
+  }
+  // {length: 4byte}{bytes}, the bytes are returned in place.
+  BufView buf(value_, le_);
+  buf.SetReadOffset(offset);
+  return static_cast<DingoSchema<std::string>*>(op.schema)->ViewValue(buf);
+}
+
+Value RecordView::GetValue(int col) const {
+  const auto& op = Column(col);
+  if (op.is_key) {
+    return KeyColumn(op);
+  }
+
+  Value data;
+  int offset = ValueOffset(op);
+  if (offset != -1) {
+    BufView buf(value_, le_);
+    buf.SetReadOffset(offset);
+    DecodeValueColumn(op, buf, data, value_header_.IsCompact(op));
+  }
+  return data;
+}
+
+}  // namespace serialV2
+}  // namespace dingodb
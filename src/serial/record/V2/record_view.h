@@ -0,0 +1,104 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGO_SERIAL_RECORD_VIEW_V2_H_
+#define DINGO_SERIAL_RECORD_VIEW_V2_H_
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "codec_plan.h"
+#include "value.h"
+#include "value_header.h"
+
+namespace dingodb {
+namespace serialV2 {
+
+class RecordDecoderV2;
+
+/*
+ * Lazy view of one encoded row, filled by RecordDecoderV2::View.
+ *
+ * The row is validated once when the view is filled, each getter then
+ * decodes only the column it is asked for. Value columns are located through
+ * the offset table. Key columns are variable length, their start offsets are
+ * found by walking the key once up to the furthest column asked for and
+ * decoded key columns are cached.
+ *
+ * The view borrows the key and value bytes and the decoder that filled it,
+ * except for a deflated value which it inflates into itself, so views are
+ * not copyable.
+ * Columns are schema positions, an unknown column or a getter not matching
+ * the column type throws std::runtime_error, so does a typed getter on a null
+ * column.
+ */
+class RecordView {
+ public:
+  RecordView() = default;
+  RecordView(const RecordView&) = delete;
+  RecordView& operator=(const RecordView&) = delete;
+
+  bool IsNull(int col) const;
+
+  bool GetBool(int col) const;
+  int32_t GetInt32(int col) const;
+  float GetFloat(int col) const;
+  int64_t GetInt64(int col) const;
+  double GetDouble(int col) const;
+  // Valid until the view is filled again. Value strings point into the value
+  // bytes, key strings into the view's cache.
+  std::string_view GetString(int col) const;
+
+  // Any column, lists included, null columns are returned as null.
+  Value GetValue(int col) const;
+
+ private:
+  friend class RecordDecoderV2;
+
+  // key_pos is where the first key column starts.
+  void Reset(const CodecPlan* plan, bool le, std::string_view key,
+             std::string_view value, int key_pos,
+             const ValueHeader& value_header);
+
+  const CodecOp& Column(int col) const;
+  const CodecOp& Column(int col, BaseSchema::Type type) const;
+  // Decoded key column, cached.
+  const Value& KeyColumn(const CodecOp& op) const;
+  // Offset of a value column's data, -1 when null.
+  int ValueOffset(const CodecOp& op) const;
+  template <typename T>
+  T GetScalar(int col, BaseSchema::Type type) const;
+
+  const CodecPlan* plan_{nullptr};
+  bool le_{true};
+  std::string_view key_;
+  std::string_view value_;
+  ValueHeader value_header_;
+  // Inflated copy of a deflated value, value_ then points into it.
+  std::string inflated_value_;
+
+  // Start of each key column in key_, valid below next_key_col_.
+  mutable std::vector<int> key_offsets_;
+  mutable int next_key_col_{0};
+  mutable int key_cursor_{0};
+  mutable std::vector<Value> key_cache_;
+  mutable std::vector<bool> key_cached_;
+};
+
+}  // namespace serialV2
+}  // namespace dingodb
+
+#endif
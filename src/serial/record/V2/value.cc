@@ -0,0 +1,76 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "value.h"
+
+#include <any>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+namespace dingodb {
+namespace serialV2 {
+
+std::any ValueToAny(const Value& value) {
+  return std::visit(
+      [](const auto& data) -> std::any {
+        using T = std::decay_t<decltype(data)>;
+        if constexpr (std::is_same_v<T, std::monostate>) {
+          return std::any();
+        } else {
+          return std::any(data);
+        }
+      },
+      value);
+}
+
+Value AnyToValue(const std::any& data, BaseSchema::Type type) {
+  if (!data.has_value()) {
+    return Value();
+  }
+
+  switch (type) {
+    case BaseSchema::kBool:
+      return std::any_cast<bool>(data);
+    case BaseSchema::kInteger:
+      return std::any_cast<int32_t>(data);
+    case BaseSchema::kFloat:
+      return std::any_cast<float>(data);
+    case BaseSchema::kLong:
+      return std::any_cast<int64_t>(data);
+    case BaseSchema::kDouble:
+      return std::any_cast<double>(data);
+    case BaseSchema::kString:
+      return std::any_cast<const std::string&>(data);
+    case BaseSchema::kBoolList:
+      return std::any_cast<const std::vector<bool>&>(data);
+    case BaseSchema::kIntegerList:
+      return std::any_cast<const std::vector<int32_t>&>(data);
+    case BaseSchema::kFloatList:
+      return std::any_cast<const std::vector<float>&>(data);
+    case BaseSchema::kLongList:
+      return std::any_cast<const std::vector<int64_t>&>(data);
+    case BaseSchema::kDoubleList:
+      return std::any_cast<const std::vector<double>&>(data);
+    case BaseSchema::kStringList:
+      return std::any_cast<const std::vector<std::string>&>(data);
+    default:
+      throw std::runtime_error("Unsupported schema type.");
+  }
+}
+
+}  // namespace serialV2
+}  // namespace dingodb
@@ -0,0 +1,80 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGO_SERIAL_VALUE_V2_H_
+#define DINGO_SERIAL_VALUE_V2_H_
+
+#include <any>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+#include "serial/schema/V2/base_schema.h"
+#include "serial/utils/V2/compiler.h"
+
+namespace dingodb {
+namespace serialV2 {
+
+/*
+ * Typed column value, the alternative to std::any in records.
+ *
+ * std::monostate is null, the other alternatives follow BaseSchema::Type, so
+ * index() == type + 1. Scalars are stored inline and a type check is an
+ * index comparison.
+ */
+using Value =
+    std::variant<std::monostate, bool, int32_t, float, int64_t, double,
+                 std::string, std::vector<bool>, std::vector<int32_t>,
+                 std::vector<float>, std::vector<int64_t>, std::vector<double>,
+                 std::vector<std::string>>;
+
+static_assert(std::variant_size_v<Value> == BaseSchema::kStringList + 2);
+static_assert(std::is_same_v<std::variant_alternative_t<
+                                 BaseSchema::kString + 1, Value>,
+                             std::string>);
+
+inline bool IsNull(const Value& value) { return value.index() == 0; }
+inline bool IsNull(const std::any& value) { return !value.has_value(); }
+
+// Type of a non null value.
+inline BaseSchema::Type GetValueType(const Value& value) {
+  return static_cast<BaseSchema::Type>(value.index() - 1);
+}
+
+// Pointer to the T held by value, nullptr when value is null. Holding any
+// other type is an error.
+template <typename T>
+inline const T* ValueDataPtr(const Value& value) {
+  if (IsNull(value)) {
+    return nullptr;
+  }
+
+  const T* data = std::get_if<T>(&value);
+  if (DINGO_UNLIKELY(data == nullptr)) {
+    throw std::runtime_error("Value type mismatch.");
+  }
+  return data;
+}
+
+// Conversions to and from the std::any representation.
+std::any ValueToAny(const Value& value);
+Value AnyToValue(const std::any& data, BaseSchema::Type type);
+
+}  // namespace serialV2
+}  // namespace dingodb
+
+#endif
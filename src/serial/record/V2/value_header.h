@@ -15,41 +15,253 @@
 #ifndef DINGO_SERIAL_VALUE_HEADER_H_
 #define DINGO_SERIAL_VALUE_HEADER_H_
 
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+#include "codec_plan.h"
 #include "common.h"
 #include "serial/utils/V2/buf.h"
+#include "serial/utils/V2/compiler.h"
 
 namespace dingodb {
 namespace serialV2 {
 
+/*
+ * Value header layout:
+ *   V2: schema_version(4) | cnt_not_null(2) | cnt_null(2) |
+ *       ids(2 * total_col_cnt) | offsets(4 * total_col_cnt) | data
+ *   V3: schema_version(4) | units(1) | cnt_not_null(2) | cnt_null(2) |
+ *       ids(id_unit * total_col_cnt) | offsets(offset_unit * total_col_cnt) |
+ *       data
+ *   V3 dense (id unit ID_IMPLIED):
+ *       schema_version(4) | units(1) | cnt_not_null(2) | cnt_null(2) |
+ *       null_bitmap((total_col_cnt + 7) / 8) |
+ *       offsets(offset_unit * cnt_not_null) | data
+ *   V3 sparse (VALUE_SPARSE set in units):
+ *       schema_version(4) | units(1) | cnt_not_null(2) | cnt_null(2) |
+ *       ids(id_unit * cnt_not_null) | offsets(offset_unit * cnt_not_null) |
+ *       data
+ *   V3 fixed block (id unit ID_IMPLIED, VALUE_FIXED_BLOCK set in units):
+ *       schema_version(4) | units(1) | cnt_not_null(2) | cnt_null(2) |
+ *       null_bitmap((total_col_cnt + 7) / 8) | fixed_size(2) |
+ *       fixed block(fixed_size) | offsets(offset_unit * var_col_cnt) | data
+ *
+ * VALUE_COMPACT in units changes no layout, it tells that the columns whose
+ * schema asks for the compact form hold it.
+ *
+ * VALUE_DEFLATED in units wraps any of the V3 layouts:
+ *   schema_version(4) | units(1) | raw_size(4) | deflated(rest)
+ * where rest, raw_size bytes, is everything the layout has past units. The
+ * decoder inflates it behind the first five bytes with the flag cleared and
+ * parses the result as usual, offsets are unchanged.
+ *
+ * A null column has an offset of all ones. A dense value stores no ids, slot
+ * n holds the n-th value column of the schema, and only non null columns
+ * have an offset: the offset of slot n is the entry counting the non null
+ * slots before it. Schema changes must then only append value columns, the
+ * columns past total_col_cnt read as null. A sparse value only lists its non
+ * null columns, ids ascending, and is searched by id. A fixed block value
+ * holds every fixed width column of the schema at a constant offset in the
+ * fixed block, nulls zero filled, and keeps offsets for the variable width
+ * columns only; like dense values its slots follow the schema order.
+ *
+ * Only the fixed part is parsed up front. Column ids and offsets are read
+ * straight from the buffer when a column is looked up, so building a header
+ * never allocates. The constructor checks once that the tables fit in the
+ * value, throwing std::out_of_range otherwise, so lookups may read the null
+ * bitmap in place.
+ */
 class ValueHeader {
   public:
-  int cnt_not_null_col;
-  int cnt_null_col;
-  int total_col_cnt;
-
-  int ids_pos;
-  int offset_pos;
-  int data_pos;
+  int cnt_not_null_col{0};
+  int cnt_null_col{0};
+  int total_col_cnt{0};
+  int id_unit{ID_2_BYTE};
+  int offset_unit{OFFSET_4_BYTE};
+  bool sparse{false};
+  bool fixed_block{false};
+  bool compact{false};
 
-  std::map<int, int> col_id_offset_map = {};
+  int ids_pos{0};
+  int bitmap_pos{0};
+  int fixed_pos{0};
+  int fixed_size{0};
+  int offset_pos{0};
+  // Not known for fixed block values, their offsets table is sized by the
+  // schema.
+  int data_pos{0};
 
   ValueHeader() = default;
 
-  ValueHeader(Buf& value_buf) {
+  // value_buf must be positioned right after the schema version.
+  ValueHeader(BufView& value_buf)
+      : ValueHeader(value_buf, CODEC_VERSION_V2) {}
+  ValueHeader(BufView& value_buf, int codec_version) {
+    // schema_version(4 bytes)
+    int pos = 4;
+    if (codec_version >= CODEC_VERSION_V3) {
+      uint8_t units = value_buf.Read();
+      id_unit = GetValueIdUnit(units);
+      offset_unit = GetValueOffsetUnit(units);
+      sparse = IsSparseValue(units);
+      fixed_block = IsFixedBlockValue(units);
+      compact = IsCompactValue(units);
+      pos += 1;
+    }
     cnt_not_null_col = value_buf.ReadShort();
     cnt_null_col = value_buf.ReadShort();
+    if (DINGO_UNLIKELY(cnt_not_null_col < 0 || cnt_null_col < 0)) {
+      throw std::out_of_range("Out of range.");
+    }
     total_col_cnt = cnt_not_null_col + cnt_null_col;
 
-    // schema_version(4 bytes) + col_cnt (2 bytes + 2bytes) = 8 bytes.
-    ids_pos = 8;
-    offset_pos = ids_pos + ID_2_BYTE * total_col_cnt;
-    data_pos = offset_pos + OFFSET_4_BYTE * total_col_cnt;
+    // col_cnt (2 bytes + 2bytes) = 4 bytes.
+    if (fixed_block) {
+      bitmap_pos = pos + 4;
+      int size_pos = bitmap_pos + NullBitmapSize(total_col_cnt);
+      fixed_size = static_cast<uint16_t>(value_buf.ReadShort(size_pos));
+      fixed_pos = size_pos + 2;
+      offset_pos = fixed_pos + fixed_size;
+      // The offsets of the variable width columns are read checked.
+      CheckExtent(value_buf, offset_pos);
+      return;
+    }
+    if (id_unit == ID_IMPLIED) {
+      bitmap_pos = pos + 4;
+      offset_pos = bitmap_pos + NullBitmapSize(total_col_cnt);
+      data_pos = offset_pos + offset_unit * cnt_not_null_col;
+    } else if (sparse) {
+      ids_pos = pos + 4;
+      offset_pos = ids_pos + id_unit * cnt_not_null_col;
+      data_pos = offset_pos + offset_unit * cnt_not_null_col;
+    } else {
+      ids_pos = pos + 4;
+      offset_pos = ids_pos + id_unit * total_col_cnt;
+      data_pos = offset_pos + offset_unit * total_col_cnt;
+    }
+    CheckExtent(value_buf, data_pos);
+  }
+
+  // Column id / data offset stored in the slot-th entry of the table.
+  int ColumnId(BufView& value_buf, int slot) const {
+    if (id_unit == ID_1_BYTE) {
+      return value_buf.Read(ids_pos + slot);
+    }
+    return value_buf.ReadShort(ids_pos + ID_2_BYTE * slot);
+  }
+  int ColumnOffset(BufView& value_buf, int slot) const {
+    if (offset_unit == OFFSET_2_BYTE) {
+      uint16_t offset = value_buf.ReadShort(offset_pos + OFFSET_2_BYTE * slot);
+      return offset == 0xFFFF ? -1 : offset;
+    }
+    return value_buf.ReadInt(offset_pos + OFFSET_4_BYTE * slot);
+  }
+
+  // Offset of the data of value column op, -1 when it is null or not present
+  // in this row. op.value_slot is where the column is expected in the ids
+  // table, a hit there costs one probe, otherwise the table is scanned.
+  int FindOffset(BufView& value_buf, const CodecOp& op) const {
+    if (fixed_block) {
+      return FixedBlockOffset(value_buf, op);
+    }
+    if (id_unit == ID_IMPLIED) {
+      return DenseOffset(value_buf, op.value_slot);
+    }
+    if (sparse) {
+      return SparseOffset(value_buf, op.index);
+    }
+    int slot = op.value_slot;
+    if (slot >= 0 && slot < total_col_cnt &&
+        ColumnId(value_buf, slot) == op.index) {
+      return ColumnOffset(value_buf, slot);
+    }
 
     for (int i = 0; i < total_col_cnt; ++i) {
-      col_id_offset_map[value_buf.ReadShort(ids_pos)] =
-          value_buf.ReadInt(offset_pos);
-      ids_pos += ID_2_BYTE;
-      offset_pos += OFFSET_4_BYTE;
+      if (ColumnId(value_buf, i) == op.index) {
+        return ColumnOffset(value_buf, i);
+      }
+    }
+
+    return -1;
+  }
+
+  // Whether the data of value column op is in the compact form.
+  bool IsCompact(const CodecOp& op) const { return compact && op.compact; }
+
+  // Whether slot of a dense or fixed block value is null.
+  bool SlotIsNull(BufView& value_buf, int slot) const {
+    const auto* bitmap =
+        reinterpret_cast<const uint8_t*>(value_buf.Data() + bitmap_pos);
+    return bitmap[slot >> 3] & (1 << (slot & 7));
+  }
+
+  // Offset of the data of op in a fixed block value, -1 when it is null.
+  // Fixed width columns are at a constant offset, no table is read.
+  int FixedBlockOffset(BufView& value_buf, const CodecOp& op) const {
+    if (op.value_slot < 0 || op.value_slot >= total_col_cnt ||
+        SlotIsNull(value_buf, op.value_slot)) {
+      return -1;
+    }
+    if (op.fixed_offset != -1) {
+      if (DINGO_UNLIKELY(op.fixed_offset + op.fixed_width > fixed_size)) {
+        throw std::out_of_range("Out of range.");
+      }
+      return fixed_pos + op.fixed_offset;
+    }
+    return ColumnOffset(value_buf, op.var_slot);
+  }
+
+  // Offset of the data in slot of a dense value, -1 when it is null.
+  int DenseOffset(BufView& value_buf, int slot) const {
+    if (slot < 0 || slot >= total_col_cnt) {
+      return -1;
+    }
+    if (SlotIsNull(value_buf, slot)) {
+      return -1;
+    }
+    const auto* bitmap =
+        reinterpret_cast<const uint8_t*>(value_buf.Data() + bitmap_pos);
+    uint8_t low_bits = (1 << (slot & 7)) - 1;
+
+    // Null slots before slot, bit counts do not depend on byte order.
+    int nulls = __builtin_popcount(bitmap[slot >> 3] & low_bits);
+    int i = 0;
+    for (; i + 8 <= (slot >> 3); i += 8) {
+      uint64_t word;
+      memcpy(&word, bitmap + i, sizeof(word));
+      nulls += __builtin_popcountll(word);
+    }
+    for (; i < (slot >> 3); ++i) {
+      nulls += __builtin_popcount(bitmap[i]);
+    }
+    return ColumnOffset(value_buf, slot - nulls);
+  }
+
+  // Offset of the data of column col_id in a sparse value, -1 when it is
+  // not listed.
+  int SparseOffset(BufView& value_buf, int col_id) const {
+    int low = 0;
+    int high = cnt_not_null_col;
+    while (low < high) {
+      int mid = (low + high) >> 1;
+      if (ColumnId(value_buf, mid) < col_id) {
+        low = mid + 1;
+      } else {
+        high = mid;
+      }
+    }
+    if (low < cnt_not_null_col && ColumnId(value_buf, low) == col_id) {
+      return ColumnOffset(value_buf, low);
+    }
+    return -1;
+  }
+
+  // The header parts up to end must lie in the value.
+  static void CheckExtent(const BufView& value_buf, int end) {
+    if (DINGO_UNLIKELY(static_cast<size_t>(end) > value_buf.Size())) {
+      throw std::out_of_range("Out of range.");
     }
   }
 
@@ -62,7 +62,12 @@ class RecordEncoder {
     delete re_v2_;
   }
 
-  void SetCodecVersion(int v) { this->codec_version_ = v; }
+  void SetCodecVersion(int v) {
+    this->codec_version_ = v;
+    if (v != serialV2::CODEC_VERSION_V1) {
+      re_v2_->SetCodecVersion(v);
+    }
+  }
 
   int GetCodecVersion() { return this->codec_version_; }
 
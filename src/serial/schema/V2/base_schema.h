@@ -29,6 +29,13 @@ namespace serialV2 {
 class BaseSchema;
 using BaseSchemaPtr = std::shared_ptr<serialV2::BaseSchema>;
 
+// Pointer to the T held by data, nullptr when data is empty. A mismatched
+// type still throws std::bad_any_cast.
+template <typename T>
+inline const T* AnyDataPtr(const std::any& data) {
+  return data.has_value() ? &std::any_cast<const T&>(data) : nullptr;
+}
+
 class BaseSchema {
  public:
   virtual ~BaseSchema() = default;
@@ -97,16 +104,26 @@ class BaseSchema {
   void SetIsLe(bool le) { le_ = le; }
   void SetIsKey(bool is_key) { is_key_ = is_key; }
   void SetAllowNull(bool allow_null) { allow_null_ = allow_null; }
+  // Write this int, long, int list or long list value column in the compact
+  // varint form of V3 rows, see RecordEncoderV2::SetCodecVersion. Ignored
+  // for other types and key columns.
+  bool IsCompactValue() const { return compact_value_; }
+  void SetCompactValue(bool compact) { compact_value_ = compact; }
+  // Write this int list or long list value column delta packed in V3 rows
+  // when that is smaller, see delta_pack.h. Takes precedence over
+  // SetCompactValue, ignored for other types.
+  bool IsDeltaValue() const { return delta_value_; }
+  void SetDeltaValue(bool delta) { delta_value_ = delta; }
   bool isNull(const std::any& data) { return data.has_value() ? false : true; }
 
-  virtual int SkipKey(Buf& buf) = 0;
-  virtual int SkipValue(Buf& buf) = 0;
+  virtual int SkipKey(BufView& buf) = 0;
+  virtual int SkipValue(BufView& buf) = 0;
 
   virtual int EncodeKey(const std::any& data, Buf& buf) = 0;
   virtual int EncodeValue(const std::any& data, Buf& buf) = 0;
 
-  virtual std::any DecodeKey(Buf& buf) = 0;
-  virtual std::any DecodeValue(Buf& buf) = 0;
+  virtual std::any DecodeKey(BufView& buf) = 0;
+  virtual std::any DecodeValue(BufView& buf) = 0;
 
  protected:
   const uint8_t k_null = 0;
@@ -118,6 +135,8 @@ class BaseSchema {
   bool le_{true};
   bool is_key_{false};
   bool allow_null_{false};
+  bool compact_value_{false};
+  bool delta_value_{false};
   int index_;
 };
 
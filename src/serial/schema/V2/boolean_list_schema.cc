@@ -14,17 +14,114 @@
 
 #include "boolean_list_schema.h"
 
+#include <algorithm>
 #include <any>
 #include <cstdint>
+#include <cstring>
 #include <stdexcept>
 #include <utility>
 #include <vector>
 
+#include "serial/utils/V2/byte_order.h"
 #include "serial/utils/V2/compiler.h"
 
 namespace dingodb {
 namespace serialV2 {
 
+namespace {
+
+// Top bit of the element count marks the bit packed form.
+constexpr uint32_t kPackedFlag = 0x80000000;
+
+inline int PackedSize(size_t count) { return (count + 7) / 8; }
+
+// Clear the bits past count in the last packed byte.
+inline void MaskTail(uint8_t* bits, size_t count) {
+  if (count % 8 != 0) {
+    bits[count / 8] &= (1 << (count % 8)) - 1;
+  }
+}
+
+// Pack 8 bytes, each 0 or not, into one byte with byte i at bit i. Each byte
+// is folded into its low bit and the multiply gathers the 8 low bits into the
+// top byte without carries.
+inline uint8_t PackByteGroup(const uint8_t* src) {
+  uint64_t bytes =
+      LoadWire<!kHostLe, uint64_t>(reinterpret_cast<const char*>(src));
+  bytes |= bytes >> 4;
+  bytes |= bytes >> 2;
+  bytes |= bytes >> 1;
+  bytes &= 0x0101010101010101ULL;
+  return (bytes * 0x0102040810204080ULL) >> 56;
+}
+
+// One bool per byte to packed bits, dst receives PackedSize(count) bytes.
+void PackBytes(const uint8_t* src, size_t count, uint8_t* dst) {
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    dst[i / 8] = PackByteGroup(src + i);
+  }
+  if (i < count) {
+    uint8_t bits = 0;
+    for (size_t j = 0; i + j < count; ++j) {
+      bits |= (src[i + j] != 0) << j;
+    }
+    dst[i / 8] = bits;
+  }
+}
+
+// vector<bool> is walked through its iterators, 8 elements per packed byte.
+void PackBitVector(const std::vector<bool>& data, uint8_t* dst) {
+  size_t count = data.size();
+  auto it = data.begin();
+  for (size_t i = 0; i < count; i += 8) {
+    size_t n = std::min<size_t>(8, count - i);
+    uint8_t bits = 0;
+    for (size_t j = 0; j < n; ++j, ++it) {
+      bits |= static_cast<uint8_t>(*it) << j;
+    }
+    dst[i / 8] = bits;
+  }
+}
+
+// data is resized to count before the bits are filled in.
+void UnpackBitVector(const uint8_t* bits, size_t count,
+                     std::vector<bool>& data) {
+  data.resize(count);
+  auto it = data.begin();
+  for (size_t i = 0; i < count; i += 8) {
+    size_t n = std::min<size_t>(8, count - i);
+    uint8_t byte = bits[i / 8];
+    for (size_t j = 0; j < n; ++j, ++it) {
+      *it = (byte >> j) & 1;
+    }
+  }
+}
+
+void BytesToBitVector(const uint8_t* src, size_t count,
+                      std::vector<bool>& data) {
+  data.resize(count);
+  auto it = data.begin();
+  for (size_t i = 0; i < count; ++i, ++it) {
+    *it = src[i] != 0;
+  }
+}
+
+// Element count of the list at the read offset, packed is set for the bit
+// packed form. The bytes of the elements are range checked.
+int ReadListHeader(BufView& buf, bool& packed) {
+  uint32_t header = buf.ReadInt();
+  packed = header & kPackedFlag;
+  int count = header & ~kPackedFlag;
+  size_t size = packed ? PackedSize(count) : count;
+  if (DINGO_UNLIKELY(size > buf.RestReadableSize())) {
+    throw std::out_of_range("Out of range.");
+  }
+  return count;
+}
+
+}  // namespace
+
 int DingoSchema<std::vector<bool>>::GetLengthForKey() {
   throw std::runtime_error("bool list unsupport length");
   return -1;
@@ -35,32 +132,63 @@ int DingoSchema<std::vector<bool>>::GetLengthForValue() {
   return -1;
 }
 
-int DingoSchema<std::vector<bool>>::SkipKey(Buf&) {
+int DingoSchema<std::vector<bool>>::SkipKey(BufView&) {
   throw std::runtime_error("Unsupport encoding key list type");
   return -1;
 }
 
-int DingoSchema<std::vector<bool>>::SkipValue(Buf& buf) {
-  const int32_t size = buf.ReadInt();
+int DingoSchema<std::vector<bool>>::SkipValue(BufView& buf) {
+  bool packed;
+  const int count = ReadListHeader(buf, packed);
+  const int size = packed ? PackedSize(count) : count;
   buf.Skip(size);
 
   return size + 4;
 }
 
+int DingoSchema<std::vector<bool>>::GetEncodedKeySize(
+    const std::vector<bool>*) {
+  throw std::runtime_error("Unsupport encoding key list type");
+  return -1;
+}
+
+int DingoSchema<std::vector<bool>>::GetEncodedValueSize(
+    const std::vector<bool>* data) {
+  if (data == nullptr) {
+    return 0;
+  }
+
+  return data->size() + 4;
+}
+
+int DingoSchema<std::vector<bool>>::GetEncodedPackedValueSize(
+    const std::vector<bool>* data) {
+  if (data == nullptr) {
+    return 0;
+  }
+
+  return PackedSize(data->size()) + 4;
+}
+
+int DingoSchema<std::vector<bool>>::EncodeKey(const std::vector<bool>*, Buf&) {
+  throw std::runtime_error("Unsupport encoding key list type");
+  return -1;
+}
+
 int DingoSchema<std::vector<bool>>::EncodeKey(const std::any&, Buf&) {
   throw std::runtime_error("Unsupport encoding key list type");
   return -1;
 }
 
 // {n:4byte} | {value: 1byte}*n
-int DingoSchema<std::vector<bool>>::EncodeValue(const std::any& data,
-                                                Buf& buf) {
-  if (DINGO_UNLIKELY(!AllowNull() && !data.has_value())) {
+int DingoSchema<std::vector<bool>>::EncodeValue(
+    const std::vector<bool>* data, Buf& buf) {
+  if (DINGO_UNLIKELY(!AllowNull() && data == nullptr)) {
     throw std::runtime_error("Not allow null, but no value in data.");
   }
 
-  if (DINGO_LIKELY(data.has_value())) {
-    const auto& ref_data = std::any_cast<const std::vector<bool>&>(data);
+  if (DINGO_LIKELY(data != nullptr)) {
+    const auto& ref_data = *data;
 
     // if (!ref_data.empty()) {
     buf.WriteInt(ref_data.size());
@@ -75,17 +203,82 @@ int DingoSchema<std::vector<bool>>::EncodeValue(const std::any& data,
   return 0;
 }
 
-std::any DingoSchema<std::vector<bool>>::DecodeKey(Buf&) {
+// {n | 0x80000000:4byte} | {8 values: 1byte}*((n + 7) / 8), value i at bit
+// i % 8 of byte i / 8.
+int DingoSchema<std::vector<bool>>::EncodePackedValue(
+    const std::vector<bool>* data, Buf& buf) {
+  if (DINGO_UNLIKELY(!AllowNull() && data == nullptr)) {
+    throw std::runtime_error("Not allow null, but no value in data.");
+  }
+
+  if (DINGO_LIKELY(data != nullptr)) {
+    buf.WriteInt(data->size() | kPackedFlag);
+    size_t pos = buf.Size();
+    int size = PackedSize(data->size());
+    buf.Enlarge(size);
+    PackBitVector(*data,
+                  reinterpret_cast<uint8_t*>(buf.MutableData() + pos));
+
+    return size + 4;
+  }
+
+  return 0;
+}
+
+int DingoSchema<std::vector<bool>>::EncodeValue(
+    const std::any& data, Buf& buf) {
+  return EncodeValue(AnyDataPtr<std::vector<bool>>(data), buf);
+}
+
+bool DingoSchema<std::vector<bool>>::DecodeKey(BufView&, std::vector<bool>&) {
+  throw std::runtime_error("Unsupport decoding key list type");
+}
+
+std::any DingoSchema<std::vector<bool>>::DecodeKey(BufView&) {
   throw std::runtime_error("Unsupport decoding key list type");
 }
 
-std::any DingoSchema<std::vector<bool>>::DecodeValue(Buf& buf) {
-  int size = buf.ReadInt();
+void DingoSchema<std::vector<bool>>::DecodeValue(
+    BufView& buf, std::vector<bool>& data) {
+  bool packed;
+  const int count = ReadListHeader(buf, packed);
+  const auto* src =
+      reinterpret_cast<const uint8_t*>(buf.Data() + buf.ReadOffset());
 
-  std::vector<bool> data(size, false);
-  for (int i = 0; i < size; ++i) {
-    data[i] = buf.Read();
+  if (packed) {
+    UnpackBitVector(src, count, data);
+    buf.Skip(PackedSize(count));
+  } else {
+    BytesToBitVector(src, count, data);
+    buf.Skip(count);
   }
+}
+
+int DingoSchema<std::vector<bool>>::DecodeBitmap(
+    BufView& buf, std::vector<uint8_t>& bitmap) {
+  bool packed;
+  const int count = ReadListHeader(buf, packed);
+  const auto* src =
+      reinterpret_cast<const uint8_t*>(buf.Data() + buf.ReadOffset());
+
+  bitmap.resize(PackedSize(count));
+  if (packed) {
+    if (count > 0) {
+      memcpy(bitmap.data(), src, bitmap.size());
+      MaskTail(bitmap.data(), count);
+    }
+    buf.Skip(bitmap.size());
+  } else {
+    PackBytes(src, count, bitmap.data());
+    buf.Skip(count);
+  }
+
+  return count;
+}
+
+std::any DingoSchema<std::vector<bool>>::DecodeValue(BufView& buf) {
+  std::vector<bool> data;
+  DecodeValue(buf, data);
 
   return std::move(std::any(std::move(data)));
 }
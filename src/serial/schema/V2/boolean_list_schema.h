@@ -15,6 +15,7 @@
 #ifndef DINGO_SERIAL_BOOLEAN_LIST_SCHEMA_V2_H_
 #define DINGO_SERIAL_BOOLEAN_LIST_SCHEMA_V2_H_
 
+#include <cstdint>
 #include <memory>
 #include <vector>
 
@@ -24,7 +25,7 @@ namespace dingodb {
 namespace serialV2 {
 
 template <>
-class DingoSchema<std::vector<bool>> : public BaseSchema {
+class DingoSchema<std::vector<bool>> final : public BaseSchema {
  public:
   Type GetType() override { return kBoolList; }
   int GetLengthForKey() override;
@@ -34,14 +35,35 @@ class DingoSchema<std::vector<bool>> : public BaseSchema {
     return std::make_shared<DingoSchema<std::vector<bool>>>();
   }
 
-  int SkipKey(Buf& buf) override;
-  int SkipValue(Buf& buf) override;
+  int SkipKey(BufView& buf) override;
+  int SkipValue(BufView& buf) override;
 
   int EncodeKey(const std::any& data, Buf& buf) override;
   int EncodeValue(const std::any& data, Buf& buf) override;
 
-  std::any DecodeKey(Buf& buf) override;
-  std::any DecodeValue(Buf& buf) override;
+  std::any DecodeKey(BufView& buf) override;
+  std::any DecodeValue(BufView& buf) override;
+
+  // Typed entry points, a null data pointer encodes null. The decoders
+  // overwrite data. List columns are never part of a key.
+  int EncodeKey(const std::vector<bool>* data, Buf& buf);
+  int EncodeValue(const std::vector<bool>* data, Buf& buf);
+  bool DecodeKey(BufView& buf, std::vector<bool>& data);
+  void DecodeValue(BufView& buf, std::vector<bool>& data);
+
+  // Exact number of bytes EncodeKey / EncodeValue write for data.
+  int GetEncodedKeySize(const std::vector<bool>* data);
+  int GetEncodedValueSize(const std::vector<bool>* data);
+
+  // Bit packed form, 8 values per byte. The top bit of the count marks it,
+  // so DecodeValue and SkipValue read both forms. Only written for V3 rows,
+  // see RecordEncoderV2::SetPackedBoolList.
+  int EncodePackedValue(const std::vector<bool>* data, Buf& buf);
+  int GetEncodedPackedValueSize(const std::vector<bool>* data);
+
+  // Decode the list into bitmap, value i at bit i % 8 of byte i / 8, and
+  // return its length. Either form is accepted.
+  int DecodeBitmap(BufView& buf, std::vector<uint8_t>& bitmap);
 };
 
 }  // namespace serialV2
@@ -54,51 +54,34 @@ inline int DingoSchema<bool>::GetLengthForKey() {
 
 inline int DingoSchema<bool>::GetLengthForValue() { return kDataLength; }
 
-int DingoSchema<bool>::SkipKey(Buf& buf) {
+int DingoSchema<bool>::SkipKey(BufView& buf) {
   int len = GetLengthForKey();
   buf.Skip(len);
   return len;
 }
 
-int DingoSchema<bool>::SkipValue(Buf& buf) {
+int DingoSchema<bool>::SkipValue(BufView& buf) {
   buf.Skip(kDataLength);
   return kDataLength;
 }
 
-inline int DingoSchema<bool>::Encode(const std::any& data, Buf& buf,
-                                     bool forKey) {
-  if (DINGO_UNLIKELY(!AllowNull() && !data.has_value())) {
-    throw std::runtime_error("Not allow null, but data not has value.");
-  }
-
-  if (data.has_value()) {
-    const auto& ref_data = std::any_cast<const bool&>(data);
-    if (forKey) {
-      buf.Write(k_not_null);
-    }
-    buf.Write(ref_data ? 0x1 : 0x0);
-  } else {
-    if (forKey) {
-      buf.Write(k_null);
-      buf.Write(0x0);
-    } else {
-      return 0;  // null will not be encoded in value.
-    }
-  }
+int DingoSchema<bool>::GetEncodedKeySize(const bool* /*data*/) {
+  return GetLengthForKey();
+}
 
-  return forKey ? GetLengthForKey() : kDataLength;
+int DingoSchema<bool>::GetEncodedValueSize(const bool* data) {
+  return data != nullptr ? kDataLength : 0;
 }
 
-int DingoSchema<bool>::EncodeKey(const std::any& data, Buf& buf) {
-  if (DINGO_UNLIKELY(!AllowNull() && !data.has_value())) {
+int DingoSchema<bool>::EncodeKey(const bool* data, Buf& buf) {
+  if (DINGO_UNLIKELY(!AllowNull() && data == nullptr)) {
     throw std::runtime_error("Not allow null, but data not has value.");
   }
 
   if (AllowNull()) {
-    if (data.has_value()) {
+    if (data != nullptr) {
       buf.Write(k_not_null);
-      const auto& ref_data = std::any_cast<const bool&>(data);
-      buf.Write(ref_data ? 0x1 : 0x0);
+      buf.Write(*data ? 0x1 : 0x0);
     } else {
       buf.Write(k_null);
       buf.Write(0x0);
@@ -106,30 +89,62 @@ int DingoSchema<bool>::EncodeKey(const std::any& data, Buf& buf) {
 
     return kDataLengthWithNull;
   } else {
-    const auto& ref_data = std::any_cast<const bool&>(data);
-    buf.Write(ref_data ? 0x1 : 0x0);
+    buf.Write(*data ? 0x1 : 0x0);
 
     return kDataLength;
   }
 }
 
-int DingoSchema<bool>::EncodeValue(const std::any& data, Buf& buf) {
-  return Encode(data, buf, false);
+int DingoSchema<bool>::EncodeValue(const bool* data, Buf& buf) {
+  if (DINGO_UNLIKELY(!AllowNull() && data == nullptr)) {
+    throw std::runtime_error("Not allow null, but data not has value.");
+  }
+
+  if (data != nullptr) {
+    buf.Write(*data ? 0x1 : 0x0);
+    return kDataLength;
+  }
+
+  return 0;  // null will not be encoded in value.
 }
 
-std::any DingoSchema<bool>::DecodeKey(Buf& buf) {
+bool DingoSchema<bool>::DecodeKey(BufView& buf, bool& data) {
   if (AllowNull()) {
     if (buf.Read() == k_null) {
       buf.Skip(kDataLength);  // The null flag has already been read.
-      return std::any();
+      return false;
     }
   }
 
-  return std::any(static_cast<bool>(buf.Read()));
+  data = static_cast<bool>(buf.Read());
+  return true;
+}
+
+void DingoSchema<bool>::DecodeValue(BufView& buf, bool& data) {
+  data = static_cast<bool>(buf.Read());
+}
+
+int DingoSchema<bool>::EncodeKey(const std::any& data, Buf& buf) {
+  return EncodeKey(AnyDataPtr<bool>(data), buf);
+}
+
+int DingoSchema<bool>::EncodeValue(const std::any& data, Buf& buf) {
+  return EncodeValue(AnyDataPtr<bool>(data), buf);
+}
+
+std::any DingoSchema<bool>::DecodeKey(BufView& buf) {
+  bool data;
+  if (!DecodeKey(buf, data)) {
+    return std::any();
+  }
+
+  return std::any(data);
 }
 
-std::any DingoSchema<bool>::DecodeValue(Buf& buf) {
-  return std::any(static_cast<bool>(buf.Read()));
+std::any DingoSchema<bool>::DecodeValue(BufView& buf) {
+  bool data;
+  DecodeValue(buf, data);
+  return std::any(data);
 }
 
 }  // namespace serialV2
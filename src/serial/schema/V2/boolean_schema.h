@@ -21,7 +21,7 @@ namespace dingodb {
 namespace serialV2 {
 
 template <>
-class DingoSchema<bool> : public BaseSchema {
+class DingoSchema<bool> final : public BaseSchema {
  public:
   Type GetType() override { return kBool; }
   int GetLengthForKey() override;
@@ -31,17 +31,25 @@ class DingoSchema<bool> : public BaseSchema {
     return std::make_shared<DingoSchema<bool>>();
   }
 
-  int SkipKey(Buf& buf) override;
-  int SkipValue(Buf& buf) override;
+  int SkipKey(BufView& buf) override;
+  int SkipValue(BufView& buf) override;
 
   int EncodeKey(const std::any& data, Buf& buf) override;
   int EncodeValue(const std::any& data, Buf& buf) override;
 
-  std::any DecodeKey(Buf& buf) override;
-  std::any DecodeValue(Buf& buf) override;
+  std::any DecodeKey(BufView& buf) override;
+  std::any DecodeValue(BufView& buf) override;
 
- private:
-  int Encode(const std::any& data, Buf& buf, bool nullFlag);
+  // Typed entry points, a null data pointer encodes null. The decoders
+  // overwrite data, DecodeKey returns false for a null column.
+  int EncodeKey(const bool* data, Buf& buf);
+  int EncodeValue(const bool* data, Buf& buf);
+  bool DecodeKey(BufView& buf, bool& data);
+  void DecodeValue(BufView& buf, bool& data);
+
+  // Exact number of bytes EncodeKey / EncodeValue write for data.
+  int GetEncodedKeySize(const bool* data);
+  int GetEncodedValueSize(const bool* data);
 };
 
 }  // namespace serialV2
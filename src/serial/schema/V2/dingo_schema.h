@@ -29,14 +29,14 @@ class DingoSchema : public BaseSchema {
  public:
   BaseSchemaPtr Clone() override { return nullptr; }
 
-  int SkipKey(Buf& /*buf*/) override { return 0; }
-  int SkipValue(Buf& /*buf*/) override { return 0; }
+  int SkipKey(BufView& /*buf*/) override { return 0; }
+  int SkipValue(BufView& /*buf*/) override { return 0; }
 
   int EncodeKey(const std::any& /*data*/, Buf& /*buf*/) override { return 0; }
   int EncodeValue(const std::any& /*data*/, Buf& /*buf*/) override { return 0; }
 
-  std::any DecodeKey(Buf& buf /*NOLINT*/) override { return std::any(); }
-  std::any DecodeValue(Buf& buf /*NOLINT*/) override { return std::any(); }
+  std::any DecodeKey(BufView& buf /*NOLINT*/) override { return std::any(); }
+  std::any DecodeValue(BufView& buf /*NOLINT*/) override { return std::any(); }
 };
 
 }  // namespace serialV2
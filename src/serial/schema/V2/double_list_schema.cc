@@ -29,77 +29,21 @@ void DingoSchema<std::vector<double>>::EncodeDoubleList(
     const std::vector<double>& data, Buf& buf) {
   buf.WriteInt(data.size());
 
-  if (IsLe()) {
-    for (const double& value : data) {
-      uint64_t bits;
-      memcpy(&bits, &value, 8);
-      buf.Write(bits >> 56);
-      buf.Write(bits >> 48);
-      buf.Write(bits >> 40);
-      buf.Write(bits >> 32);
-      buf.Write(bits >> 24);
-      buf.Write(bits >> 16);
-      buf.Write(bits >> 8);
-      buf.Write(bits);
-    }
+  if (DINGO_LIKELY(IsLe())) {
+    buf.WriteWireArray<true>(data.data(), data.size());
   } else {
-    for (const double& value : data) {
-      uint64_t bits;
-      memcpy(&bits, &value, 8);
-      buf.Write(bits);
-      buf.Write(bits >> 8);
-      buf.Write(bits >> 16);
-      buf.Write(bits >> 24);
-      buf.Write(bits >> 32);
-      buf.Write(bits >> 40);
-      buf.Write(bits >> 48);
-      buf.Write(bits >> 56);
-    }
+    buf.WriteWireArray<false>(data.data(), data.size());
   }
 }
 
 void DingoSchema<std::vector<double>>::DecodeDoubleList(
-    Buf& buf, std::vector<double>& data) {
-  const int size = buf.ReadInt();
-  data.resize(size);
-
-  if (IsLe()) {
-    for (int i = 0; i < size; ++i) {
-      uint64_t l = 0;
-      l |= (static_cast<uint64_t>(buf.Read()) & 0xFF);
-      l <<= 8;
-      l |= (static_cast<uint64_t>(buf.Read()) & 0xFF);
-      l <<= 8;
-      l |= (static_cast<uint64_t>(buf.Read()) & 0xFF);
-      l <<= 8;
-      l |= (static_cast<uint64_t>(buf.Read()) & 0xFF);
-      l <<= 8;
-      l |= (static_cast<uint64_t>(buf.Read()) & 0xFF);
-      l <<= 8;
-      l |= (static_cast<uint64_t>(buf.Read()) & 0xFF);
-      l <<= 8;
-      l |= (static_cast<uint64_t>(buf.Read()) & 0xFF);
-      l <<= 8;
-      l |= (static_cast<uint64_t>(buf.Read()) & 0xFF);
-
-      void* v = &l;
-      data[i] = *reinterpret_cast<double*>(v);
-    }
+    BufView& buf, std::vector<double>& data) {
+  int size = buf.ReadInt();
+
+  if (DINGO_LIKELY(IsLe())) {
+    buf.ReadWireArray<true>(data, size);
   } else {
-    for (int i = 0; i < size; ++i) {
-      uint64_t l = 0;
-      l |= ((static_cast<uint64_t>(buf.Read()) & 0xFF) << (8 * 0));
-      l |= ((static_cast<uint64_t>(buf.Read()) & 0xFF) << (8 * 1));
-      l |= ((static_cast<uint64_t>(buf.Read()) & 0xFF) << (8 * 2));
-      l |= ((static_cast<uint64_t>(buf.Read()) & 0xFF) << (8 * 3));
-      l |= ((static_cast<uint64_t>(buf.Read()) & 0xFF) << (8 * 4));
-      l |= ((static_cast<uint64_t>(buf.Read()) & 0xFF) << (8 * 5));
-      l |= ((static_cast<uint64_t>(buf.Read()) & 0xFF) << (8 * 6));
-      l |= ((static_cast<uint64_t>(buf.Read()) & 0xFF) << (8 * 7));
-
-      void* v = &l;
-      data[i] = *reinterpret_cast<double*>(v);
-    }
+    buf.ReadWireArray<false>(data, size);
   }
 }
 
@@ -113,32 +57,53 @@ int DingoSchema<std::vector<double>>::GetLengthForValue() {
   return -1;
 }
 
-int DingoSchema<std::vector<double>>::SkipKey(Buf&) {
+int DingoSchema<std::vector<double>>::SkipKey(BufView&) {
   throw std::runtime_error("Unsupport encoding key list type");
   return -1;
 }
 
-int DingoSchema<std::vector<double>>::SkipValue(Buf& buf) {
+int DingoSchema<std::vector<double>>::SkipValue(BufView& buf) {
   int size = buf.ReadInt() * 8;
   buf.Skip(size);
 
   return size + 4;
 }
 
+int DingoSchema<std::vector<double>>::GetEncodedKeySize(
+    const std::vector<double>*) {
+  throw std::runtime_error("Unsupport encoding key list type");
+  return -1;
+}
+
+int DingoSchema<std::vector<double>>::GetEncodedValueSize(
+    const std::vector<double>* data) {
+  if (data == nullptr) {
+    return 0;
+  }
+
+  return data->size() * 8 + 4;
+}
+
+int DingoSchema<std::vector<double>>::EncodeKey(
+    const std::vector<double>*, Buf&) {
+  throw std::runtime_error("Unsupport encoding key list type");
+  return -1;
+}
+
 int DingoSchema<std::vector<double>>::EncodeKey(const std::any&, Buf&) {
   throw std::runtime_error("Unsupport encoding key list type");
   return -1;
 }
 
 // {n:4byte}|{value: 8byte}*n
-int DingoSchema<std::vector<double>>::EncodeValue(const std::any& data,
-                                                  Buf& buf) {
-  if (DINGO_UNLIKELY(!AllowNull() && !data.has_value())) {
+int DingoSchema<std::vector<double>>::EncodeValue(
+    const std::vector<double>* data, Buf& buf) {
+  if (DINGO_UNLIKELY(!AllowNull() && data == nullptr)) {
     throw std::runtime_error("Not allow null, but data not has value.");
   }
 
-  if (data.has_value()) {
-    const auto& ref_data = std::any_cast<const std::vector<double>&>(data);
+  if (data != nullptr) {
+    const auto& ref_data = *data;
 
     EncodeDoubleList(ref_data, buf);
     return ref_data.size() * 8 + 4;
@@ -147,13 +112,28 @@ int DingoSchema<std::vector<double>>::EncodeValue(const std::any& data,
   return 0;
 }
 
-std::any DingoSchema<std::vector<double>>::DecodeKey(Buf&) {
+int DingoSchema<std::vector<double>>::EncodeValue(
+    const std::any& data, Buf& buf) {
+  return EncodeValue(AnyDataPtr<std::vector<double>>(data), buf);
+}
+
+bool DingoSchema<std::vector<double>>::DecodeKey(
+    BufView&, std::vector<double>&) {
   throw std::runtime_error("Unsupport encoding key list type");
 }
 
-std::any DingoSchema<std::vector<double>>::DecodeValue(Buf& buf) {
-  std::vector<double> data;
+std::any DingoSchema<std::vector<double>>::DecodeKey(BufView&) {
+  throw std::runtime_error("Unsupport encoding key list type");
+}
+
+void DingoSchema<std::vector<double>>::DecodeValue(
+    BufView& buf, std::vector<double>& data) {
   DecodeDoubleList(buf, data);
+}
+
+std::any DingoSchema<std::vector<double>>::DecodeValue(BufView& buf) {
+  std::vector<double> data;
+  DecodeValue(buf, data);
 
   return std::move(std::any(std::move(data)));
 }
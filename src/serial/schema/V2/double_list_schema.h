@@ -24,7 +24,7 @@ namespace dingodb {
 namespace serialV2 {
 
 template <>
-class DingoSchema<std::vector<double>> : public BaseSchema {
+class DingoSchema<std::vector<double>> final : public BaseSchema {
  public:
   Type GetType() override { return kDoubleList; }
   int GetLengthForKey() override;
@@ -34,18 +34,29 @@ class DingoSchema<std::vector<double>> : public BaseSchema {
     return std::make_shared<DingoSchema<std::vector<double>>>();
   }
 
-  int SkipKey(Buf& buf) override;
-  int SkipValue(Buf& buf) override;
+  int SkipKey(BufView& buf) override;
+  int SkipValue(BufView& buf) override;
 
   int EncodeKey(const std::any& data, Buf& buf) override;
   int EncodeValue(const std::any& data, Buf& buf) override;
 
-  std::any DecodeKey(Buf& buf) override;
-  std::any DecodeValue(Buf& buf) override;
+  std::any DecodeKey(BufView& buf) override;
+  std::any DecodeValue(BufView& buf) override;
+
+  // Typed entry points, a null data pointer encodes null. The decoders
+  // overwrite data. List columns are never part of a key.
+  int EncodeKey(const std::vector<double>* data, Buf& buf);
+  int EncodeValue(const std::vector<double>* data, Buf& buf);
+  bool DecodeKey(BufView& buf, std::vector<double>& data);
+  void DecodeValue(BufView& buf, std::vector<double>& data);
+
+  // Exact number of bytes EncodeKey / EncodeValue write for data.
+  int GetEncodedKeySize(const std::vector<double>* data);
+  int GetEncodedValueSize(const std::vector<double>* data);
 
  private:
   void EncodeDoubleList(const std::vector<double>& data, Buf& buf);
-  void DecodeDoubleList(Buf& buf, std::vector<double>& data);
+  void DecodeDoubleList(BufView& buf, std::vector<double>& data);
 };
 
 }  // namespace serialV2
@@ -20,6 +20,7 @@
 #include <stdexcept>
 #include <utility>
 
+#include "serial/utils/V2/byte_order.h"
 #include "serial/utils/V2/compiler.h"
 
 namespace dingodb {
@@ -28,122 +29,68 @@ namespace serialV2 {
 constexpr int kDataLength = 8;
 constexpr int kDataLengthWithNull = kDataLength + 1;
 
-void DingoSchema<double>::EncodeDoubleComparable(double data, Buf& buf) {
+// Codecs with the byte order resolved at compile time, the members below pick
+// one by the le flag FormatSchema set when the encoder or decoder was built.
+// Comparable doubles flip the sign bit of positive values and every bit of
+// negative ones, so they sort as unsigned bytes.
+template <bool kLe>
+static inline void EncodeComparable(double data, Buf& buf) {
   uint64_t bits;
   memcpy(&bits, &data, 8);
-
-  if (IsLe() && data >= 0) {
-    buf.Write(bits >> 56 ^ 0x80);
-    buf.Write(bits >> 48);
-    buf.Write(bits >> 40);
-    buf.Write(bits >> 32);
-    buf.Write(bits >> 24);
-    buf.Write(bits >> 16);
-    buf.Write(bits >> 8);
-    buf.Write(bits);
-  } else if (IsLe() && data < 0) {
-    buf.Write(~bits >> 56);
-    buf.Write(~bits >> 48);
-    buf.Write(~bits >> 40);
-    buf.Write(~bits >> 32);
-    buf.Write(~bits >> 24);
-    buf.Write(~bits >> 16);
-    buf.Write(~bits >> 8);
-    buf.Write(~bits);
-  } else if (!IsLe() && data >= 0) {
-    buf.Write(bits ^ 0x80);
-    buf.Write(bits >> 8);
-    buf.Write(bits >> 16);
-    buf.Write(bits >> 24);
-    buf.Write(bits >> 32);
-    buf.Write(bits >> 40);
-    buf.Write(bits >> 48);
-    buf.Write(bits >> 56);
-  } else {
-    buf.Write(~bits);
-    buf.Write(~bits >> 8);
-    buf.Write(~bits >> 16);
-    buf.Write(~bits >> 24);
-    buf.Write(~bits >> 32);
-    buf.Write(~bits >> 40);
-    buf.Write(~bits >> 48);
-    buf.Write(~bits >> 56);
-  }
+  bits = data >= 0 ? bits ^ WireSignBit<kLe, uint64_t>() : ~bits;
+  buf.WriteWire<kLe, uint64_t>(bits);
 }
 
-double DingoSchema<double>::DecodeDoubleComparable(Buf& buf) {
-  uint64_t l = buf.Read() & 0xFF;
-  if (IsLe()) {
-    if (l >= 0x80) {
-      l = l ^ 0x80;
-      for (int i = 0; i < 7; ++i) {
-        l <<= 8;
-        l |= buf.Read() & 0xFF;
-      }
-    } else {
-      l = ~l;
-      for (int i = 0; i < 7; ++i) {
-        l <<= 8;
-        l |= ~buf.Read() & 0xFF;
-      }
-    }
-  } else {
-    if (l >= 0x80) {
-      l = l ^ 0x80;
-      for (int i = 1; i < 8; ++i) {
-        l |= (((uint64_t)buf.Read() & 0xFF) << (8 * i));
-      }
-    } else {
-      for (int i = 1; i < 8; ++i) {
-        l |= (((uint64_t)buf.Read() & 0xFF) << (8 * i));
-      }
-      l = ~l;
-    }
-  }
-
-  void* v = &l;
-  return *reinterpret_cast<double*>(v);
+template <bool kLe>
+static inline double DecodeComparable(BufView& buf) {
+  uint64_t bits = buf.ReadWire<kLe, uint64_t>();
+  // The flipped sign bit is set for positive values.
+  bits = (bits & WireSignBit<kLe, uint64_t>()) ? bits ^ WireSignBit<kLe, uint64_t>()
+                                          : ~bits;
+  double data;
+  memcpy(&data, &bits, 8);
+  return data;
 }
 
-void DingoSchema<double>::EncodeDoubleNotComparable(double data, Buf& buf) {
+template <bool kLe>
+static inline void EncodeNotComparable(double data, Buf& buf) {
   uint64_t bits;
   memcpy(&bits, &data, 8);
-  if (IsLe()) {
-    buf.Write(bits >> 56);
-    buf.Write(bits >> 48);
-    buf.Write(bits >> 40);
-    buf.Write(bits >> 32);
-    buf.Write(bits >> 24);
-    buf.Write(bits >> 16);
-    buf.Write(bits >> 8);
-    buf.Write(bits);
+  buf.WriteWire<kLe, uint64_t>(bits);
+}
+
+template <bool kLe>
+static inline double DecodeNotComparable(BufView& buf) {
+  uint64_t bits = buf.ReadWire<kLe, uint64_t>();
+  double data;
+  memcpy(&data, &bits, 8);
+  return data;
+}
+
+void DingoSchema<double>::EncodeDoubleComparable(double data, Buf& buf) {
+  if (DINGO_LIKELY(IsLe())) {
+    EncodeComparable<true>(data, buf);
   } else {
-    buf.Write(bits);
-    buf.Write(bits >> 8);
-    buf.Write(bits >> 16);
-    buf.Write(bits >> 24);
-    buf.Write(bits >> 32);
-    buf.Write(bits >> 40);
-    buf.Write(bits >> 48);
-    buf.Write(bits >> 56);
+    EncodeComparable<false>(data, buf);
   }
 }
 
-double DingoSchema<double>::DecodeDoubleNotComparable(Buf& buf) {
-  uint64_t data = buf.Read() & 0xFF;
-  if (IsLe()) {
-    for (int i = 0; i < 7; ++i) {
-      data <<= 8;
-      data |= buf.Read() & 0xFF;
-    }
+double DingoSchema<double>::DecodeDoubleComparable(BufView& buf) {
+  return DINGO_LIKELY(IsLe()) ? DecodeComparable<true>(buf)
+                              : DecodeComparable<false>(buf);
+}
+
+void DingoSchema<double>::EncodeDoubleNotComparable(double data, Buf& buf) {
+  if (DINGO_LIKELY(IsLe())) {
+    EncodeNotComparable<true>(data, buf);
   } else {
-    for (int i = 1; i < 8; ++i) {
-      data |= (((uint64_t)buf.Read() & 0xFF) << (8 * i));
-    }
+    EncodeNotComparable<false>(data, buf);
   }
+}
 
-  void* v = &data;
-  return *reinterpret_cast<double*>(v);
+double DingoSchema<double>::DecodeDoubleNotComparable(BufView& buf) {
+  return DINGO_LIKELY(IsLe()) ? DecodeNotComparable<true>(buf)
+                              : DecodeNotComparable<false>(buf);
 }
 
 inline int DingoSchema<double>::GetLengthForKey() {
@@ -156,68 +103,97 @@ inline int DingoSchema<double>::GetLengthForKey() {
 
 int DingoSchema<double>::GetLengthForValue() { return kDataLength; }
 
-int DingoSchema<double>::SkipKey(Buf& buf) {
+int DingoSchema<double>::SkipKey(BufView& buf) {
   int len = GetLengthForKey();
   buf.Skip(len);
   return len;
 }
 
-int DingoSchema<double>::SkipValue(Buf& buf) {
+int DingoSchema<double>::SkipValue(BufView& buf) {
   buf.Skip(kDataLength);
   return kDataLength;
 }
 
 // {is_null: 1byte}|{value: 8byte}
-int DingoSchema<double>::EncodeKey(const std::any& data, Buf& buf) {
-  if (DINGO_UNLIKELY(!AllowNull() && !data.has_value())) {
+int DingoSchema<double>::GetEncodedKeySize(const double* /*data*/) {
+  return GetLengthForKey();
+}
+
+int DingoSchema<double>::GetEncodedValueSize(const double* data) {
+  return data != nullptr ? kDataLength : 0;
+}
+
+int DingoSchema<double>::EncodeKey(const double* data, Buf& buf) {
+  if (DINGO_UNLIKELY(!AllowNull() && data == nullptr)) {
     throw std::runtime_error("Not allow null, but data not has value.");
   }
 
   if (AllowNull()) {
-    if (data.has_value()) {
+    if (data != nullptr) {
       buf.Write(k_not_null);
-      const auto& ref_data = std::any_cast<const double&>(data);
-      EncodeDoubleComparable(ref_data, buf);
+      EncodeDoubleComparable(*data, buf);
     } else {
       buf.Write(k_null);
       buf.WriteLong(0);
     }
+
     return kDataLengthWithNull;
   } else {
-    const auto& ref_data = std::any_cast<const double&>(data);
-    EncodeDoubleComparable(ref_data, buf);
+    EncodeDoubleComparable(*data, buf);
+
     return kDataLength;
   }
 }
 
 // {value: 8byte}
-int DingoSchema<double>::EncodeValue(const std::any& data, Buf& buf) {
-  if (DINGO_UNLIKELY(!AllowNull() && !data.has_value())) {
+int DingoSchema<double>::EncodeValue(const double* data, Buf& buf) {
+  if (DINGO_UNLIKELY(!AllowNull() && data == nullptr)) {
     throw std::runtime_error("Not allow null, but data not has value.");
   }
 
-  if (data.has_value()) {
-    const auto& ref_data = std::any_cast<const double&>(data);
-    EncodeDoubleNotComparable(ref_data, buf);
+  if (data != nullptr) {
+    EncodeDoubleNotComparable(*data, buf);
     return kDataLength;
   }
 
   return 0;
 }
 
-std::any DingoSchema<double>::DecodeKey(Buf& buf) {
+bool DingoSchema<double>::DecodeKey(BufView& buf, double& data) {
   if (AllowNull()) {
     if (buf.Read() == k_null) {
       buf.Skip(kDataLength);
-      return std::any();
+      return false;
     }
   }
 
-  return std::move(std::any(DecodeDoubleComparable(buf)));
+  data = DecodeDoubleComparable(buf);
+  return true;
+}
+
+void DingoSchema<double>::DecodeValue(BufView& buf, double& data) {
+  data = DecodeDoubleNotComparable(buf);
+}
+
+int DingoSchema<double>::EncodeKey(const std::any& data, Buf& buf) {
+  return EncodeKey(AnyDataPtr<double>(data), buf);
+}
+
+int DingoSchema<double>::EncodeValue(const std::any& data, Buf& buf) {
+  return EncodeValue(AnyDataPtr<double>(data), buf);
+}
+
+std::any DingoSchema<double>::DecodeKey(BufView& buf) {
+  double data;
+  if (!DecodeKey(buf, data)) {
+    return std::any();
+  }
+
+  return std::any(data);
 }
 
-inline std::any DingoSchema<double>::DecodeValue(Buf& buf) {
-  return std::move(std::any(DecodeDoubleNotComparable(buf)));
+std::any DingoSchema<double>::DecodeValue(BufView& buf) {
+  return std::any(DecodeDoubleNotComparable(buf));
 }
 
 }  // namespace serialV2
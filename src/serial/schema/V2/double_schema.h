@@ -21,7 +21,7 @@ namespace dingodb {
 namespace serialV2 {
 
 template <>
-class DingoSchema<double> : public BaseSchema {
+class DingoSchema<double> final : public BaseSchema {
  public:
   Type GetType() override { return kDouble; }
   int GetLengthForKey() override;
@@ -31,21 +31,32 @@ class DingoSchema<double> : public BaseSchema {
     return std::make_shared<DingoSchema<double>>();
   }
 
-  int SkipKey(Buf& buf) override;
-  int SkipValue(Buf& buf) override;
+  int SkipKey(BufView& buf) override;
+  int SkipValue(BufView& buf) override;
 
   int EncodeKey(const std::any& data, Buf& buf) override;
   int EncodeValue(const std::any& data, Buf& buf) override;
 
-  std::any DecodeKey(Buf& buf) override;
-  std::any DecodeValue(Buf& buf) override;
+  std::any DecodeKey(BufView& buf) override;
+  std::any DecodeValue(BufView& buf) override;
+
+  // Typed entry points, a null data pointer encodes null. The decoders
+  // overwrite data, DecodeKey returns false for a null column.
+  int EncodeKey(const double* data, Buf& buf);
+  int EncodeValue(const double* data, Buf& buf);
+  bool DecodeKey(BufView& buf, double& data);
+  void DecodeValue(BufView& buf, double& data);
+
+  // Exact number of bytes EncodeKey / EncodeValue write for data.
+  int GetEncodedKeySize(const double* data);
+  int GetEncodedValueSize(const double* data);
 
  private:
   void EncodeDoubleComparable(double data, Buf& buf);
-  double DecodeDoubleComparable(Buf& buf);
+  double DecodeDoubleComparable(BufView& buf);
 
   void EncodeDoubleNotComparable(double data, Buf& buf);
-  double DecodeDoubleNotComparable(Buf& buf);
+  double DecodeDoubleNotComparable(BufView& buf);
 };
 
 }  // namespace serialV2
@@ -28,57 +28,20 @@ void DingoSchema<std::vector<float>>::EncodeFloatList(
   buf.WriteInt(data.size());
 
   if (DINGO_LIKELY(IsLe())) {
-    for (const float& value : data) {
-      uint32_t bits;
-      memcpy(&bits, &value, 4);
-      buf.Write(bits >> 24);
-      buf.Write(bits >> 16);
-      buf.Write(bits >> 8);
-      buf.Write(bits);
-    }
-
+    buf.WriteWireArray<true>(data.data(), data.size());
   } else {
-    for (const float& value : data) {
-      uint32_t bits;
-      memcpy(&bits, &value, 4);
-      buf.Write(bits);
-      buf.Write(bits >> 8);
-      buf.Write(bits >> 16);
-      buf.Write(bits >> 24);
-    }
+    buf.WriteWireArray<false>(data.data(), data.size());
   }
 }
 
 void DingoSchema<std::vector<float>>::DecodeFloatList(
-    Buf& buf, std::vector<float>& data) {
+    BufView& buf, std::vector<float>& data) {
   int size = buf.ReadInt();
-  data.resize(size);
 
   if (DINGO_LIKELY(IsLe())) {
-    for (int i = 0; i < size; ++i) {
-      uint32_t l = 0;
-      l |= (static_cast<uint32_t>(buf.Read()) & 0xFF);
-      l <<= 8;
-      l |= (static_cast<uint32_t>(buf.Read()) & 0xFF);
-      l <<= 8;
-      l |= (static_cast<uint32_t>(buf.Read()) & 0xFF);
-      l <<= 8;
-      l |= (static_cast<uint32_t>(buf.Read()) & 0xFF);
-
-      void* v = &l;
-      data[i] = *reinterpret_cast<float*>(v);
-    }
+    buf.ReadWireArray<true>(data, size);
   } else {
-    for (int i = 0; i < size; ++i) {
-      uint32_t l = 0;
-      l |= ((static_cast<uint32_t>(buf.Read()) & 0xFF) << (8 * 0));
-      l |= ((static_cast<uint32_t>(buf.Read()) & 0xFF) << (8 * 1));
-      l |= ((static_cast<uint32_t>(buf.Read()) & 0xFF) << (8 * 2));
-      l |= ((static_cast<uint32_t>(buf.Read()) & 0xFF) << (8 * 3));
-
-      void* v = &l;
-      data[i] = *reinterpret_cast<float*>(v);
-    }
+    buf.ReadWireArray<false>(data, size);
   }
 }
 
@@ -92,32 +55,53 @@ int DingoSchema<std::vector<float>>::GetLengthForValue() {
   return -1;
 }
 
-int DingoSchema<std::vector<float>>::SkipKey(Buf&) {
+int DingoSchema<std::vector<float>>::SkipKey(BufView&) {
   throw std::runtime_error("Unsupport encoding key list type");
   return -1;
 }
 
-int DingoSchema<std::vector<float>>::SkipValue(Buf& buf) {
+int DingoSchema<std::vector<float>>::SkipValue(BufView& buf) {
   int size = buf.ReadInt() * 4;
   buf.Skip(size);
 
   return size + 4;
 }
 
+int DingoSchema<std::vector<float>>::GetEncodedKeySize(
+    const std::vector<float>*) {
+  throw std::runtime_error("Unsupport encoding key list type");
+  return -1;
+}
+
+int DingoSchema<std::vector<float>>::GetEncodedValueSize(
+    const std::vector<float>* data) {
+  if (data == nullptr) {
+    return 0;
+  }
+
+  return data->size() * 4 + 4;
+}
+
+int DingoSchema<std::vector<float>>::EncodeKey(
+    const std::vector<float>*, Buf&) {
+  throw std::runtime_error("Unsupport encoding key list type");
+  return -1;
+}
+
 int DingoSchema<std::vector<float>>::EncodeKey(const std::any&, Buf&) {
   throw std::runtime_error("Unsupport encoding key list type");
   return -1;
 }
 
 // {n:4byte}|{value: 4byte}*n
-int DingoSchema<std::vector<float>>::EncodeValue(const std::any& data,
-                                                 Buf& buf) {
-  if (DINGO_UNLIKELY(!AllowNull() && !data.has_value())) {
+int DingoSchema<std::vector<float>>::EncodeValue(
+    const std::vector<float>* data, Buf& buf) {
+  if (DINGO_UNLIKELY(!AllowNull() && data == nullptr)) {
     throw std::runtime_error("Not allow null, but data not has value.");
   }
 
-  if (data.has_value()) {
-    const auto& ref_data = std::any_cast<const std::vector<float>&>(data);
+  if (data != nullptr) {
+    const auto& ref_data = *data;
 
     // if (!ref_data.empty()) {
     EncodeFloatList(ref_data, buf);
@@ -128,13 +112,27 @@ int DingoSchema<std::vector<float>>::EncodeValue(const std::any& data,
   return 0;
 }
 
-std::any DingoSchema<std::vector<float>>::DecodeKey(Buf&) {
+int DingoSchema<std::vector<float>>::EncodeValue(
+    const std::any& data, Buf& buf) {
+  return EncodeValue(AnyDataPtr<std::vector<float>>(data), buf);
+}
+
+bool DingoSchema<std::vector<float>>::DecodeKey(BufView&, std::vector<float>&) {
   throw std::runtime_error("Unsupport encoding key list type");
 }
 
-std::any DingoSchema<std::vector<float>>::DecodeValue(Buf& buf) {
-  std::vector<float> data;
+std::any DingoSchema<std::vector<float>>::DecodeKey(BufView&) {
+  throw std::runtime_error("Unsupport encoding key list type");
+}
+
+void DingoSchema<std::vector<float>>::DecodeValue(
+    BufView& buf, std::vector<float>& data) {
   DecodeFloatList(buf, data);
+}
+
+std::any DingoSchema<std::vector<float>>::DecodeValue(BufView& buf) {
+  std::vector<float> data;
+  DecodeValue(buf, data);
 
   return std::move(std::any(std::move(data)));
 }
@@ -24,7 +24,7 @@ namespace dingodb {
 namespace serialV2 {
 
 template <>
-class DingoSchema<std::vector<float>> : public BaseSchema {
+class DingoSchema<std::vector<float>> final : public BaseSchema {
  public:
   Type GetType() override { return kFloatList; }
   int GetLengthForKey() override;
@@ -34,18 +34,29 @@ class DingoSchema<std::vector<float>> : public BaseSchema {
     return std::make_shared<DingoSchema<std::vector<float>>>();
   }
 
-  int SkipKey(Buf& buf) override;
-  int SkipValue(Buf& buf) override;
+  int SkipKey(BufView& buf) override;
+  int SkipValue(BufView& buf) override;
 
   int EncodeKey(const std::any& data, Buf& buf) override;
   int EncodeValue(const std::any& data, Buf& buf) override;
 
-  std::any DecodeKey(Buf& buf) override;
-  std::any DecodeValue(Buf& buf) override;
+  std::any DecodeKey(BufView& buf) override;
+  std::any DecodeValue(BufView& buf) override;
+
+  // Typed entry points, a null data pointer encodes null. The decoders
+  // overwrite data. List columns are never part of a key.
+  int EncodeKey(const std::vector<float>* data, Buf& buf);
+  int EncodeValue(const std::vector<float>* data, Buf& buf);
+  bool DecodeKey(BufView& buf, std::vector<float>& data);
+  void DecodeValue(BufView& buf, std::vector<float>& data);
+
+  // Exact number of bytes EncodeKey / EncodeValue write for data.
+  int GetEncodedKeySize(const std::vector<float>* data);
+  int GetEncodedValueSize(const std::vector<float>* data);
 
  private:
   void EncodeFloatList(const std::vector<float>& data, Buf& buf);
-  void DecodeFloatList(Buf& buf, std::vector<float>& data);
+  void DecodeFloatList(BufView& buf, std::vector<float>& data);
 };
 
 }  // namespace serialV2
@@ -18,6 +18,7 @@
 #include <cstring>
 #include <stdexcept>
 
+#include "serial/utils/V2/byte_order.h"
 #include "serial/utils/V2/compiler.h"
 
 namespace dingodb {
@@ -26,97 +27,68 @@ namespace serialV2 {
 constexpr int kDataLength = 4;
 constexpr int kDataLengthWithNull = kDataLength + 1;
 
-void DingoSchema<float>::EncodeFloatComparable(float data, Buf& buf) {
+// Codecs with the byte order resolved at compile time, the members below pick
+// one by the le flag FormatSchema set when the encoder or decoder was built.
+// Comparable floats flip the sign bit of positive values and every bit of
+// negative ones, so they sort as unsigned bytes.
+template <bool kLe>
+static inline void EncodeComparable(float data, Buf& buf) {
   uint32_t bits;
   memcpy(&bits, &data, 4);
-  if (DINGO_LIKELY(IsLe() && data >= 0)) {
-    buf.Write(bits >> 24 ^ 0x80);
-    buf.Write(bits >> 16);
-    buf.Write(bits >> 8);
-    buf.Write(bits);
-  } else if (IsLe() && data < 0) {
-    buf.Write(~bits >> 24);
-    buf.Write(~bits >> 16);
-    buf.Write(~bits >> 8);
-    buf.Write(~bits);
-  } else if (!IsLe() && data >= 0) {
-    buf.Write(bits ^ 0x80);
-    buf.Write(bits >> 8);
-    buf.Write(bits >> 16);
-    buf.Write(bits >> 24);
-  } else {
-    buf.Write(~bits);
-    buf.Write(~bits >> 8);
-    buf.Write(~bits >> 16);
-    buf.Write(~bits >> 24);
-  }
+  bits = data >= 0 ? bits ^ WireSignBit<kLe, uint32_t>() : ~bits;
+  buf.WriteWire<kLe, uint32_t>(bits);
 }
 
-float DingoSchema<float>::DecodeFloatComparable(Buf& buf) {
-  uint32_t in = buf.Read() & 0xFF;
-  if (DINGO_LIKELY(IsLe())) {
-    if (in >= 0x80) {
-      in = in ^ 0x80;
-      for (int i = 0; i < 3; i++) {
-        in <<= 8;
-        in |= buf.Read() & 0xFF;
-      }
-    } else {
-      in = ~in;
-      for (int i = 0; i < 3; i++) {
-        in <<= 8;
-        in |= ~buf.Read() & 0xFF;
-      }
-    }
-  } else {
-    if (in >= 0x80) {
-      in = in ^ 0x80;
-      for (int i = 1; i < 4; i++) {
-        in |= (((uint32_t)buf.Read() & 0xFF) << (8 * i));
-      }
-    } else {
-      for (int i = 1; i < 4; i++) {
-        in |= (((uint32_t)buf.Read() & 0xFF) << (8 * i));
-      }
-      in = ~in;
-    }
-  }
-
-  void* v = &in;
-  return *reinterpret_cast<float*>(v);
+template <bool kLe>
+static inline float DecodeComparable(BufView& buf) {
+  uint32_t bits = buf.ReadWire<kLe, uint32_t>();
+  // The flipped sign bit is set for positive values.
+  bits = (bits & WireSignBit<kLe, uint32_t>()) ? bits ^ WireSignBit<kLe, uint32_t>()
+                                          : ~bits;
+  float data;
+  memcpy(&data, &bits, 4);
+  return data;
 }
 
-void DingoSchema<float>::EncodeFloatNotComparable(float data, Buf& buf) {
+template <bool kLe>
+static inline void EncodeNotComparable(float data, Buf& buf) {
   uint32_t bits;
   memcpy(&bits, &data, 4);
-  if (IsLe()) {
-    buf.Write(bits >> 24);
-    buf.Write(bits >> 16);
-    buf.Write(bits >> 8);
-    buf.Write(bits);
+  buf.WriteWire<kLe, uint32_t>(bits);
+}
+
+template <bool kLe>
+static inline float DecodeNotComparable(BufView& buf) {
+  uint32_t bits = buf.ReadWire<kLe, uint32_t>();
+  float data;
+  memcpy(&data, &bits, 4);
+  return data;
+}
+
+void DingoSchema<float>::EncodeFloatComparable(float data, Buf& buf) {
+  if (DINGO_LIKELY(IsLe())) {
+    EncodeComparable<true>(data, buf);
   } else {
-    buf.Write(bits);
-    buf.Write(bits >> 8);
-    buf.Write(bits >> 16);
-    buf.Write(bits >> 24);
+    EncodeComparable<false>(data, buf);
   }
 }
-float DingoSchema<float>::DecodeFloatNotComparable(Buf& buf) {
-  uint32_t in = buf.Read() & 0xFF;
 
+float DingoSchema<float>::DecodeFloatComparable(BufView& buf) {
+  return DINGO_LIKELY(IsLe()) ? DecodeComparable<true>(buf)
+                              : DecodeComparable<false>(buf);
+}
+
+void DingoSchema<float>::EncodeFloatNotComparable(float data, Buf& buf) {
   if (DINGO_LIKELY(IsLe())) {
-    for (int i = 0; i < 3; i++) {
-      in <<= 8;
-      in |= buf.Read() & 0xFF;
-    }
+    EncodeNotComparable<true>(data, buf);
   } else {
-    for (int i = 1; i < 4; i++) {
-      in |= (((uint32_t)buf.Read() & 0xFF) << (8 * i));
-    }
+    EncodeNotComparable<false>(data, buf);
   }
+}
 
-  void* v = &in;
-  return *reinterpret_cast<float*>(v);
+float DingoSchema<float>::DecodeFloatNotComparable(BufView& buf) {
+  return DINGO_LIKELY(IsLe()) ? DecodeNotComparable<true>(buf)
+                              : DecodeNotComparable<false>(buf);
 }
 
 int DingoSchema<float>::GetLengthForKey() {
@@ -130,68 +102,96 @@ int DingoSchema<float>::GetLengthForKey() {
 
 int DingoSchema<float>::GetLengthForValue() { return kDataLength; }
 
-int DingoSchema<float>::SkipKey(Buf& buf) {
+int DingoSchema<float>::SkipKey(BufView& buf) {
   int len = GetLengthForKey();
   buf.Skip(len);
   return len;
 }
 
-int DingoSchema<float>::SkipValue(Buf& buf) {
+int DingoSchema<float>::SkipValue(BufView& buf) {
   buf.Skip(kDataLength);
   return kDataLength;
 }
 
-int DingoSchema<float>::EncodeKey(const std::any& data, Buf& buf) {
-  if (DINGO_UNLIKELY(!AllowNull() && !data.has_value())) {
+int DingoSchema<float>::GetEncodedKeySize(const float* /*data*/) {
+  return GetLengthForKey();
+}
+
+int DingoSchema<float>::GetEncodedValueSize(const float* data) {
+  return data != nullptr ? kDataLength : 0;
+}
+
+int DingoSchema<float>::EncodeKey(const float* data, Buf& buf) {
+  if (DINGO_UNLIKELY(!AllowNull() && data == nullptr)) {
     throw std::runtime_error("Not allow null, but data not has value.");
   }
 
-  if(AllowNull()) {
-    if (data.has_value()) {
+  if (AllowNull()) {
+    if (data != nullptr) {
       buf.Write(k_not_null);
-      const auto& ref_data = std::any_cast<const float&>(data);
-      EncodeFloatComparable(ref_data, buf);
+      EncodeFloatComparable(*data, buf);
     } else {
       buf.Write(k_null);
       buf.WriteInt(0);
     }
+
     return kDataLengthWithNull;
-  }
-  else {
-    const auto& ref_data = std::any_cast<const float&>(data);
-    EncodeFloatComparable(ref_data, buf);
+  } else {
+    EncodeFloatComparable(*data, buf);
+
     return kDataLength;
   }
 }
 
 // {value: 4byte}
-int DingoSchema<float>::EncodeValue(const std::any& data, Buf& buf) {
-  if (DINGO_UNLIKELY(!AllowNull() && !data.has_value())) {
+int DingoSchema<float>::EncodeValue(const float* data, Buf& buf) {
+  if (DINGO_UNLIKELY(!AllowNull() && data == nullptr)) {
     throw std::runtime_error("Not allow null, but data not has value.");
   }
 
-  if (data.has_value()) {
-    const auto& ref_data = std::any_cast<const float&>(data);
-    EncodeFloatNotComparable(ref_data, buf);
+  if (data != nullptr) {
+    EncodeFloatNotComparable(*data, buf);
     return kDataLength;
   }
 
   return 0;
 }
 
-std::any DingoSchema<float>::DecodeKey(Buf& buf) {
-  if(AllowNull()) {
+bool DingoSchema<float>::DecodeKey(BufView& buf, float& data) {
+  if (AllowNull()) {
     if (buf.Read() == k_null) {
       buf.Skip(kDataLength);
-      return std::any();
+      return false;
     }
   }
 
-  return std::move(std::any(DecodeFloatComparable(buf)));
+  data = DecodeFloatComparable(buf);
+  return true;
+}
+
+void DingoSchema<float>::DecodeValue(BufView& buf, float& data) {
+  data = DecodeFloatNotComparable(buf);
+}
+
+int DingoSchema<float>::EncodeKey(const std::any& data, Buf& buf) {
+  return EncodeKey(AnyDataPtr<float>(data), buf);
+}
+
+int DingoSchema<float>::EncodeValue(const std::any& data, Buf& buf) {
+  return EncodeValue(AnyDataPtr<float>(data), buf);
+}
+
+std::any DingoSchema<float>::DecodeKey(BufView& buf) {
+  float data;
+  if (!DecodeKey(buf, data)) {
+    return std::any();
+  }
+
+  return std::any(data);
 }
 
-inline std::any DingoSchema<float>::DecodeValue(Buf& buf) {
-  return std::move(std::any(DecodeFloatNotComparable(buf)));
+std::any DingoSchema<float>::DecodeValue(BufView& buf) {
+  return std::any(DecodeFloatNotComparable(buf));
 }
 
 }  // namespace V2
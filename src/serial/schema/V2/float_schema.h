@@ -21,7 +21,7 @@ namespace dingodb {
 namespace serialV2 {
 
 template <>
-class DingoSchema<float> : public BaseSchema {
+class DingoSchema<float> final : public BaseSchema {
  public:
   Type GetType() override { return kFloat; }
   int GetLengthForKey() override;
@@ -31,21 +31,32 @@ class DingoSchema<float> : public BaseSchema {
     return std::make_shared<DingoSchema<float>>();
   }
 
-  int SkipKey(Buf& buf) override;
-  int SkipValue(Buf& buf) override;
+  int SkipKey(BufView& buf) override;
+  int SkipValue(BufView& buf) override;
 
   int EncodeKey(const std::any& data, Buf& buf) override;
   int EncodeValue(const std::any& data, Buf& buf) override;
 
-  std::any DecodeKey(Buf& buf) override;
-  std::any DecodeValue(Buf& buf) override;
+  std::any DecodeKey(BufView& buf) override;
+  std::any DecodeValue(BufView& buf) override;
+
+  // Typed entry points, a null data pointer encodes null. The decoders
+  // overwrite data, DecodeKey returns false for a null column.
+  int EncodeKey(const float* data, Buf& buf);
+  int EncodeValue(const float* data, Buf& buf);
+  bool DecodeKey(BufView& buf, float& data);
+  void DecodeValue(BufView& buf, float& data);
+
+  // Exact number of bytes EncodeKey / EncodeValue write for data.
+  int GetEncodedKeySize(const float* data);
+  int GetEncodedValueSize(const float* data);
 
  private:
   void EncodeFloatComparable(float data, Buf& buf);
-  float DecodeFloatComparable(Buf& buf);
+  float DecodeFloatComparable(BufView& buf);
 
   void EncodeFloatNotComparable(float data, Buf& buf);
-  float DecodeFloatNotComparable(Buf& buf);
+  float DecodeFloatNotComparable(BufView& buf);
 };
 
 }  // namespace V2
@@ -18,6 +18,7 @@
 #include <utility>
 
 #include "serial/utils/V2/compiler.h"
+#include "serial/utils/V2/int_list.h"
 
 namespace dingodb {
 namespace serialV2 {
@@ -27,48 +28,12 @@ constexpr int kDataLengthForKey = kDataLengthForValue + 1;
 
 void DingoSchema<std::vector<int32_t>>::EncodeIntList(
     const std::vector<int32_t>& data, Buf& buf) {
-  buf.WriteInt(data.size());
-
-  if (DINGO_LIKELY(IsLe())) {
-    for (const int32_t& value : data) {
-      uint32_t* v = (uint32_t*)&value;
-      buf.Write(*v >> 24);
-      buf.Write(*v >> 16);
-      buf.Write(*v >> 8);
-      buf.Write(*v);
-    }
-  } else {
-    for (const int32_t& value : data) {
-      uint32_t* v = (uint32_t*)&value;
-      buf.Write(*v);
-      buf.Write(*v >> 8);
-      buf.Write(*v >> 16);
-      buf.Write(*v >> 24);
-    }
-  }
+  EncodeRawList(data, IsLe(), buf);
 }
 
 void DingoSchema<std::vector<int32_t>>::DecodeIntList(
-    Buf& buf, std::vector<int32_t>& data) {
-  int size = buf.ReadInt();
-  data.resize(size);
-
-  if (DINGO_LIKELY(IsLe())) {
-    for (int i = 0; i < size; ++i) {
-      uint32_t value = ((buf.Read() & 0xFF) << 24) |
-                       ((buf.Read() & 0xFF) << 16) |
-                       ((buf.Read() & 0xFF) << 8) | (buf.Read() & 0xFF);
-      data[i] = static_cast<int32_t>(value);
-    }
-
-  } else {
-    for (int i = 0; i < size; ++i) {
-      uint32_t value = (buf.Read() & 0xFF) | ((buf.Read() & 0xFF) << 8) |
-                       ((buf.Read() & 0xFF) << 16) |
-                       ((buf.Read() & 0xFF) << 24);
-      data[i] = static_cast<int32_t>(value);
-    }
-  }
+    BufView& buf, std::vector<int32_t>& data) {
+  DecodeList(buf, IsLe(), data);
 }
 
 int DingoSchema<std::vector<int32_t>>::GetLengthForKey() {
@@ -81,16 +46,34 @@ int DingoSchema<std::vector<int32_t>>::GetLengthForValue() {
   return -1;
 }
 
-int DingoSchema<std::vector<int32_t>>::SkipKey(Buf&) {
+int DingoSchema<std::vector<int32_t>>::SkipKey(BufView&) {
   throw std::runtime_error("Unsupport encoding key list type");
   return -1;
 }
 
-int DingoSchema<std::vector<int32_t>>::SkipValue(Buf& buf) {
-  int32_t size = buf.ReadInt() * 4;
-  buf.Skip(size);
+int DingoSchema<std::vector<int32_t>>::SkipValue(BufView& buf) {
+  return SkipList<int32_t>(buf);
+}
+
+int DingoSchema<std::vector<int32_t>>::GetEncodedKeySize(
+    const std::vector<int32_t>*) {
+  throw std::runtime_error("Unsupport encoding key list type");
+  return -1;
+}
 
-  return size + 4;
+int DingoSchema<std::vector<int32_t>>::GetEncodedValueSize(
+    const std::vector<int32_t>* data) {
+  if (data == nullptr) {
+    return 0;
+  }
+
+  return EncodedRawListSize(*data);
+}
+
+int DingoSchema<std::vector<int32_t>>::EncodeKey(
+    const std::vector<int32_t>*, Buf&) {
+  throw std::runtime_error("Unsupport encoding key list type");
+  return -1;
 }
 
 int DingoSchema<std::vector<int32_t>>::EncodeKey(const std::any&, Buf&) {
@@ -99,14 +82,14 @@ int DingoSchema<std::vector<int32_t>>::EncodeKey(const std::any&, Buf&) {
 }
 
 // {n:4byte}|{value: 4byte}*n
-int DingoSchema<std::vector<int32_t>>::EncodeValue(const std::any& data,
-                                                   Buf& buf) {
-  if (DINGO_UNLIKELY(!AllowNull() && !data.has_value())) {
+int DingoSchema<std::vector<int32_t>>::EncodeValue(
+    const std::vector<int32_t>* data, Buf& buf) {
+  if (DINGO_UNLIKELY(!AllowNull() && data == nullptr)) {
     throw std::runtime_error("Not allow null, but no data in value.");
   }
 
-  if (data.has_value()) {
-    const auto& ref_data = std::any_cast<const std::vector<int32_t>&>(data);
+  if (data != nullptr) {
+    const auto& ref_data = *data;
 
     EncodeIntList(ref_data, buf);
     return ref_data.size() * 4 + 4;
@@ -115,13 +98,82 @@ int DingoSchema<std::vector<int32_t>>::EncodeValue(const std::any& data,
   return 0;
 }
 
-std::any DingoSchema<std::vector<int32_t>>::DecodeKey(Buf&) {
+int DingoSchema<std::vector<int32_t>>::EncodeValue(
+    const std::any& data, Buf& buf) {
+  return EncodeValue(AnyDataPtr<std::vector<int32_t>>(data), buf);
+}
+
+int DingoSchema<std::vector<int32_t>>::EncodeCompactValue(
+    const std::vector<int32_t>* data, Buf& buf) {
+  if (DINGO_UNLIKELY(!AllowNull() && data == nullptr)) {
+    throw std::runtime_error("Not allow null, but no data in value.");
+  }
+
+  if (data != nullptr) {
+    return EncodeCompactList(*data, buf);
+  }
+
+  return 0;
+}
+
+int DingoSchema<std::vector<int32_t>>::GetEncodedCompactValueSize(
+    const std::vector<int32_t>* data) {
+  if (data == nullptr) {
+    return 0;
+  }
+
+  return EncodedCompactListSize(*data);
+}
+
+void DingoSchema<std::vector<int32_t>>::DecodeCompactValue(
+    BufView& buf, std::vector<int32_t>& data) {
+  DecodeCompactList(buf, data);
+}
+
+int DingoSchema<std::vector<int32_t>>::EncodeDeltaValue(
+    const std::vector<int32_t>* data, Buf& buf) {
+  if (DINGO_UNLIKELY(!AllowNull() && data == nullptr)) {
+    throw std::runtime_error("Not allow null, but no data in value.");
+  }
+
+  if (data != nullptr) {
+    return EncodeDeltaList(*data, IsLe(), buf);
+  }
+
+  return 0;
+}
+
+int DingoSchema<std::vector<int32_t>>::GetEncodedDeltaValueSize(
+    const std::vector<int32_t>* data) {
+  if (data == nullptr) {
+    return 0;
+  }
+
+  return EncodedDeltaListSize(*data);
+}
+
+void DingoSchema<std::vector<int32_t>>::DecodeValue(
+    BufView& buf, DeltaListReader<int32_t>& reader) {
+  DecodeList(buf, IsLe(), reader);
+}
+
+bool DingoSchema<std::vector<int32_t>>::DecodeKey(
+    BufView&, std::vector<int32_t>&) {
   throw std::runtime_error("Unsupport encoding key list type");
 }
 
-std::any DingoSchema<std::vector<int32_t>>::DecodeValue(Buf& buf) {
-  std::vector<int32_t> data;
+std::any DingoSchema<std::vector<int32_t>>::DecodeKey(BufView&) {
+  throw std::runtime_error("Unsupport encoding key list type");
+}
+
+void DingoSchema<std::vector<int32_t>>::DecodeValue(
+    BufView& buf, std::vector<int32_t>& data) {
   DecodeIntList(buf, data);
+}
+
+std::any DingoSchema<std::vector<int32_t>>::DecodeValue(BufView& buf) {
+  std::vector<int32_t> data;
+  DecodeValue(buf, data);
 
   return std::move(std::any(std::move(data)));
 }
@@ -19,12 +19,13 @@
 #include <vector>
 
 #include "dingo_schema.h"
+#include "serial/utils/V2/delta_pack.h"
 
 namespace dingodb {
 namespace serialV2 {
 
 template <>
-class DingoSchema<std::vector<int32_t>> : public BaseSchema {
+class DingoSchema<std::vector<int32_t>> final : public BaseSchema {
  public:
   Type GetType() override { return kIntegerList; }
   int GetLengthForKey() override;
@@ -34,18 +35,46 @@ class DingoSchema<std::vector<int32_t>> : public BaseSchema {
     return std::make_shared<DingoSchema<std::vector<int32_t>>>();
   }
 
-  int SkipKey(Buf& buf) override;
-  int SkipValue(Buf& buf) override;
+  int SkipKey(BufView& buf) override;
+  int SkipValue(BufView& buf) override;
 
   int EncodeKey(const std::any& data, Buf& buf) override;
   int EncodeValue(const std::any& data, Buf& buf) override;
 
-  std::any DecodeKey(Buf& buf) override;
-  std::any DecodeValue(Buf& buf) override;
+  std::any DecodeKey(BufView& buf) override;
+  std::any DecodeValue(BufView& buf) override;
+
+  // Typed entry points, a null data pointer encodes null. The decoders
+  // overwrite data. List columns are never part of a key.
+  int EncodeKey(const std::vector<int32_t>* data, Buf& buf);
+  int EncodeValue(const std::vector<int32_t>* data, Buf& buf);
+  bool DecodeKey(BufView& buf, std::vector<int32_t>& data);
+  void DecodeValue(BufView& buf, std::vector<int32_t>& data);
+
+  // Exact number of bytes EncodeKey / EncodeValue write for data.
+  int GetEncodedKeySize(const std::vector<int32_t>* data);
+  int GetEncodedValueSize(const std::vector<int32_t>* data);
+
+  // Compact value form, {n:4byte} | stream vbyte of the values, see
+  // varint.h. It is chosen per column by SetCompactValue and only written in
+  // V3 rows flagged VALUE_COMPACT.
+  int EncodeCompactValue(const std::vector<int32_t>* data, Buf& buf);
+  int GetEncodedCompactValueSize(const std::vector<int32_t>* data);
+  void DecodeCompactValue(BufView& buf, std::vector<int32_t>& data);
+
+  // Delta value form, {n | 0x80000000:4byte} | delta pack of the values,
+  // see delta_pack.h. It is chosen per column by SetDeltaValue, only written
+  // in V3 rows and only when smaller than the EncodeValue form, which is
+  // written instead. DecodeValue and SkipValue read both forms.
+  int EncodeDeltaValue(const std::vector<int32_t>* data, Buf& buf);
+  int GetEncodedDeltaValueSize(const std::vector<int32_t>* data);
+  // Point reader at the list of either form without decoding it, buf must
+  // outlive the reader.
+  void DecodeValue(BufView& buf, DeltaListReader<int32_t>& reader);
 
  private:
   void EncodeIntList(const std::vector<int32_t>& data, Buf& buf);
-  void DecodeIntList(Buf& buf, std::vector<int32_t>& data);
+  void DecodeIntList(BufView& buf, std::vector<int32_t>& data);
 };
 
 }  // namespace serialV2
@@ -18,7 +18,9 @@
 #include <cstdint>
 
 #include "serial/schema/dingo_schema.h"
+#include "serial/utils/V2/byte_order.h"
 #include "serial/utils/V2/compiler.h"
+#include "serial/utils/V2/varint.h"
 
 namespace dingodb {
 namespace serialV2 {
@@ -26,60 +28,43 @@ namespace serialV2 {
 constexpr int kDataLength = 4;
 constexpr int kLengthWithNull = kDataLength + 1;
 
-void DingoSchema<int32_t>::EncodeIntComparable(int32_t data, Buf& buf) {
-  uint32_t* i = (uint32_t*)&data;
-  if (DINGO_LIKELY(IsLe())) {
-    buf.Write(*i >> 24 ^ 0x80);
-    buf.Write(*i >> 16);
-    buf.Write(*i >> 8);
-    buf.Write(*i);
-  } else {
-    buf.Write(*i ^ 0x80);
-    buf.Write(*i >> 8);
-    buf.Write(*i >> 16);
-    buf.Write(*i >> 24);
-  }
+// Codecs with the byte order resolved at compile time, the members below pick
+// one by the le flag FormatSchema set when the encoder or decoder was built.
+// Comparable ints flip the sign bit so they sort as unsigned bytes.
+template <bool kLe>
+static inline void EncodeComparable(int32_t data, Buf& buf) {
+  buf.WriteWire<kLe, uint32_t>(data ^ WireSignBit<kLe, uint32_t>());
+}
+
+template <bool kLe>
+static inline int32_t DecodeComparable(BufView& buf) {
+  return buf.ReadWire<kLe, uint32_t>() ^ WireSignBit<kLe, uint32_t>();
 }
 
-int32_t DingoSchema<int32_t>::DecodeIntComparable(Buf& buf) {
-  uint32_t data;
+void DingoSchema<int32_t>::EncodeIntComparable(int32_t data, Buf& buf) {
   if (DINGO_LIKELY(IsLe())) {
-    data = (((buf.Read() & 0xFF) ^ 0x80) << 24) | ((buf.Read() & 0xFF) << 16) |
-           ((buf.Read() & 0xFF) << 8) | (buf.Read() & 0xFF);
+    EncodeComparable<true>(data, buf);
   } else {
-    data = ((buf.Read() & 0xFF) ^ 0x80) | ((buf.Read() & 0xFF) << 8) |
-           ((buf.Read() & 0xFF) << 16) | ((buf.Read() & 0xFF) << 24);
+    EncodeComparable<false>(data, buf);
   }
+}
 
-  return static_cast<int32_t>(data);
+int32_t DingoSchema<int32_t>::DecodeIntComparable(BufView& buf) {
+  return DINGO_LIKELY(IsLe()) ? DecodeComparable<true>(buf)
+                              : DecodeComparable<false>(buf);
 }
 
 void DingoSchema<int32_t>::EncodeIntNotComparable(int32_t data, Buf& buf) {
-  uint32_t* i = (uint32_t*)&data;
   if (DINGO_LIKELY(IsLe())) {
-    buf.Write(*i >> 24);
-    buf.Write(*i >> 16);
-    buf.Write(*i >> 8);
-    buf.Write(*i);
+    buf.WriteWire<true, uint32_t>(data);
   } else {
-    buf.Write(*i);
-    buf.Write(*i >> 8);
-    buf.Write(*i >> 16);
-    buf.Write(*i >> 24);
+    buf.WriteWire<false, uint32_t>(data);
   }
 }
 
-int32_t DingoSchema<int32_t>::DecodeIntNotComparable(Buf& buf) {
-  uint32_t data;
-  if (DINGO_LIKELY(IsLe())) {
-    data = ((buf.Read() & 0xFF) << 24) | ((buf.Read() & 0xFF) << 16) |
-           ((buf.Read() & 0xFF) << 8) | (buf.Read() & 0xFF);
-  } else {
-    data = (buf.Read() & 0xFF) | ((buf.Read() & 0xFF) << 8) |
-           ((buf.Read() & 0xFF) << 16) | ((buf.Read() & 0xFF) << 24);
-  }
-
-  return static_cast<int32_t>(data);
+int32_t DingoSchema<int32_t>::DecodeIntNotComparable(BufView& buf) {
+  return DINGO_LIKELY(IsLe()) ? buf.ReadWire<true, uint32_t>()
+                              : buf.ReadWire<false, uint32_t>();
 }
 
 inline int DingoSchema<int32_t>::GetLengthForKey() {
@@ -92,27 +77,34 @@ inline int DingoSchema<int32_t>::GetLengthForKey() {
 
 inline int DingoSchema<int32_t>::GetLengthForValue() { return kDataLength; }
 
-inline int DingoSchema<int32_t>::SkipKey(Buf& buf) {
+inline int DingoSchema<int32_t>::SkipKey(BufView& buf) {
   int len = GetLengthForKey();
   buf.Skip(len);
   return len;
 }
 
-inline int DingoSchema<int32_t>::SkipValue(Buf& buf) {
+inline int DingoSchema<int32_t>::SkipValue(BufView& buf) {
   buf.Skip(kDataLength);
   return kDataLength;
 }
 
-int DingoSchema<int32_t>::EncodeKey(const std::any& data, Buf& buf) {
-  if (DINGO_UNLIKELY(!AllowNull() && !data.has_value())) {
+int DingoSchema<int32_t>::GetEncodedKeySize(const int32_t* /*data*/) {
+  return GetLengthForKey();
+}
+
+int DingoSchema<int32_t>::GetEncodedValueSize(const int32_t* data) {
+  return data != nullptr ? kDataLength : 0;
+}
+
+int DingoSchema<int32_t>::EncodeKey(const int32_t* data, Buf& buf) {
+  if (DINGO_UNLIKELY(!AllowNull() && data == nullptr)) {
     throw std::runtime_error("Not allow null, but data not has value.");
   }
 
   if (AllowNull()) {
-    if (data.has_value()) {
+    if (data != nullptr) {
       buf.Write(k_not_null);
-      const auto& ref_data = std::any_cast<const int32_t&>(data);
-      EncodeIntComparable(ref_data, buf);
+      EncodeIntComparable(*data, buf);
     } else {
       buf.Write(k_null);
       buf.WriteInt(0x0);  // false.
@@ -120,40 +112,84 @@ int DingoSchema<int32_t>::EncodeKey(const std::any& data, Buf& buf) {
 
     return kLengthWithNull;
   } else {
-    const auto& ref_data = std::any_cast<const int32_t&>(data);
-    EncodeIntComparable(ref_data, buf);
+    EncodeIntComparable(*data, buf);
 
     return kDataLength;
   }
 }
 
 // {value: 4byte}
-int DingoSchema<int32_t>::EncodeValue(const std::any& data, Buf& buf) {
-  if (DINGO_UNLIKELY(!AllowNull() && !data.has_value())) {
+int DingoSchema<int32_t>::EncodeValue(const int32_t* data, Buf& buf) {
+  if (DINGO_UNLIKELY(!AllowNull() && data == nullptr)) {
     throw std::runtime_error("Not allow null, but data not has value.");
   }
 
-  if (data.has_value()) {
-    const auto& ref_data = std::any_cast<const int32_t&>(data);
-    EncodeIntNotComparable(ref_data, buf);
+  if (data != nullptr) {
+    EncodeIntNotComparable(*data, buf);
     return kDataLength;
   }
 
   return 0;
 }
 
-std::any DingoSchema<int32_t>::DecodeKey(Buf& buf) {
+bool DingoSchema<int32_t>::DecodeKey(BufView& buf, int32_t& data) {
   if (AllowNull()) {
     if (buf.Read() == k_null) {
       buf.Skip(kDataLength);
-      return std::any();
+      return false;
     }
   }
 
-  return std::any(DecodeIntComparable(buf));
+  data = DecodeIntComparable(buf);
+  return true;
+}
+
+void DingoSchema<int32_t>::DecodeValue(BufView& buf, int32_t& data) {
+  data = DecodeIntNotComparable(buf);
+}
+
+int DingoSchema<int32_t>::EncodeCompactValue(const int32_t* data, Buf& buf) {
+  if (DINGO_UNLIKELY(!AllowNull() && data == nullptr)) {
+    throw std::runtime_error("Not allow null, but data not has value.");
+  }
+
+  if (data != nullptr) {
+    return buf.WriteVarint(ZigZagEncode(*data));
+  }
+
+  return 0;
+}
+
+int DingoSchema<int32_t>::GetEncodedCompactValueSize(const int32_t* data) {
+  return data != nullptr ? VarintSize(ZigZagEncode(*data)) : 0;
+}
+
+void DingoSchema<int32_t>::DecodeCompactValue(BufView& buf, int32_t& data) {
+  uint64_t bits = buf.ReadVarint();
+  if (DINGO_UNLIKELY(bits > UINT32_MAX)) {
+    throw std::out_of_range("Out of range.");
+  }
+  data = ZigZagDecode(static_cast<uint32_t>(bits));
+}
+
+int DingoSchema<int32_t>::EncodeKey(const std::any& data, Buf& buf) {
+  return EncodeKey(AnyDataPtr<int32_t>(data), buf);
+}
+
+int DingoSchema<int32_t>::EncodeValue(const std::any& data, Buf& buf) {
+  return EncodeValue(AnyDataPtr<int32_t>(data), buf);
+}
+
+std::any DingoSchema<int32_t>::DecodeKey(BufView& buf) {
+  int32_t data;
+  if (!DecodeKey(buf, data)) {
+    return std::any();
+  }
+
+  return std::any(data);
 }
 
-inline std::any DingoSchema<int32_t>::DecodeValue(Buf& buf) {
+std::any DingoSchema<int32_t>::DecodeValue(BufView& buf) {
   return std::any(DecodeIntNotComparable(buf));
 }
 
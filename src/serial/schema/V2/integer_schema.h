@@ -23,7 +23,7 @@ namespace dingodb {
 namespace serialV2 {
 
 template <>
-class DingoSchema<int32_t> : public BaseSchema {
+class DingoSchema<int32_t> final : public BaseSchema {
  public:
   Type GetType() override { return kInteger; }
   int GetLengthForKey() override;
@@ -33,21 +33,38 @@ class DingoSchema<int32_t> : public BaseSchema {
     return std::make_shared<DingoSchema<int32_t>>();
   }
 
-  int SkipKey(Buf& buf) override;
-  int SkipValue(Buf& buf) override;
+  int SkipKey(BufView& buf) override;
+  int SkipValue(BufView& buf) override;
 
   int EncodeKey(const std::any& data, Buf& buf) override;
   int EncodeValue(const std::any& data, Buf& buf) override;
 
-  std::any DecodeKey(Buf& buf) override;
-  std::any DecodeValue(Buf& buf) override;
+  std::any DecodeKey(BufView& buf) override;
+  std::any DecodeValue(BufView& buf) override;
+
+  // Typed entry points, a null data pointer encodes null. The decoders
+  // overwrite data, DecodeKey returns false for a null column.
+  int EncodeKey(const int32_t* data, Buf& buf);
+  int EncodeValue(const int32_t* data, Buf& buf);
+  bool DecodeKey(BufView& buf, int32_t& data);
+  void DecodeValue(BufView& buf, int32_t& data);
+
+  // Exact number of bytes EncodeKey / EncodeValue write for data.
+  int GetEncodedKeySize(const int32_t* data);
+  int GetEncodedValueSize(const int32_t* data);
+
+  // Compact value form, the zigzag varint of data. It is chosen per column
+  // by SetCompactValue and only written in V3 rows flagged VALUE_COMPACT.
+  int EncodeCompactValue(const int32_t* data, Buf& buf);
+  int GetEncodedCompactValueSize(const int32_t* data);
+  void DecodeCompactValue(BufView& buf, int32_t& data);
 
  private:
   void EncodeIntComparable(int32_t data, Buf& buf);
-  int32_t DecodeIntComparable(Buf& buf);
+  int32_t DecodeIntComparable(BufView& buf);
 
   void EncodeIntNotComparable(int32_t data, Buf& buf);
-  int32_t DecodeIntNotComparable(Buf& buf);
+  int32_t DecodeIntNotComparable(BufView& buf);
 };
 
 }  // namespace serialV2
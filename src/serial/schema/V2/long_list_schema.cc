@@ -18,66 +18,19 @@
 #include <utility>
 
 #include "serial/utils/V2/compiler.h"
+#include "serial/utils/V2/int_list.h"
 
 namespace dingodb {
 namespace serialV2 {
 
 void DingoSchema<std::vector<int64_t>>::EncodeLongList(
     const std::vector<int64_t>& data, Buf& buf) {
-  buf.WriteInt(data.size());
-  if (DINGO_LIKELY(IsLe())) {
-    for (const int64_t& value : data) {
-      uint64_t* l = (uint64_t*)&value;
-      buf.Write(*l >> 56);
-      buf.Write(*l >> 48);
-      buf.Write(*l >> 40);
-      buf.Write(*l >> 32);
-      buf.Write(*l >> 24);
-      buf.Write(*l >> 16);
-      buf.Write(*l >> 8);
-      buf.Write(*l);
-    }
-  } else {
-    for (const int64_t& value : data) {
-      uint64_t* l = (uint64_t*)&value;
-      buf.Write(*l);
-      buf.Write(*l >> 8);
-      buf.Write(*l >> 16);
-      buf.Write(*l >> 24);
-      buf.Write(*l >> 32);
-      buf.Write(*l >> 40);
-      buf.Write(*l >> 48);
-      buf.Write(*l >> 56);
-    }
-  }
+  EncodeRawList(data, IsLe(), buf);
 }
 
 void DingoSchema<std::vector<int64_t>>::DecodeLongList(
-    Buf& buf, std::vector<int64_t>& data) const {
-  int size = buf.ReadInt();
-  data.resize(size);
-
-  if (DINGO_LIKELY(IsLe())) {
-    for (int i = 0; i < size; ++i) {
-      uint64_t value = buf.Read() & 0xFF;
-      for (int j = 0; j < 7; ++j) {
-        value <<= 8;
-        value |= buf.Read() & 0xFF;
-      }
-
-      data[i] = static_cast<int64_t>(value);
-    }
-  } else {
-    for (int i = 0; i < size; ++i) {
-      uint64_t value = buf.Read() & 0xFF;
-
-      for (int j = 1; j < 8; ++j) {
-        value |= (((uint64_t)buf.Read() & 0xFF) << (8 * j));
-      }
-
-      data[i] = static_cast<int64_t>(value);
-    }
-  }
+    BufView& buf, std::vector<int64_t>& data) const {
+  DecodeList(buf, IsLe(), data);
 }
 
 int DingoSchema<std::vector<int64_t>>::GetLengthForKey() {
@@ -90,16 +43,34 @@ int DingoSchema<std::vector<int64_t>>::GetLengthForValue() {
   return -1;
 }
 
-int DingoSchema<std::vector<int64_t>>::SkipKey(Buf&) {
+int DingoSchema<std::vector<int64_t>>::SkipKey(BufView&) {
   throw std::runtime_error("Unsupport encode key list type");
   return -1;
 }
 
-int DingoSchema<std::vector<int64_t>>::SkipValue(Buf& buf) {
-  int size = buf.ReadInt() * 8;
-  buf.Skip(size);
+int DingoSchema<std::vector<int64_t>>::SkipValue(BufView& buf) {
+  return SkipList<int64_t>(buf);
+}
+
+int DingoSchema<std::vector<int64_t>>::GetEncodedKeySize(
+    const std::vector<int64_t>*) {
+  throw std::runtime_error("Unsupport encode key list type");
+  return -1;
+}
 
-  return size + 4;
+int DingoSchema<std::vector<int64_t>>::GetEncodedValueSize(
+    const std::vector<int64_t>* data) {
+  if (data == nullptr) {
+    return 0;
+  }
+
+  return EncodedRawListSize(*data);
+}
+
+int DingoSchema<std::vector<int64_t>>::EncodeKey(
+    const std::vector<int64_t>*, Buf&) {
+  throw std::runtime_error("Unsupport encode key list type");
+  return -1;
 }
 
 int DingoSchema<std::vector<int64_t>>::EncodeKey(const std::any&, Buf&) {
@@ -108,14 +79,14 @@ int DingoSchema<std::vector<int64_t>>::EncodeKey(const std::any&, Buf&) {
 }
 
 // {n:4byte}|{value: 8byte}*n
-int DingoSchema<std::vector<int64_t>>::EncodeValue(const std::any& data,
-                                                   Buf& buf) {
-  if (DINGO_UNLIKELY(!AllowNull() && !data.has_value())) {
+int DingoSchema<std::vector<int64_t>>::EncodeValue(
+    const std::vector<int64_t>* data, Buf& buf) {
+  if (DINGO_UNLIKELY(!AllowNull() && data == nullptr)) {
     throw std::runtime_error("Not allow null, but no data in value.");
   }
 
-  if (data.has_value()) {
-    const auto& ref_data = std::any_cast<const std::vector<int64_t>&>(data);
+  if (data != nullptr) {
+    const auto& ref_data = *data;
 
     // if (!ref_data.empty()) {
     EncodeLongList(ref_data, buf);
@@ -127,13 +98,82 @@ int DingoSchema<std::vector<int64_t>>::EncodeValue(const std::any& data,
   return 0;
 }
 
-std::any DingoSchema<std::vector<int64_t>>::DecodeKey(Buf&) {
+int DingoSchema<std::vector<int64_t>>::EncodeValue(
+    const std::any& data, Buf& buf) {
+  return EncodeValue(AnyDataPtr<std::vector<int64_t>>(data), buf);
+}
+
+int DingoSchema<std::vector<int64_t>>::EncodeCompactValue(
+    const std::vector<int64_t>* data, Buf& buf) {
+  if (DINGO_UNLIKELY(!AllowNull() && data == nullptr)) {
+    throw std::runtime_error("Not allow null, but no data in value.");
+  }
+
+  if (data != nullptr) {
+    return EncodeCompactList(*data, buf);
+  }
+
+  return 0;
+}
+
+int DingoSchema<std::vector<int64_t>>::GetEncodedCompactValueSize(
+    const std::vector<int64_t>* data) {
+  if (data == nullptr) {
+    return 0;
+  }
+
+  return EncodedCompactListSize(*data);
+}
+
+void DingoSchema<std::vector<int64_t>>::DecodeCompactValue(
+    BufView& buf, std::vector<int64_t>& data) {
+  DecodeCompactList(buf, data);
+}
+
+int DingoSchema<std::vector<int64_t>>::EncodeDeltaValue(
+    const std::vector<int64_t>* data, Buf& buf) {
+  if (DINGO_UNLIKELY(!AllowNull() && data == nullptr)) {
+    throw std::runtime_error("Not allow null, but no data in value.");
+  }
+
+  if (data != nullptr) {
+    return EncodeDeltaList(*data, IsLe(), buf);
+  }
+
+  return 0;
+}
+
+int DingoSchema<std::vector<int64_t>>::GetEncodedDeltaValueSize(
+    const std::vector<int64_t>* data) {
+  if (data == nullptr) {
+    return 0;
+  }
+
+  return EncodedDeltaListSize(*data);
+}
+
+void DingoSchema<std::vector<int64_t>>::DecodeValue(
+    BufView& buf, DeltaListReader<int64_t>& reader) {
+  DecodeList(buf, IsLe(), reader);
+}
+
+bool DingoSchema<std::vector<int64_t>>::DecodeKey(
+    BufView&, std::vector<int64_t>&) {
   throw std::runtime_error("Unsupport encoding key list type");
 }
 
-std::any DingoSchema<std::vector<int64_t>>::DecodeValue(Buf& buf) {
-  std::vector<int64_t> data;
+std::any DingoSchema<std::vector<int64_t>>::DecodeKey(BufView&) {
+  throw std::runtime_error("Unsupport encoding key list type");
+}
+
+void DingoSchema<std::vector<int64_t>>::DecodeValue(
+    BufView& buf, std::vector<int64_t>& data) {
   DecodeLongList(buf, data);
+}
+
+std::any DingoSchema<std::vector<int64_t>>::DecodeValue(BufView& buf) {
+  std::vector<int64_t> data;
+  DecodeValue(buf, data);
 
   return std::move(std::any(std::move(data)));
 }
@@ -16,7 +16,9 @@
 
 #include <cstdint>
 
+#include "serial/utils/V2/byte_order.h"
 #include "serial/utils/V2/compiler.h"
+#include "serial/utils/V2/varint.h"
 
 namespace dingodb {
 namespace serialV2 {
@@ -24,82 +26,43 @@ namespace serialV2 {
 constexpr int kDataLength = 8;
 constexpr int kDataLengthWithNull = kDataLength + 1;
 
-void DingoSchema<int64_t>::EncodeLongComparable(int64_t data, Buf& buf) {
-  uint64_t* l = (uint64_t*)&data;
-  if (DINGO_LIKELY(IsLe())) {
-    buf.Write(*l >> 56 ^ 0x80);
-    buf.Write(*l >> 48);
-    buf.Write(*l >> 40);
-    buf.Write(*l >> 32);
-    buf.Write(*l >> 24);
-    buf.Write(*l >> 16);
-    buf.Write(*l >> 8);
-    buf.Write(*l);
-  } else {
-    buf.Write(*l ^ 0x80);
-    buf.Write(*l >> 8);
-    buf.Write(*l >> 16);
-    buf.Write(*l >> 24);
-    buf.Write(*l >> 32);
-    buf.Write(*l >> 40);
-    buf.Write(*l >> 48);
-    buf.Write(*l >> 56);
-  }
+// Codecs with the byte order resolved at compile time, the members below pick
+// one by the le flag FormatSchema set when the encoder or decoder was built.
+// Comparable longs flip the sign bit so they sort as unsigned bytes.
+template <bool kLe>
+static inline void EncodeComparable(int64_t data, Buf& buf) {
+  buf.WriteWire<kLe, uint64_t>(data ^ WireSignBit<kLe, uint64_t>());
+}
+
+template <bool kLe>
+static inline int64_t DecodeComparable(BufView& buf) {
+  return buf.ReadWire<kLe, uint64_t>() ^ WireSignBit<kLe, uint64_t>();
 }
 
-int64_t DingoSchema<int64_t>::DecodeLongComparable(Buf& buf) {
-  uint64_t l = (buf.Read() & 0xFF) ^ 0x80;
+void DingoSchema<int64_t>::EncodeLongComparable(int64_t data, Buf& buf) {
   if (DINGO_LIKELY(IsLe())) {
-    for (int i = 0; i < 7; i++) {
-      l <<= 8;
-      l |= buf.Read() & 0xFF;
-    }
+    EncodeComparable<true>(data, buf);
   } else {
-    for (int i = 1; i < 8; i++) {
-      l |= (((uint64_t)buf.Read() & 0xFF) << (8 * i));
-    }
+    EncodeComparable<false>(data, buf);
   }
+}
 
-  return static_cast<int64_t>(l);
+int64_t DingoSchema<int64_t>::DecodeLongComparable(BufView& buf) {
+  return DINGO_LIKELY(IsLe()) ? DecodeComparable<true>(buf)
+                              : DecodeComparable<false>(buf);
 }
 
 void DingoSchema<int64_t>::EncodeLongNotComparable(int64_t data, Buf& buf) {
-  uint64_t* l = (uint64_t*)&data;
   if (DINGO_LIKELY(IsLe())) {
-    buf.Write(*l >> 56);
-    buf.Write(*l >> 48);
-    buf.Write(*l >> 40);
-    buf.Write(*l >> 32);
-    buf.Write(*l >> 24);
-    buf.Write(*l >> 16);
-    buf.Write(*l >> 8);
-    buf.Write(*l);
+    buf.WriteWire<true, uint64_t>(data);
   } else {
-    buf.Write(*l);
-    buf.Write(*l >> 8);
-    buf.Write(*l >> 16);
-    buf.Write(*l >> 24);
-    buf.Write(*l >> 32);
-    buf.Write(*l >> 40);
-    buf.Write(*l >> 48);
-    buf.Write(*l >> 56);
+    buf.WriteWire<false, uint64_t>(data);
   }
 }
 
-int64_t DingoSchema<int64_t>::DecodeLongNotComparable(Buf& buf) {
-  uint64_t l = buf.Read() & 0xFF;
-  if (DINGO_LIKELY(IsLe())) {
-    for (int i = 0; i < 7; i++) {
-      l <<= 8;
-      l |= buf.Read() & 0xFF;
-    }
-  } else {
-    for (int i = 1; i < 8; i++) {
-      l |= (((uint64_t)buf.Read() & 0xFF) << (8 * i));
-    }
-  }
-
-  return static_cast<int64_t>(l);
+int64_t DingoSchema<int64_t>::DecodeLongNotComparable(BufView& buf) {
+  return DINGO_LIKELY(IsLe()) ? buf.ReadWire<true, uint64_t>()
+                              : buf.ReadWire<false, uint64_t>();
 }
 
 int DingoSchema<int64_t>::GetLengthForKey() {
@@ -112,27 +75,34 @@ int DingoSchema<int64_t>::GetLengthForKey() {
 
 int DingoSchema<int64_t>::GetLengthForValue() { return kDataLength; }
 
-int DingoSchema<int64_t>::SkipKey(Buf& buf) {
+int DingoSchema<int64_t>::SkipKey(BufView& buf) {
   int len = GetLengthForKey();
   buf.Skip(len);
   return len;
 }
 
-int DingoSchema<int64_t>::SkipValue(Buf& buf) {
+int DingoSchema<int64_t>::SkipValue(BufView& buf) {
   buf.Skip(kDataLength);
   return kDataLength;
 }
 
-int DingoSchema<int64_t>::EncodeKey(const std::any& data, Buf& buf) {
-  if (DINGO_UNLIKELY(!AllowNull() && !data.has_value())) {
+int DingoSchema<int64_t>::GetEncodedKeySize(const int64_t* /*data*/) {
+  return GetLengthForKey();
+}
+
+int DingoSchema<int64_t>::GetEncodedValueSize(const int64_t* data) {
+  return data != nullptr ? kDataLength : 0;
+}
+
+int DingoSchema<int64_t>::EncodeKey(const int64_t* data, Buf& buf) {
+  if (DINGO_UNLIKELY(!AllowNull() && data == nullptr)) {
     throw std::runtime_error("Not allow null, but data not has value.");
   }
 
   if (AllowNull()) {
-    if (data.has_value()) {
+    if (data != nullptr) {
       buf.Write(k_not_null);
-      const auto& ref_data = std::any_cast<const int64_t&>(data);
-      EncodeLongComparable(ref_data, buf);
+      EncodeLongComparable(*data, buf);
     } else {
       buf.Write(k_null);
       buf.WriteLong(0);
@@ -140,40 +110,80 @@ int DingoSchema<int64_t>::EncodeKey(const std::any& data, Buf& buf) {
 
     return kDataLengthWithNull;
   } else {
-    const auto& ref_data = std::any_cast<const int64_t&>(data);
-    EncodeLongComparable(ref_data, buf);
+    EncodeLongComparable(*data, buf);
 
     return kDataLength;
   }
 }
 
 // {value: 8byte}
-int DingoSchema<int64_t>::EncodeValue(const std::any& data, Buf& buf) {
-  if (DINGO_UNLIKELY(!AllowNull() && !data.has_value())) {
+int DingoSchema<int64_t>::EncodeValue(const int64_t* data, Buf& buf) {
+  if (DINGO_UNLIKELY(!AllowNull() && data == nullptr)) {
     throw std::runtime_error("Not allow null, but data not has value.");
   }
 
-  if (data.has_value()) {
-    const auto& ref_data = std::any_cast<const int64_t&>(data);
-    EncodeLongNotComparable(ref_data, buf);
+  if (data != nullptr) {
+    EncodeLongNotComparable(*data, buf);
     return kDataLength;
   }
 
   return 0;
 }
 
-std::any DingoSchema<int64_t>::DecodeKey(Buf& buf) {
+bool DingoSchema<int64_t>::DecodeKey(BufView& buf, int64_t& data) {
   if (AllowNull()) {
     if (buf.Read() == k_null) {
       buf.Skip(kDataLength);
-      return std::any();
+      return false;
     }
   }
 
-  return std::any(DecodeLongComparable(buf));
+  data = DecodeLongComparable(buf);
+  return true;
+}
+
+void DingoSchema<int64_t>::DecodeValue(BufView& buf, int64_t& data) {
+  data = DecodeLongNotComparable(buf);
+}
+
+int DingoSchema<int64_t>::EncodeCompactValue(const int64_t* data, Buf& buf) {
+  if (DINGO_UNLIKELY(!AllowNull() && data == nullptr)) {
+    throw std::runtime_error("Not allow null, but data not has value.");
+  }
+
+  if (data != nullptr) {
+    return buf.WriteVarint(ZigZagEncode(*data));
+  }
+
+  return 0;
+}
+
+int DingoSchema<int64_t>::GetEncodedCompactValueSize(const int64_t* data) {
+  return data != nullptr ? VarintSize(ZigZagEncode(*data)) : 0;
+}
+
+void DingoSchema<int64_t>::DecodeCompactValue(BufView& buf, int64_t& data) {
+  data = ZigZagDecode(buf.ReadVarint());
+}
+
+int DingoSchema<int64_t>::EncodeKey(const std::any& data, Buf& buf) {
+  return EncodeKey(AnyDataPtr<int64_t>(data), buf);
+}
+
+int DingoSchema<int64_t>::EncodeValue(const std::any& data, Buf& buf) {
+  return EncodeValue(AnyDataPtr<int64_t>(data), buf);
+}
+
+std::any DingoSchema<int64_t>::DecodeKey(BufView& buf) {
+  int64_t data;
+  if (!DecodeKey(buf, data)) {
+    return std::any();
+  }
+
+  return std::any(data);
 }
 
-inline std::any DingoSchema<int64_t>::DecodeValue(Buf& buf) {
+std::any DingoSchema<int64_t>::DecodeValue(BufView& buf) {
   return std::any(DecodeLongNotComparable(buf));
 }
 
@@ -21,7 +21,7 @@ namespace dingodb {
 namespace serialV2 {
 
 template <>
-class DingoSchema<int64_t> : public BaseSchema {
+class DingoSchema<int64_t> final : public BaseSchema {
  public:
   Type GetType() override { return kLong; }
   int GetLengthForKey() override;
@@ -31,21 +31,38 @@ class DingoSchema<int64_t> : public BaseSchema {
     return std::make_shared<DingoSchema<int64_t>>();
   }
 
-  int SkipKey(Buf& buf) override;
-  int SkipValue(Buf& buf) override;
+  int SkipKey(BufView& buf) override;
+  int SkipValue(BufView& buf) override;
 
   int EncodeKey(const std::any& data, Buf& buf) override;
   int EncodeValue(const std::any& data, Buf& buf) override;
 
-  std::any DecodeKey(Buf& buf) override;
-  std::any DecodeValue(Buf& buf) override;
+  std::any DecodeKey(BufView& buf) override;
+  std::any DecodeValue(BufView& buf) override;
+
+  // Typed entry points, a null data pointer encodes null. The decoders
+  // overwrite data, DecodeKey returns false for a null column.
+  int EncodeKey(const int64_t* data, Buf& buf);
+  int EncodeValue(const int64_t* data, Buf& buf);
+  bool DecodeKey(BufView& buf, int64_t& data);
+  void DecodeValue(BufView& buf, int64_t& data);
+
+  // Exact number of bytes EncodeKey / EncodeValue write for data.
+  int GetEncodedKeySize(const int64_t* data);
+  int GetEncodedValueSize(const int64_t* data);
+
+  // Compact value form, the zigzag varint of data. It is chosen per column
+  // by SetCompactValue and only written in V3 rows flagged VALUE_COMPACT.
+  int EncodeCompactValue(const int64_t* data, Buf& buf);
+  int GetEncodedCompactValueSize(const int64_t* data);
+  void DecodeCompactValue(BufView& buf, int64_t& data);
 
  private:
   void EncodeLongComparable(int64_t data, Buf& buf);
-  int64_t DecodeLongComparable(Buf& buf);
+  int64_t DecodeLongComparable(BufView& buf);
 
   void EncodeLongNotComparable(int64_t data, Buf& buf);
-  int64_t DecodeLongNotComparable(Buf& buf);
+  int64_t DecodeLongNotComparable(BufView& buf);
 };
 
 }  // namespace serialV2
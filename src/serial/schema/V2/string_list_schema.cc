@@ -37,7 +37,7 @@ int DingoSchema<std::vector<std::string>>::EncodeStringListNotComparable(
 }
 
 void DingoSchema<std::vector<std::string>>::DecodeStringListNotComparable(
-    Buf& buf, std::vector<std::string>& data) {
+    BufView& buf, std::vector<std::string>& data) {
   int size = buf.ReadInt();
   data.resize(size);
   for (int i = 0; i < size; ++i) {
@@ -60,12 +60,12 @@ int DingoSchema<std::vector<std::string>>::GetLengthForValue() {
   return -1;
 }
 
-int DingoSchema<std::vector<std::string>>::SkipKey(Buf&) {
+int DingoSchema<std::vector<std::string>>::SkipKey(BufView&) {
   throw std::runtime_error("Unsupport encoding key list type");
   return -1;
 }
 
-int DingoSchema<std::vector<std::string>>::SkipValue(Buf& buf) {
+int DingoSchema<std::vector<std::string>>::SkipValue(BufView& buf) {
   int size = 4;
   int str_num = buf.ReadInt();
   for (int i = 0; i < str_num; ++i) {
@@ -77,32 +77,73 @@ int DingoSchema<std::vector<std::string>>::SkipValue(Buf& buf) {
   return size;
 }
 
+int DingoSchema<std::vector<std::string>>::GetEncodedKeySize(
+    const std::vector<std::string>*) {
+  throw std::runtime_error("Unsupported encode key list type");
+  return -1;
+}
+
+int DingoSchema<std::vector<std::string>>::GetEncodedValueSize(
+    const std::vector<std::string>* data) {
+  if (data == nullptr) {
+    return 0;
+  }
+
+  int size = 4;
+  for (const std::string& str : *data) {
+    size += str.size() + 4;
+  }
+
+  return size;
+}
+
+int DingoSchema<std::vector<std::string>>::EncodeKey(
+    const std::vector<std::string>*, Buf&) {
+  throw std::runtime_error("Unsupported encode key list type");
+  return -1;
+}
+
 int DingoSchema<std::vector<std::string>>::EncodeKey(const std::any&, Buf&) {
   throw std::runtime_error("Unsupported encode key list type");
   return -1;
 }
 
-int DingoSchema<std::vector<std::string>>::EncodeValue(const std::any& data,
-                                                       Buf& buf) {
-  if (DINGO_UNLIKELY(!AllowNull() && !data.has_value())) {
+int DingoSchema<std::vector<std::string>>::EncodeValue(
+    const std::vector<std::string>* data, Buf& buf) {
+  if (DINGO_UNLIKELY(!AllowNull() && data == nullptr)) {
     throw std::runtime_error("Not allow null, but data not has value.");
   }
 
-  if (data.has_value()) {
-    const auto& ref_data = std::any_cast<const std::vector<std::string>&>(data);
+  if (data != nullptr) {
+    const auto& ref_data = *data;
     return EncodeStringListNotComparable(ref_data, buf);
   }
 
   return 0;
 }
 
-std::any DingoSchema<std::vector<std::string>>::DecodeKey(Buf&) {
+int DingoSchema<std::vector<std::string>>::EncodeValue(
+    const std::any& data, Buf& buf) {
+  return EncodeValue(AnyDataPtr<std::vector<std::string>>(data), buf);
+}
+
+bool DingoSchema<std::vector<std::string>>::DecodeKey(
+    BufView&, std::vector<std::string>&) {
   throw std::runtime_error("Unsupported encode key list type");
 }
 
-std::any DingoSchema<std::vector<std::string>>::DecodeValue(Buf& buf) {
-  std::vector<std::string> data;
+std::any DingoSchema<std::vector<std::string>>::DecodeKey(BufView&) {
+  throw std::runtime_error("Unsupported encode key list type");
+}
+
+void DingoSchema<std::vector<std::string>>::DecodeValue(
+    BufView& buf, std::vector<std::string>& data) {
   DecodeStringListNotComparable(buf, data);
+}
+
+std::any DingoSchema<std::vector<std::string>>::DecodeValue(BufView& buf) {
+  std::vector<std::string> data;
+  DecodeValue(buf, data);
 
   return std::move(std::any(std::move(data)));
 }
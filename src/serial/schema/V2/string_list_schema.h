@@ -24,7 +24,7 @@ namespace dingodb {
 namespace serialV2 {
 
 template <>
-class DingoSchema<std::vector<std::string>> : public BaseSchema {
+class DingoSchema<std::vector<std::string>> final : public BaseSchema {
  public:
   Type GetType() override { return kStringList; }
   int GetLengthForKey() override;
@@ -34,19 +34,30 @@ class DingoSchema<std::vector<std::string>> : public BaseSchema {
     return std::make_shared<DingoSchema<std::vector<std::string>>>();
   }
 
-  int SkipKey(Buf& buf) override;
-  int SkipValue(Buf& buf) override;
+  int SkipKey(BufView& buf) override;
+  int SkipValue(BufView& buf) override;
 
   int EncodeKey(const std::any& data, Buf& buf) override;
   int EncodeValue(const std::any& data, Buf& buf) override;
 
-  std::any DecodeKey(Buf& buf) override;
-  std::any DecodeValue(Buf& buf) override;
+  std::any DecodeKey(BufView& buf) override;
+  std::any DecodeValue(BufView& buf) override;
+
+  // Typed entry points, a null data pointer encodes null. The decoders
+  // overwrite data. List columns are never part of a key.
+  int EncodeKey(const std::vector<std::string>* data, Buf& buf);
+  int EncodeValue(const std::vector<std::string>* data, Buf& buf);
+  bool DecodeKey(BufView& buf, std::vector<std::string>& data);
+  void DecodeValue(BufView& buf, std::vector<std::string>& data);
+
+  // Exact number of bytes EncodeKey / EncodeValue write for data.
+  int GetEncodedKeySize(const std::vector<std::string>* data);
+  int GetEncodedValueSize(const std::vector<std::string>* data);
 
  private:
   static int EncodeStringListNotComparable(const std::vector<std::string>& data,
                                            Buf& buf);
-  static void DecodeStringListNotComparable(Buf& buf,
+  static void DecodeStringListNotComparable(BufView& buf,
                                             std::vector<std::string>& data);
 };
 
@@ -15,12 +15,19 @@
 #include "string_schema.h"
 
 #include <cstdint>
+#include <cstring>
 #include <memory>
+#include <stdexcept>
 #include <string>
+#include <string_view>
 #include <utility>
 
 #include "serial/utils/V2/compiler.h"
 
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
 namespace dingodb {
 namespace serialV2 {
 
@@ -28,55 +35,188 @@ const int kGroupSize = 8;
 const int kPadGroupSize = 9;
 const uint8_t kMarker = 255;
 
-int DingoSchema<std::string>::EncodeBytesComparable(const std::string& data,
-                                                    Buf& buf) {
-  for (uint32_t i = 0; i < data.size(); ++i) {
-    buf.Write(data.at(i));
-    if ((i + 1) % kGroupSize == 0) {
-      buf.Write(kMarker);
+namespace {
+
+/*
+ * The comparable format cuts the string into groups of 8 bytes, each followed
+ * by a marker byte. Every group but the last is full and marked 255, the last
+ * one is zero padded and marked 255 - pad_count. Finding the end of a string
+ * key is finding the first marker below 255, which is done a window of
+ * kScanGroups groups (144 bytes) at a time: the window is compared against
+ * 0xFF and the resulting byte mask is tested at the marker positions.
+ */
+const int kScanGroups = 16;
+const int kScanBytes = kScanGroups * kPadGroupSize;
+
+// Bit i of word i / 64 is set when byte i of a window is a marker.
+constexpr uint64_t MarkerBits(int word) {
+  uint64_t bits = 0;
+  for (int i = 0; i < kScanGroups; ++i) {
+    int pos = i * kPadGroupSize + kGroupSize - word * 64;
+    if (pos >= 0 && pos < 64) {
+      bits |= uint64_t(1) << pos;
     }
   }
+  return bits;
+}
 
-  int group_num = data.size() / kGroupSize + 1;
-  int pad_count = group_num * kGroupSize - data.size();
-  for (int i = 0; i < pad_count; ++i) {
-    buf.Write(0);
-  }
-  buf.Write(kMarker - pad_count);
+constexpr uint64_t kMarkerBits[3] = {MarkerBits(0), MarkerBits(1),
+                                     MarkerBits(2)};
 
-  return group_num * 9;
+// Group index of the first marker in the window whose byte is not 0xFF, eq
+// holding one bit per window byte, or -1 if every marker is 255.
+inline int FirstLastGroup(const uint64_t eq[3]) {
+  for (int w = 0; w < 3; ++w) {
+    uint64_t miss = ~eq[w] & kMarkerBits[w];
+    if (miss != 0) {
+      return (w * 64 + __builtin_ctzll(miss) - kGroupSize) / kPadGroupSize;
+    }
+  }
+  return -1;
 }
 
-int DingoSchema<std::string>::DecodeBytesComparable(Buf& buf,
-                                                    std::string& data) {
-  int size = 0;
-  for (;;) {
-    if (buf.RestReadableSize() < kPadGroupSize) {
-      return -1;
+int ScanWindowScalar(const char* p) {
+  for (int i = 0; i < kScanGroups; ++i) {
+    if (static_cast<uint8_t>(p[i * kPadGroupSize + kGroupSize]) != kMarker) {
+      return i;
     }
+  }
+  return -1;
+}
 
-    uint8_t marker = buf.Read(buf.ReadOffset() + kGroupSize);
+#if defined(__x86_64__) || defined(__i386__)
 
-    int pad_count = kMarker - marker;
-    for (int i = 0; i < kGroupSize - pad_count; ++i) {
-      data.push_back(buf.Read());
-    }
+int ScanWindowSse2(const char* p) {
+  const __m128i ff = _mm_set1_epi8(-1);
+  uint64_t eq[3] = {0, 0, 0};
+  for (int i = 0; i < kScanBytes / 16; ++i) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i * 16));
+    uint64_t mask =
+        static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, ff)));
+    eq[i / 4] |= mask << (16 * (i % 4));
+  }
+  return FirstLastGroup(eq);
+}
 
-    size += kPadGroupSize;
-    if (pad_count != 0) {
-      for (int i = 0; i < pad_count; ++i) {
-        if (buf.Read() != 0) {
-          return -1;
-        }
-      }
-      buf.Skip(1);  // skip marker
+__attribute__((target("avx2"))) int ScanWindowAvx2(const char* p) {
+  const __m256i ff = _mm256_set1_epi8(-1);
+  uint64_t eq[3] = {0, 0, 0};
+  for (int i = 0; i < 4; ++i) {
+    __m256i v =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i * 32));
+    uint64_t mask =
+        static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, ff)));
+    eq[i / 2] |= mask << (32 * (i % 2));
+  }
+  __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 128));
+  eq[2] = static_cast<uint32_t>(
+      _mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8(-1))));
+  return FirstLastGroup(eq);
+}
+
+#endif
+
+using ScanWindowFunc = int (*)(const char*);
+
+ScanWindowFunc SelectScanWindow() {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    return ScanWindowAvx2;
+  }
+  if (__builtin_cpu_supports("sse2")) {
+    return ScanWindowSse2;
+  }
+#endif
+  return ScanWindowScalar;
+}
 
+const ScanWindowFunc kScanWindow = SelectScanWindow();
+
+// Encoded size of the comparable string at p, -1 if size bytes hold no
+// complete one or its last group is malformed.
+int ScanBytesComparable(const char* p, size_t size) {
+  size_t group = 0;
+  int last = -1;
+  while ((group + kScanGroups) * kPadGroupSize <= size) {
+    last = kScanWindow(p + group * kPadGroupSize);
+    if (last >= 0) {
+      group += last;
       break;
     }
+    group += kScanGroups;
+  }
+  if (last < 0) {
+    for (;; ++group) {
+      if ((group + 1) * kPadGroupSize > size) {
+        return -1;
+      }
+      if (static_cast<uint8_t>(p[group * kPadGroupSize + kGroupSize]) !=
+          kMarker) {
+        break;
+      }
+    }
+  }
 
-    buf.Skip(1);  // skip marker
+  const char* tail = p + group * kPadGroupSize;
+  int pad_count = kMarker - static_cast<uint8_t>(tail[kGroupSize]);
+  if (pad_count > kGroupSize) {
+    return -1;
+  }
+  for (int i = kGroupSize - pad_count; i < kGroupSize; ++i) {
+    if (tail[i] != 0) {
+      return -1;
+    }
   }
 
+  return (group + 1) * kPadGroupSize;
+}
+
+}  // namespace
+
+int DingoSchema<std::string>::EncodeBytesComparable(const std::string& data,
+                                                    Buf& buf) {
+  int group_num = data.size() / kGroupSize + 1;
+  int pad_count = group_num * kGroupSize - data.size();
+
+  size_t pos = buf.Size();
+  buf.Enlarge(group_num * kPadGroupSize);
+  char* dst = buf.MutableData() + pos;
+  const char* src = data.data();
+  for (int i = 0; i < group_num - 1; ++i) {
+    memcpy(dst, src, kGroupSize);
+    dst[kGroupSize] = static_cast<char>(kMarker);
+    dst += kPadGroupSize;
+    src += kGroupSize;
+  }
+  memcpy(dst, src, kGroupSize - pad_count);
+  memset(dst + kGroupSize - pad_count, 0, pad_count);
+  dst[kGroupSize] = static_cast<char>(kMarker - pad_count);
+
+  return group_num * kPadGroupSize;
+}
+
+int DingoSchema<std::string>::DecodeBytesComparable(BufView& buf,
+                                                    std::string& data) {
+  const char* src = buf.Data() + buf.ReadOffset();
+  int size = ScanBytesComparable(src, buf.RestReadableSize());
+  if (size == -1) {
+    return -1;
+  }
+
+  int group_num = size / kPadGroupSize;
+  int pad_count = kMarker - static_cast<uint8_t>(src[size - 1]);
+  size_t pos = data.size();
+  data.resize(pos + group_num * kGroupSize - pad_count);
+  char* dst = data.data() + pos;
+  for (int i = 0; i < group_num - 1; ++i) {
+    memcpy(dst, src, kGroupSize);
+    dst += kGroupSize;
+    src += kPadGroupSize;
+  }
+  memcpy(dst, src, kGroupSize - pad_count);
+
+  buf.Skip(size);
   return size;
 }
 
@@ -88,13 +228,20 @@ int DingoSchema<std::string>::EncodeBytesNotComparable(const std::string& data,
   return data.size() + 4;
 }
 
-void DingoSchema<std::string>::DecodeBytesNotComparable(Buf& buf,
+void DingoSchema<std::string>::DecodeBytesNotComparable(BufView& buf,
                                                         std::string& data) {
+  data.assign(ViewBytesNotComparable(buf));
+}
+
+std::string_view DingoSchema<std::string>::ViewBytesNotComparable(
+    BufView& buf) {
   int size = buf.ReadInt();
-  data.resize(size);
-  for (int i = 0; i < size; ++i) {
-    data[i] = buf.Read();
+  if (DINGO_UNLIKELY(size < 0)) {
+    throw std::out_of_range("Out of range.");
   }
+  const char* bytes = buf.Data() + buf.ReadOffset();
+  buf.Skip(size);
+  return std::string_view(bytes, size);
 }
 
 int DingoSchema<std::string>::GetLengthForKey() {
@@ -105,90 +252,120 @@ int DingoSchema<std::string>::GetLengthForValue() {
   throw std::runtime_error("String unsupport length");
 }
 
-int DingoSchema<std::string>::SkipKey(Buf& buf) {
+int DingoSchema<std::string>::SkipKey(BufView& buf) {
+  int null_size = 0;
   if (AllowNull()) {
     if (buf.Read() == k_null) {
       return 1;
     }
+    null_size = 1;
+  }
 
-    std::string data(1024, 0);
-    int size = DecodeBytesComparable(buf, data);
-    if (size == -1) {
-      throw std::runtime_error("decode comparable string error.");
-    }
-
-    return size + 1;  // with null flag.
-  } else {
-    std::string data(1024, 0);
-    int size = DecodeBytesComparable(buf, data);
-    if (size == -1) {
-      throw std::runtime_error("decode comparable string error.");
-    }
-
-    return size;
+  int size = ScanBytesComparable(buf.Data() + buf.ReadOffset(),
+                                 buf.RestReadableSize());
+  if (size == -1) {
+    throw std::runtime_error("decode comparable string error.");
   }
+  buf.Skip(size);
+
+  return size + null_size;  // with null flag.
 }
 
-int DingoSchema<std::string>::SkipValue(Buf& buf) {
+int DingoSchema<std::string>::SkipValue(BufView& buf) {
   int size = buf.ReadInt();
   buf.Skip(size);
 
   return size + 4;
 }
 
-int DingoSchema<std::string>::EncodeKey(const std::any& data, Buf& buf) {
-  if (DINGO_UNLIKELY(!AllowNull() && !data.has_value())) {
+int DingoSchema<std::string>::GetEncodedKeySize(const std::string* data) {
+  int size = AllowNull() ? 1 : 0;
+  if (data != nullptr) {
+    size += (data->size() / kGroupSize + 1) * kPadGroupSize;
+  }
+
+  return size;
+}
+
+int DingoSchema<std::string>::GetEncodedValueSize(const std::string* data) {
+  return data != nullptr ? data->size() + 4 : 0;
+}
+
+int DingoSchema<std::string>::EncodeKey(const std::string* data, Buf& buf) {
+  if (DINGO_UNLIKELY(!AllowNull() && data == nullptr)) {
     throw std::runtime_error("data not has value.");
   }
   if (AllowNull()) {
-    if (data.has_value()) {
+    if (data != nullptr) {
       buf.Write(k_not_null);
-      const auto& ref_data = std::any_cast<const std::string&>(data);
-      return EncodeBytesComparable(ref_data, buf) + 1;
+      return EncodeBytesComparable(*data, buf) + 1;
     } else {
       buf.Write(k_null);
       return 1;
     }
   } else {
-    if (data.has_value()) {
-      const auto& ref_data = std::any_cast<const std::string&>(data);
-      return EncodeBytesComparable(ref_data, buf);
+    if (data != nullptr) {
+      return EncodeBytesComparable(*data, buf);
     } else {
       return 0;
     }
   }
 }
 
-int DingoSchema<std::string>::EncodeValue(const std::any& data, Buf& buf) {
-  if (DINGO_UNLIKELY(!AllowNull() && !data.has_value())) {
+int DingoSchema<std::string>::EncodeValue(const std::string* data, Buf& buf) {
+  if (DINGO_UNLIKELY(!AllowNull() && data == nullptr)) {
     throw std::runtime_error("data not has value.");
   }
 
-  if (data.has_value()) {
-    const auto& ref_data = std::any_cast<const std::string&>(data);
-    return EncodeBytesNotComparable(ref_data, buf);
+  if (data != nullptr) {
+    return EncodeBytesNotComparable(*data, buf);
   }
 
   return 0;
 }
 
-std::any DingoSchema<std::string>::DecodeKey(Buf& buf) {
+bool DingoSchema<std::string>::DecodeKey(BufView& buf, std::string& data) {
   if (AllowNull()) {
     if (buf.Read() == k_null) {
-      return std::any();
+      return false;
     }
   }
 
-  std::string data;
+  data.clear();
   int size = DecodeBytesComparable(buf, data);
   if (size == -1) {
     throw std::runtime_error("decode comparable string error.");
   }
 
+  return true;
+}
+
+void DingoSchema<std::string>::DecodeValue(BufView& buf, std::string& data) {
+  DecodeBytesNotComparable(buf, data);
+}
+
+std::string_view DingoSchema<std::string>::ViewValue(BufView& buf) {
+  return ViewBytesNotComparable(buf);
+}
+
+int DingoSchema<std::string>::EncodeKey(const std::any& data, Buf& buf) {
+  return EncodeKey(AnyDataPtr<std::string>(data), buf);
+}
+
+int DingoSchema<std::string>::EncodeValue(const std::any& data, Buf& buf) {
+  return EncodeValue(AnyDataPtr<std::string>(data), buf);
+}
+
+std::any DingoSchema<std::string>::DecodeKey(BufView& buf) {
+  std::string data;
+  if (!DecodeKey(buf, data)) {
+    return std::any();
+  }
+
   return std::move(std::any(std::move(data)));
 }
 
-std::any DingoSchema<std::string>::DecodeValue(Buf& buf) {
+std::any DingoSchema<std::string>::DecodeValue(BufView& buf) {
   std::string data;
   DecodeBytesNotComparable(buf, data);
 
@@ -16,6 +16,7 @@
 #define DINGO_SERIAL_STRING_SCHEMA_V2_H_
 
 #include <memory>
+#include <string_view>
 
 #include "dingo_schema.h"
 
@@ -23,7 +24,7 @@ namespace dingodb {
 namespace serialV2 {
 
 template <>
-class DingoSchema<std::string> : public BaseSchema {
+class DingoSchema<std::string> final : public BaseSchema {
  public:
   Type GetType() override { return kString; }
   int GetLengthForKey() override;
@@ -33,21 +34,35 @@ class DingoSchema<std::string> : public BaseSchema {
     return std::make_shared<DingoSchema<std::string>>();
   }
 
-  int SkipKey(Buf& buf) override;
-  int SkipValue(Buf& buf) override;
+  int SkipKey(BufView& buf) override;
+  int SkipValue(BufView& buf) override;
 
   int EncodeKey(const std::any& data, Buf& buf) override;
   int EncodeValue(const std::any& data, Buf& buf) override;
 
-  std::any DecodeKey(Buf& buf) override;
-  std::any DecodeValue(Buf& buf) override;
+  std::any DecodeKey(BufView& buf) override;
+  std::any DecodeValue(BufView& buf) override;
+
+  // Typed entry points, a null data pointer encodes null. The decoders
+  // overwrite data, DecodeKey returns false for a null column.
+  int EncodeKey(const std::string* data, Buf& buf);
+  int EncodeValue(const std::string* data, Buf& buf);
+  bool DecodeKey(BufView& buf, std::string& data);
+  void DecodeValue(BufView& buf, std::string& data);
+  // The bytes of a value in place, valid as long as the memory buf views.
+  std::string_view ViewValue(BufView& buf);
+
+  // Exact number of bytes EncodeKey / EncodeValue write for data.
+  int GetEncodedKeySize(const std::string* data);
+  int GetEncodedValueSize(const std::string* data);
 
  private:
   static int EncodeBytesComparable(const std::string& data, Buf& buf);
-  static int DecodeBytesComparable(Buf& buf, std::string& data);
+  static int DecodeBytesComparable(BufView& buf, std::string& data);
 
   static int EncodeBytesNotComparable(const std::string& data, Buf& buf);
-  static void DecodeBytesNotComparable(Buf& buf, std::string& data);
+  static void DecodeBytesNotComparable(BufView& buf, std::string& data);
+  static std::string_view ViewBytesNotComparable(BufView& buf);
 };
 
 }  // namespace serialV2
@@ -20,51 +20,85 @@
 #include <cstring>
 #include <iostream>
 #include <string>
+#include <utility>
 
 #include "serial/utils/V2/compiler.h"
 
 namespace dingodb {
 namespace serialV2 {
 
-Buf::Buf(size_t capacity, bool le) : le_(le) { buf_.reserve(capacity); }
+Buf::Buf(size_t capacity, bool le) : BufView(nullptr, 0, le) {
+  buf_.reserve(capacity);
+  Sync();
+}
 
 Buf::Buf(size_t capacity) : Buf(capacity, true) {}
 
-Buf::Buf(const std::string& s, bool le) : le_(le) { buf_ = s; }
+Buf::Buf(const std::string& s, bool le) : BufView(nullptr, 0, le), buf_(s) {
+  Sync();
+}
 
 Buf::Buf(const std::string& s) : Buf(s, true) {}
 
-Buf::Buf(std::string&& s, bool le) : le_(le) { buf_.swap(s); }
+Buf::Buf(std::string&& s, bool le) : BufView(nullptr, 0, le) {
+  buf_.swap(s);
+  Sync();
+}
 
 Buf::Buf(std::string&& s) : Buf(s, true) {}
 
-void Buf::Write(uint8_t data) { buf_.push_back(data); }
+Buf::Buf(const Buf& other) : BufView(other), buf_(other.buf_) { Sync(); }
 
-void Buf::WriteWithNegation(uint8_t data) { buf_.push_back(~data); }
+Buf::Buf(Buf&& other) noexcept
+    : BufView(other), buf_(std::move(other.buf_)) {
+  Sync();
+  other.Sync();
+}
 
-void Buf::Enlarge(size_t len) { this->buf_.resize(buf_.size() + len); }
+Buf& Buf::operator=(const Buf& other) {
+  if (this != &other) {
+    BufView::operator=(other);
+    buf_ = other.buf_;
+    Sync();
+  }
+  return *this;
+}
 
-void Buf::WriteInt(int32_t data) {
-  size_t curr_size = buf_.size();
-  buf_.resize(curr_size + 4);
+Buf& Buf::operator=(Buf&& other) noexcept {
+  if (this != &other) {
+    BufView::operator=(other);
+    buf_ = std::move(other.buf_);
+    Sync();
+    other.Sync();
+  }
+  return *this;
+}
 
-  char* buf = buf_.data();
-  uint8_t* i = (uint8_t*)&data;
+void Buf::Write(uint8_t data) {
+  buf_.push_back(data);
+  Sync();
+}
+
+void Buf::WriteWithNegation(uint8_t data) {
+  buf_.push_back(~data);
+  Sync();
+}
+
+void Buf::Enlarge(size_t len) {
+  this->buf_.resize(buf_.size() + len);
+  Sync();
+}
+
+void Buf::WriteInt(int32_t data) {
   if (DINGO_LIKELY(this->le_)) {
-    buf[curr_size] = *(i + 3);
-    buf[curr_size + 1] = *(i + 2);
-    buf[curr_size + 2] = *(i + 1);
-    buf[curr_size + 3] = *i;
+    WriteWire<true, uint32_t>(data);
   } else {
-    buf[curr_size] = *i;
-    buf[curr_size + 1] = *(i + 1);
-    buf[curr_size + 2] = *(i + 2);
-    buf[curr_size + 3] = *(i + 3);
+    WriteWire<false, uint32_t>(data);
   }
 }
 
 void Buf::WriteByte(size_t pos, uint8_t data) {
-  if (DINGO_UNLIKELY(pos + 1 > buf_.size())) {
+  if (DINGO_UNLIKELY(pos >= buf_.size())) {
     throw std::runtime_error("Out of range.");
   }
 
@@ -73,124 +107,50 @@ void Buf::WriteByte(size_t pos, uint8_t data) {
 }
 
 void Buf::WriteShort(int16_t data) {
-  size_t curr_size = buf_.size();
-  buf_.resize(curr_size + 2);
-
-  char* buf = buf_.data();
-  uint8_t* i = (uint8_t*)&data;
   if (DINGO_LIKELY(this->le_)) {
-    buf[curr_size] = *(i + 1);
-    buf[curr_size + 1] = *i;
+    WriteWire<true, uint16_t>(data);
   } else {
-    buf[curr_size] = *i;
-    buf[curr_size + 1] = *(i + 1);
+    WriteWire<false, uint16_t>(data);
   }
 }
 
 void Buf::WriteShort(size_t pos, int16_t data) {
-  if (DINGO_UNLIKELY(pos + 2 > buf_.size())) {
-    throw std::runtime_error("Out of range.");
-  }
-
-  char* buf = buf_.data();
-  uint8_t* i = (uint8_t*)&data;
   if (DINGO_LIKELY(this->le_)) {
-    buf[pos] = *(i + 1);
-    buf[pos + 1] = *i;
+    WriteWire<true, uint16_t>(pos, data);
   } else {
-    buf[pos] = *i;
-    buf[pos + 1] = *(i + 1);
+    WriteWire<false, uint16_t>(pos, data);
   }
 }
 
 void Buf::WriteInt(size_t pos, int32_t data) {
-  if (DINGO_UNLIKELY(pos + 4 > buf_.size())) {
-    throw std::runtime_error("Out of range.");
-  }
-
-  char* buf = buf_.data();
-  uint8_t* i = (uint8_t*)&data;
   if (DINGO_LIKELY(this->le_)) {
-    buf[pos] = *(i + 3);
-    buf[pos + 1] = *(i + 2);
-    buf[pos + 2] = *(i + 1);
-    buf[pos + 3] = *i;
+    WriteWire<true, uint32_t>(pos, data);
   } else {
-    buf[pos] = *i;
-    buf[pos + 1] = *(i + 1);
-    buf[pos + 2] = *(i + 2);
-    buf[pos + 3] = *(i + 3);
+    WriteWire<false, uint32_t>(pos, data);
   }
 }
 
 void Buf::WriteLong(int64_t data) {
-  uint8_t* i = (uint8_t*)&data;
   if (DINGO_LIKELY(this->le_)) {
-    buf_.push_back(*(i + 7));
-    buf_.push_back(*(i + 6));
-    buf_.push_back(*(i + 5));
-    buf_.push_back(*(i + 4));
-    buf_.push_back(*(i + 3));
-    buf_.push_back(*(i + 2));
-    buf_.push_back(*(i + 1));
-    buf_.push_back(*i);
+    WriteWire<true, uint64_t>(data);
   } else {
-    buf_.push_back(*i);
-    buf_.push_back(*(i + 1));
-    buf_.push_back(*(i + 2));
-    buf_.push_back(*(i + 3));
-    buf_.push_back(*(i + 4));
-    buf_.push_back(*(i + 5));
-    buf_.push_back(*(i + 6));
-    buf_.push_back(*(i + 7));
+    WriteWire<false, uint64_t>(data);
   }
 }
 
 void Buf::WriteLongWithNegation(int64_t data) {
-  uint8_t* i = (uint8_t*)&data;
   if (DINGO_LIKELY(this->le_)) {
-    buf_.push_back(~*(i + 7));
-    buf_.push_back(~*(i + 6));
-    buf_.push_back(~*(i + 5));
-    buf_.push_back(~*(i + 4));
-    buf_.push_back(~*(i + 3));
-    buf_.push_back(~*(i + 2));
-    buf_.push_back(~*(i + 1));
-    buf_.push_back(~*i);
-
+    WriteWire<true, uint64_t>(~data);
   } else {
-    buf_.push_back(~*i);
-    buf_.push_back(~*(i + 1));
-    buf_.push_back(~*(i + 2));
-    buf_.push_back(~*(i + 3));
-    buf_.push_back(~*(i + 4));
-    buf_.push_back(~*(i + 5));
-    buf_.push_back(~*(i + 6));
-    buf_.push_back(~*(i + 7));
+    WriteWire<false, uint64_t>(~data);
   }
 }
 
 void Buf::WriteLongWithFirstBitNegation(int64_t data) {
-  uint8_t* i = (uint8_t*)&data;
   if (DINGO_LIKELY(this->le_)) {
-    buf_.push_back(*(i + 7) ^ 0x80);
-    buf_.push_back(*(i + 6));
-    buf_.push_back(*(i + 5));
-    buf_.push_back(*(i + 4));
-    buf_.push_back(*(i + 3));
-    buf_.push_back(*(i + 2));
-    buf_.push_back(*(i + 1));
-    buf_.push_back(*i);
-
+    WriteWire<true, uint64_t>(data ^ WireSignBit<true, uint64_t>());
   } else {
-    buf_.push_back(*i ^ 0x80);
-    buf_.push_back(*(i + 1));
-    buf_.push_back(*(i + 2));
-    buf_.push_back(*(i + 3));
-    buf_.push_back(*(i + 4));
-    buf_.push_back(*(i + 5));
-    buf_.push_back(*(i + 6));
-    buf_.push_back(*(i + 7));
+    WriteWire<false, uint64_t>(data ^ WireSignBit<false, uint64_t>());
   }
 }
 
@@ -198,198 +158,22 @@ void Buf::WriteString(const std::string& data) {
   size_t curr_size = buf_.size();
   buf_.resize(curr_size + data.size());
 
-  memcpy(buf_.data() + curr_size, data.data(), data.size());
-}
-
-uint8_t Buf::Peek() { return buf_.at(read_offset_); }
-
-int32_t Buf::PeekInt() {
-  if (DINGO_LIKELY(this->le_)) {
-    char* buf = buf_.data();
-    return ((buf[read_offset_] & 0xFF) << 24) |
-           ((buf[read_offset_ + 1] & 0xFF) << 16) |
-           ((buf[read_offset_ + 2] & 0xFF) << 8) |
-           (buf[read_offset_ + 3] & 0xFF);
-  } else {
-    char* buf = buf_.data();
-    return (buf[read_offset_] & 0xFF) | ((buf[read_offset_ + 1] & 0xFF) << 8) |
-           ((buf[read_offset_ + 2] & 0xFF) << 16) |
-           ((buf[read_offset_ + 3] & 0xFF) << 24);
-  }
-}
-
-int64_t Buf::PeekLong() {
-  char* buf = buf_.data();
-  int64_t l = 0;
-  if (DINGO_LIKELY(this->le_)) {
-    l |= (buf[read_offset_] & 0xFF);
-    l <<= 8;
-    l |= (buf[read_offset_ + 1] & 0xFF);
-    l <<= 8;
-    l |= (buf[read_offset_ + 2] & 0xFF);
-    l <<= 8;
-    l |= (buf[read_offset_ + 3] & 0xFF);
-    l <<= 8;
-    l |= (buf[read_offset_ + 4] & 0xFF);
-    l <<= 8;
-    l |= (buf[read_offset_ + 5] & 0xFF);
-    l <<= 8;
-    l |= (buf[read_offset_ + 6] & 0xFF);
-    l <<= 8;
-    l |= (buf[read_offset_ + 7] & 0xFF);
-
-  } else {
-    l |= (buf[read_offset_ + 7] & 0xFF);
-    l <<= 8;
-    l |= (buf[read_offset_ + 6] & 0xFF);
-    l <<= 8;
-    l |= (buf[read_offset_ + 5] & 0xFF);
-    l <<= 8;
-    l |= (buf[read_offset_ + 4] & 0xFF);
-    l <<= 8;
-    l |= (buf[read_offset_ + 3] & 0xFF);
-    l <<= 8;
-    l |= (buf[read_offset_ + 2] & 0xFF);
-    l <<= 8;
-    l |= (buf[read_offset_ + 1] & 0xFF);
-    l <<= 8;
-    l |= (buf[read_offset_] & 0xFF);
-  }
-  return l;
-}
-
-uint8_t Buf::Read() { return buf_.at(read_offset_++); }
-
-uint8_t Buf::Read(size_t pos) {
-  uint8_t ret = buf_.at(pos);
-  return ret;
-}
-
-int16_t Buf::ReadShort() {
-  if (DINGO_LIKELY(this->le_)) {
-    int a = Read();
-    int b = Read();
-    return ((a & 0xFF) << 8) | (b & 0xFF);
-  } else {
-    return (Read() & 0xFF) | ((Read() & 0xFF) << 8);
-  }
-}
+  Sync();
 
-int16_t Buf::ReadShort(int pos) {
-  int ret = 0;
-  if (DINGO_LIKELY(this->le_)) {
-    ret = ((buf_.at(pos) & 0xFF) << 8) | (buf_.at(pos + 1) & 0xFF);
-  } else {
-    ret = (buf_.at(pos) & 0xFF) | ((buf_.at(pos + 1) & 0xFF) << 8);
-  }
-  return ret;
-}
-
-int32_t Buf::ReadInt() {
-  if (DINGO_LIKELY(this->le_)) {
-    return ((Read() & 0xFF) << 24) | ((Read() & 0xFF) << 16) |
-           ((Read() & 0xFF) << 8) | (Read() & 0xFF);
-  } else {
-    return (Read() & 0xFF) | ((Read() & 0xFF) << 8) | ((Read() & 0xFF) << 16) |
-           ((Read() & 0xFF) << 24);
-  }
-}
-
-int32_t Buf::ReadInt(int pos) {
-  if (DINGO_LIKELY(this->le_)) {
-    return ((buf_.at(pos) & 0xFF) << 24) | ((buf_.at(pos + 1) & 0xFF) << 16) |
-           ((buf_.at(pos + 2) & 0xFF) << 8) | (buf_.at(pos + 3) & 0xFF);
-  } else {
-    return (buf_.at(pos) & 0xFF) | ((buf_.at(pos + 1) & 0xFF) << 8) |
-           ((buf_.at(pos + 2) & 0xFF) << 16) |
-           ((buf_.at(pos + 3) & 0xFF) << 24);
-  }
-}
-
-int64_t Buf::ReadLong() {
-  uint64_t l = Read() & 0xFF;
-  if (DINGO_LIKELY(this->le_)) {
-    for (int i = 0; i < 7; i++) {
-      l <<= 8;
-      l |= Read() & 0xFF;
-    }
-  } else {
-    for (int i = 1; i < 8; i++) {
-      l |= (((uint64_t)Read() & 0xFF) << (8 * i));
-    }
-  }
-  return l;
-}
-
-int64_t Buf::ReadLong(int pos) {
-  char* buf = buf_.data();
-  int64_t l = 0;
-  if (DINGO_LIKELY(this->le_)) {
-    l |= (buf[pos] & 0xFF);
-    l <<= 8;
-    l |= (buf[pos + 1] & 0xFF);
-    l <<= 8;
-    l |= (buf[pos + 2] & 0xFF);
-    l <<= 8;
-    l |= (buf[pos + 3] & 0xFF);
-    l <<= 8;
-    l |= (buf[pos + 4] & 0xFF);
-    l <<= 8;
-    l |= (buf[pos + 5] & 0xFF);
-    l <<= 8;
-    l |= (buf[pos + 6] & 0xFF);
-    l <<= 8;
-    l |= (buf[pos + 7] & 0xFF);
-
-  } else {
-    l |= (buf[pos + 7] & 0xFF);
-    l <<= 8;
-    l |= (buf[pos + 6] & 0xFF);
-    l <<= 8;
-    l |= (buf[pos + 5] & 0xFF);
-    l <<= 8;
-    l |= (buf[pos + 4] & 0xFF);
-    l <<= 8;
-    l |= (buf[pos + 3] & 0xFF);
-    l <<= 8;
-    l |= (buf[pos + 2] & 0xFF);
-    l <<= 8;
-    l |= (buf[pos + 1] & 0xFF);
-    l <<= 8;
-    l |= (buf[pos] & 0xFF);
-  }
-  return l;
+  memcpy(buf_.data() + curr_size, data.data(), data.size());
 }
 
-int64_t Buf::ReadLongWithFirstBitNegation() {
-  uint64_t l = (Read() & 0xFF) ^ 0x80;
-  if (IsLe()) {
-    for (int i = 0; i < 7; i++) {
-      l <<= 8;
-      l |= Read() & 0xFF;
-    }
-  } else {
-    for (int i = 1; i < 8; i++) {
-      l |= (((uint64_t)Read() & 0xFF) << (8 * i));
-    }
-  }
+const std::string& Buf::GetString() { return buf_; }
 
-  return l;
+void Buf::GetString(std::string& s) {
+  s.swap(buf_);
+  Sync();
 }
 
-void Buf::Skip(size_t size) {
-  if (DINGO_UNLIKELY(read_offset_ + size > buf_.size())) {
-    throw std::runtime_error("Out of range.");
-  }
-
-  read_offset_ += size;
+void Buf::GetString(std::string* s) {
+  s->swap(buf_);
+  Sync();
 }
 
-const std::string& Buf::GetString() { return buf_; }
-
-void Buf::GetString(std::string& s) { s.swap(buf_); }
-
-void Buf::GetString(std::string* s) { s->swap(buf_); }
-
 }  // namespace serialV2
 }  // namespace dingodb
\ No newline at end of file
@@ -18,9 +18,13 @@
 #include <cstddef>
 #include <cstdint>
 #include <iostream>
+#include <stdexcept>
 #include <string>
 
+#include "serial/utils/V2/buf_view.h"
+#include "serial/utils/V2/byte_order.h"
 #include "serial/utils/V2/compiler.h"
+#include "serial/utils/V2/varint.h"
 
 namespace dingodb {
 namespace serialV2 {
@@ -34,8 +38,11 @@ namespace serialV2 {
  *   little endian:               0x87  0xd6  0x12    >     0x84  0x18  0x22 --
  * compare wrong big endian:                  0x12  0xd6  0x87    <     0x22
  * 0x18  0x84    -- compare right
+ *
+ * Buf owns its bytes and adds the writers on top of the BufView readers; the
+ * view window is re-pointed at the owned string after every mutation.
  */
-class Buf {
+class Buf : public BufView {
  public:
   Buf(size_t capacity, bool le);
   Buf(size_t capacity);
@@ -47,50 +54,64 @@ class Buf {
   Buf(std::string&& s);
   Buf() = default;
 
-  ~Buf() = default;
-
-  // le and end checker.
-  bool IsLe() const { return le_; }
-  bool IsEnd() const { return read_offset_ == buf_.size(); }
+  Buf(const Buf& other);
+  Buf(Buf&& other) noexcept;
+  Buf& operator=(const Buf& other);
+  Buf& operator=(Buf&& other) noexcept;
 
-  /**
-   * For reader function with position parameters will not update read_offset_
-   * field. Only the reader with no position parameters will increase
-   * read_offset_ field.
-   */
+  ~Buf() = default;
 
-  // byte writter and getter.
+  // byte writter.
   void Write(uint8_t data);
   void WriteByte(size_t pos, uint8_t data);
   void WriteWithNegation(uint8_t data);
-  uint8_t Peek();
-  uint8_t Read();
-  uint8_t Read(size_t pos);
-  // uint8_t ReverseReadByte(size_t pos);
 
-  // short writter and getter.
+  // short writter.
   void WriteShort(int16_t data);
   void WriteShort(size_t pos, int16_t data);
-  int16_t ReadShort();
-  int16_t ReadShort(int pos);
-  // uint16_t ReverseReadShort(int pos);
 
-  // int writter and getter.
+  // int writter.
   void WriteInt(int32_t data);
   void WriteInt(size_t pos, int32_t data);
-  int32_t PeekInt();
-  int32_t ReadInt();
-  int32_t ReadInt(int pos);
-  // int32_t ReverseReadInt(int pos);
 
-  // long writter and getter.
+  // long writter.
   void WriteLong(int64_t data);
   void WriteLongWithNegation(int64_t data);
   void WriteLongWithFirstBitNegation(int64_t data);
-  int64_t PeekLong();
-  int64_t ReadLong();
-  int64_t ReadLong(int pos);
-  int64_t ReadLongWithFirstBitNegation();
+
+  // Fixed width writers with the byte order resolved at compile time, see
+  // BufView::ReadWire.
+  template <bool kLe, typename T>
+  void WriteWire(T data) {
+    size_t curr_size = buf_.size();
+    buf_.resize(curr_size + sizeof(T));
+    Sync();
+    StoreWire<kLe, T>(buf_.data() + curr_size, data);
+  }
+  template <bool kLe, typename T>
+  void WriteWire(size_t pos, T data) {
+    if (DINGO_UNLIKELY(buf_.size() < sizeof(T) ||
+                       pos > buf_.size() - sizeof(T))) {
+      throw std::runtime_error("Out of range.");
+    }
+    StoreWire<kLe, T>(buf_.data() + pos, data);
+  }
+  template <bool kLe, typename T>
+  void WriteWireArray(const T* data, size_t count) {
+    size_t curr_size = buf_.size();
+    buf_.resize(curr_size + count * sizeof(T));
+    Sync();
+    StoreWireArray<kLe, T>(buf_.data() + curr_size, data, count);
+  }
+
+  // LEB128 varint, returns the bytes written.
+  int WriteVarint(uint64_t data) {
+    char bytes[kMaxVarintSize];
+    int size = PutVarint(bytes, data) - bytes;
+    buf_.append(bytes, size);
+    Sync();
+    return size;
+  }
 
   // string writter and getter.
   void WriteString(const std::string& data);
@@ -98,37 +119,44 @@ class Buf {
   void GetString(std::string& s);
   void GetString(std::string* s);
 
-  // skip.
-  void Skip(size_t size);
-
   // clear.
   void Clear() {
     read_offset_ = 0;
     buf_.clear();
+    Sync();
+  }
+
+  // Take over the storage of s and start writing at its beginning, so the
+  // capacity s already has is reused. s is left empty until it is handed
+  // back with GetString(s).
+  void Adopt(std::string& s) {
+    read_offset_ = 0;
+    buf_.swap(s);
+    buf_.clear();
+    Sync();
   }
 
   // Reserve
-  void Reserve(int cap) { buf_.reserve(cap); }
+  void Reserve(int cap) {
+    buf_.reserve(cap);
+    Sync();
+  }
 
   // size.
-  size_t Size() const { return buf_.size(); }
-  void ReSize(size_t size) { buf_.resize(size); }
-  void Enlarge(size_t len);
-
-  // offset
-  size_t RestReadableSize() const { return buf_.size() - read_offset_; }
-  size_t ReadOffset() const { return read_offset_; }
-  void SetReadOffset(size_t offset) {
-    if (DINGO_UNLIKELY(offset >= buf_.size())) {
-      throw std::runtime_error("Out of range.");
-    }
-    read_offset_ = offset;
+  void ReSize(size_t size) {
+    buf_.resize(size);
+    Sync();
   }
+  void Enlarge(size_t len);
+  // Writable bytes, e.g. to fill the region Enlarge just added.
+  char* MutableData() { return buf_.data(); }
 
  private:
-  bool le_{true};
-
-  size_t read_offset_{0};
+  // Point the inherited view window at the owned bytes.
+  void Sync() {
+    data_ = buf_.data();
+    size_ = buf_.size();
+  }
 
   // for memory comparable buf_ is big endian
   std::string buf_;
@@ -0,0 +1,98 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "buf_view.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+#include "serial/utils/V2/compiler.h"
+
+namespace dingodb {
+namespace serialV2 {
+
+// pos may be a negative int converted to size_t, so nothing is added to it.
+static inline void CheckRange(size_t pos, size_t len, size_t size) {
+  if (DINGO_UNLIKELY(size < len || pos > size - len)) {
+    throw std::out_of_range("Out of range.");
+  }
+}
+
+uint8_t BufView::Peek() {
+  CheckRange(read_offset_, 1, size_);
+  return data_[read_offset_];
+}
+
+int32_t BufView::PeekInt() {
+  return le_ ? ReadWire<true, uint32_t>(read_offset_)
+             : ReadWire<false, uint32_t>(read_offset_);
+}
+
+int64_t BufView::PeekLong() {
+  return le_ ? ReadWire<true, uint64_t>(read_offset_)
+             : ReadWire<false, uint64_t>(read_offset_);
+}
+
+uint8_t BufView::Read() {
+  CheckRange(read_offset_, 1, size_);
+  return data_[read_offset_++];
+}
+
+uint8_t BufView::Read(size_t pos) {
+  CheckRange(pos, 1, size_);
+  return data_[pos];
+}
+
+int16_t BufView::ReadShort() {
+  return le_ ? ReadWire<true, uint16_t>() : ReadWire<false, uint16_t>();
+}
+
+int16_t BufView::ReadShort(int pos) {
+  return le_ ? ReadWire<true, uint16_t>(pos) : ReadWire<false, uint16_t>(pos);
+}
+
+int32_t BufView::ReadInt() {
+  return le_ ? ReadWire<true, uint32_t>() : ReadWire<false, uint32_t>();
+}
+
+int32_t BufView::ReadInt(int pos) {
+  return le_ ? ReadWire<true, uint32_t>(pos) : ReadWire<false, uint32_t>(pos);
+}
+
+int64_t BufView::ReadLong() {
+  return le_ ? ReadWire<true, uint64_t>() : ReadWire<false, uint64_t>();
+}
+
+int64_t BufView::ReadLong(int pos) {
+  return le_ ? ReadWire<true, uint64_t>(pos) : ReadWire<false, uint64_t>(pos);
+}
+
+int64_t BufView::ReadLongWithFirstBitNegation() {
+  if (DINGO_LIKELY(le_)) {
+    return ReadWire<true, uint64_t>() ^ WireSignBit<true, uint64_t>();
+  }
+  return ReadWire<false, uint64_t>() ^ WireSignBit<false, uint64_t>();
+}
+
+void BufView::Skip(size_t size) {
+  if (DINGO_UNLIKELY(size > size_ - read_offset_)) {
+    throw std::runtime_error("Out of range.");
+  }
+
+  read_offset_ += size;
+}
+
+}  // namespace serialV2
+}  // namespace dingodb
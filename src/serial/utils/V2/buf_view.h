@@ -0,0 +1,156 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGO_SERIAL_BUF_VIEW_V2_H_
+#define DINGO_SERIAL_BUF_VIEW_V2_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "serial/utils/V2/byte_order.h"
+#include "serial/utils/V2/compiler.h"
+#include "serial/utils/V2/varint.h"
+
+namespace dingodb {
+namespace serialV2 {
+
+/*
+ * Read-only, non-owning view over encoded bytes (pointer + length).
+ *
+ * The decoder reads keys and values through a BufView so that decoding a
+ * slice handed out by the storage engine never copies it. The viewed memory
+ * must outlive the view. Buf extends BufView with an owned, writable buffer,
+ * so every reader taking a BufView& also accepts a Buf.
+ */
+class BufView {
+ public:
+  BufView(const char* data, size_t size, bool le)
+      : le_(le), data_(data), size_(size) {}
+  BufView(const char* data, size_t size) : BufView(data, size, true) {}
+
+  BufView(std::string_view s, bool le) : BufView(s.data(), s.size(), le) {}
+  BufView(std::string_view s) : BufView(s.data(), s.size(), true) {}
+  BufView() = default;
+
+  ~BufView() = default;
+
+  // le and end checker.
+  bool IsLe() const { return le_; }
+  bool IsEnd() const { return read_offset_ == size_; }
+
+  /**
+   * For reader function with position parameters will not update read_offset_
+   * field. Only the reader with no position parameters will increase
+   * read_offset_ field.
+   */
+
+  // byte getter.
+  uint8_t Peek();
+  uint8_t Read();
+  uint8_t Read(size_t pos);
+
+  // short getter.
+  int16_t ReadShort();
+  int16_t ReadShort(int pos);
+
+  // int getter.
+  int32_t PeekInt();
+  int32_t ReadInt();
+  int32_t ReadInt(int pos);
+
+  // long getter.
+  int64_t PeekLong();
+  int64_t ReadLong();
+  int64_t ReadLong(int pos);
+  int64_t ReadLongWithFirstBitNegation();
+
+  // Fixed width getters with the byte order resolved at compile time, one
+  // range check and one load each. The getters above dispatch on le_ to
+  // these, codecs that already know le_ call them directly.
+  template <bool kLe, typename T>
+  T ReadWire() {
+    T data = ReadWire<kLe, T>(read_offset_);
+    read_offset_ += sizeof(T);
+    return data;
+  }
+  template <bool kLe, typename T>
+  T ReadWire(size_t pos) const {
+    // Written so a huge pos, e.g. a negative int, cannot wrap around.
+    if (DINGO_UNLIKELY(size_ < sizeof(T) || pos > size_ - sizeof(T))) {
+      throw std::out_of_range("Out of range.");
+    }
+    return LoadWire<kLe, T>(data_ + pos);
+  }
+  // Replace data with the next count values, sizing it once.
+  template <bool kLe, typename T>
+  void ReadWireArray(std::vector<T>& data, int count) {
+    if (DINGO_UNLIKELY(count < 0 ||
+                       static_cast<size_t>(count) >
+                           (size_ - read_offset_) / sizeof(T))) {
+      throw std::out_of_range("Out of range.");
+    }
+    data.resize(count);
+    LoadWireArray<kLe, T>(data.data(), data_ + read_offset_, count);
+    read_offset_ += count * sizeof(T);
+  }
+
+  // LEB128 varint, see varint.h.
+  uint64_t ReadVarint() {
+    uint64_t data;
+    int size = GetVarint(data_ + read_offset_, size_ - read_offset_, data);
+    if (DINGO_UNLIKELY(size == 0)) {
+      throw std::out_of_range("Out of range.");
+    }
+    read_offset_ += size;
+    return data;
+  }
+
+  // skip.
+  void Skip(size_t size);
+
+  // raw access.
+  const char* Data() const { return data_; }
+  std::string_view View() const { return std::string_view(data_, size_); }
+
+  // size.
+  size_t Size() const { return size_; }
+
+  // offset
+  size_t RestReadableSize() const { return size_ - read_offset_; }
+  size_t ReadOffset() const { return read_offset_; }
+  void SetReadOffset(size_t offset) {
+    if (DINGO_UNLIKELY(offset >= size_)) {
+      throw std::runtime_error("Out of range.");
+    }
+    read_offset_ = offset;
+  }
+
+ protected:
+  bool le_{true};
+
+  size_t read_offset_{0};
+
+  // for memory comparable data_ is big endian
+  const char* data_{nullptr};
+  size_t size_{0};
+};
+
+}  // namespace serialV2
+}  // namespace dingodb
+
+#endif
@@ -0,0 +1,139 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "byte_order.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace dingodb {
+namespace serialV2 {
+
+namespace {
+
+// Swaps the leading whole blocks of bytes with a per value shuffle mask and
+// returns how many bytes it handled, the caller finishes the tail.
+using SwapBlocksFunc = size_t (*)(char* dst, const char* src, size_t bytes,
+                                  const uint8_t* mask);
+
+size_t SwapBlocksNone(char*, const char*, size_t, const uint8_t*) {
+  return 0;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+__attribute__((target("ssse3"))) size_t SwapBlocksSsse3(char* dst,
+                                                         const char* src,
+                                                         size_t bytes,
+                                                         const uint8_t* mask) {
+  const __m128i shuffle =
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(mask));
+  size_t i = 0;
+  for (; i + 16 <= bytes; i += 16) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i),
+                     _mm_shuffle_epi8(v, shuffle));
+  }
+  return i;
+}
+
+// vpshufb shuffles within each 128 bit lane, so the same 16 byte mask serves
+// both halves.
+__attribute__((target("avx2"))) size_t SwapBlocksAvx2(char* dst,
+                                                       const char* src,
+                                                       size_t bytes,
+                                                       const uint8_t* mask) {
+  const __m256i shuffle = _mm256_broadcastsi128_si256(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(mask)));
+  size_t i = 0;
+  for (; i + 64 <= bytes; i += 64) {
+    __m256i v0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+    __m256i v1 =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i + 32));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i),
+                        _mm256_shuffle_epi8(v0, shuffle));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i + 32),
+                        _mm256_shuffle_epi8(v1, shuffle));
+  }
+  for (; i + 32 <= bytes; i += 32) {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i),
+                        _mm256_shuffle_epi8(v, shuffle));
+  }
+  return i;
+}
+
+#endif
+
+SwapBlocksFunc SelectSwapBlocks() {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    return SwapBlocksAvx2;
+  }
+  if (__builtin_cpu_supports("ssse3")) {
+    return SwapBlocksSsse3;
+  }
+#endif
+  return SwapBlocksNone;
+}
+
+// Shuffle masks reversing each 2, 4 and 8 byte value of a 16 byte block.
+constexpr uint8_t kSwapMask2[16] = {1, 0, 3,  2,  5,  4,  7,  6,
+                                    9, 8, 11, 10, 13, 12, 15, 14};
+constexpr uint8_t kSwapMask4[16] = {3,  2,  1,  0,  7,  6,  5,  4,
+                                    11, 10, 9,  8,  15, 14, 13, 12};
+constexpr uint8_t kSwapMask8[16] = {7,  6,  5,  4,  3,  2,  1, 0,
+                                    15, 14, 13, 12, 11, 10, 9, 8};
+
+template <typename T>
+void SwapTail(char* dst, const char* src, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    StoreWire<true, T>(dst + i * sizeof(T),
+                       LoadWire<false, T>(src + i * sizeof(T)));
+  }
+}
+
+}  // namespace
+
+void ByteSwapArray(char* dst, const char* src, size_t count, size_t width) {
+  const uint8_t* mask = width == 2   ? kSwapMask2
+                        : width == 4 ? kSwapMask4
+                                     : kSwapMask8;
+  static const SwapBlocksFunc swap_blocks = SelectSwapBlocks();
+  size_t done = swap_blocks(dst, src, count * width, mask);
+  dst += done;
+  src += done;
+  count -= done / width;
+
+  switch (width) {
+    case 2:
+      SwapTail<uint16_t>(dst, src, count);
+      break;
+    case 4:
+      SwapTail<uint32_t>(dst, src, count);
+      break;
+    default:
+      SwapTail<uint64_t>(dst, src, count);
+      break;
+  }
+}
+
+}  // namespace serialV2
+}  // namespace dingodb
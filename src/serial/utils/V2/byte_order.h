@@ -0,0 +1,97 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGO_SERIAL_BYTE_ORDER_V2_H_
+#define DINGO_SERIAL_BYTE_ORDER_V2_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace dingodb {
+namespace serialV2 {
+
+/*
+ * Fixed width integers in wire order, templated on the le flag Buf and the
+ * schemas carry. With kLe the native bytes are reversed, so a little endian
+ * host writes big endian, otherwise they are kept as they are. Each load or
+ * store is one unaligned memcpy plus at most one bswap.
+ */
+constexpr bool kHostLe = __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__;
+
+inline uint8_t ByteSwap(uint8_t data) { return data; }
+inline uint16_t ByteSwap(uint16_t data) { return __builtin_bswap16(data); }
+inline uint32_t ByteSwap(uint32_t data) { return __builtin_bswap32(data); }
+inline uint64_t ByteSwap(uint64_t data) { return __builtin_bswap64(data); }
+
+template <bool kLe, typename T>
+inline T LoadWire(const char* p) {
+  T data;
+  memcpy(&data, p, sizeof(T));
+  if constexpr (kLe) {
+    data = ByteSwap(data);
+  }
+  return data;
+}
+
+template <bool kLe, typename T>
+inline void StoreWire(char* p, T data) {
+  if constexpr (kLe) {
+    data = ByteSwap(data);
+  }
+  memcpy(p, &data, sizeof(T));
+}
+
+// Copy count values of width 2, 4 or 8 bytes from src to dst reversing the
+// bytes of each one. dst and src must not overlap. On x86 whole blocks are
+// shuffled with AVX2 or SSSE3, chosen at load time.
+void ByteSwapArray(char* dst, const char* src, size_t count, size_t width);
+
+// Array forms of LoadWire / StoreWire, a plain memcpy when the wire order is
+// the host order. Either pointer may be null when count is 0.
+template <bool kLe, typename T>
+inline void LoadWireArray(T* data, const char* p, size_t count) {
+  if (count == 0) {
+    return;
+  }
+  if constexpr (kLe && sizeof(T) > 1) {
+    ByteSwapArray(reinterpret_cast<char*>(data), p, count, sizeof(T));
+  } else {
+    memcpy(data, p, count * sizeof(T));
+  }
+}
+
+template <bool kLe, typename T>
+inline void StoreWireArray(char* p, const T* data, size_t count) {
+  if (count == 0) {
+    return;
+  }
+  if constexpr (kLe && sizeof(T) > 1) {
+    ByteSwapArray(p, reinterpret_cast<const char*>(data), count, sizeof(T));
+  } else {
+    memcpy(p, data, count * sizeof(T));
+  }
+}
+
+// Bit of a T that lands in the top bit of the first wire byte, the one the
+// comparable encodings flip.
+template <bool kLe, typename T>
+constexpr T WireSignBit() {
+  return kLe == kHostLe ? T(T(1) << (8 * sizeof(T) - 1)) : T(0x80);
+}
+
+}  // namespace serialV2
+}  // namespace dingodb
+
+#endif
@@ -0,0 +1,155 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "deflate.h"
+
+#include <zlib.h>
+
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace dingodb {
+namespace serialV2 {
+
+struct Deflater::Stream {
+  explicit Stream(int level) {
+    if (deflateInit(&zs, level) != Z_OK) {
+      throw std::runtime_error("deflateInit failed.");
+    }
+  }
+  ~Stream() { deflateEnd(&zs); }
+
+  z_stream zs{};
+};
+
+Deflater::Deflater(int level) : level_(level) {}
+
+Deflater::Deflater(const Deflater& other)
+    : level_(other.level_), dictionary_(other.dictionary_) {}
+
+Deflater& Deflater::operator=(const Deflater& other) {
+  if (this != &other) {
+    level_ = other.level_;
+    dictionary_ = other.dictionary_;
+    stream_.reset();
+  }
+  return *this;
+}
+
+Deflater::~Deflater() = default;
+
+void Deflater::SetDictionary(std::string dictionary) {
+  dictionary_ = std::move(dictionary);
+}
+
+bool Deflater::Deflate(const char* in, size_t size, size_t max_size,
+                       std::string& out) {
+  if (stream_ == nullptr) {
+    stream_ = std::make_unique<Stream>(level_);
+  }
+  z_stream& zs = stream_->zs;
+  deflateReset(&zs);
+  // The dictionary is dropped by every reset.
+  if (!dictionary_.empty() &&
+      deflateSetDictionary(&zs,
+                           reinterpret_cast<const Bytef*>(dictionary_.data()),
+                           dictionary_.size()) != Z_OK) {
+    return false;
+  }
+
+  size_t pos = out.size();
+  out.resize(pos + max_size);
+  zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(in));
+  zs.avail_in = size;
+  zs.next_out = reinterpret_cast<Bytef*>(out.data() + pos);
+  zs.avail_out = max_size;
+  // Anything but Z_STREAM_END means max_size was not enough.
+  if (deflate(&zs, Z_FINISH) != Z_STREAM_END) {
+    out.resize(pos);
+    return false;
+  }
+  out.resize(pos + max_size - zs.avail_out);
+  return true;
+}
+
+struct Inflater::Stream {
+  Stream() {
+    if (inflateInit(&zs) != Z_OK) {
+      throw std::runtime_error("inflateInit failed.");
+    }
+  }
+  ~Stream() { inflateEnd(&zs); }
+
+  z_stream zs{};
+};
+
+// Deflate expands a byte by at most 1032 times.
+static constexpr size_t kMaxInflateRatio = 1032;
+
+Inflater::Inflater() = default;
+
+Inflater::Inflater(const Inflater& other) : dictionary_(other.dictionary_) {}
+
+Inflater& Inflater::operator=(const Inflater& other) {
+  if (this != &other) {
+    dictionary_ = other.dictionary_;
+    stream_.reset();
+  }
+  return *this;
+}
+
+Inflater::~Inflater() = default;
+
+void Inflater::SetDictionary(std::string dictionary) {
+  dictionary_ = std::move(dictionary);
+}
+
+bool Inflater::Inflate(const char* in, size_t size, size_t raw_size,
+                       std::string& out) {
+  if (raw_size > size * kMaxInflateRatio) {
+    return false;
+  }
+  if (stream_ == nullptr) {
+    stream_ = std::make_unique<Stream>();
+  }
+  z_stream& zs = stream_->zs;
+  inflateReset(&zs);
+
+  size_t pos = out.size();
+  out.resize(pos + raw_size);
+  zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(in));
+  zs.avail_in = size;
+  zs.next_out = reinterpret_cast<Bytef*>(out.data() + pos);
+  zs.avail_out = raw_size;
+  int ret = inflate(&zs, Z_FINISH);
+  // The stream asks for the dictionary before any output, a mismatching one
+  // is refused by its checksum.
+  if (ret == Z_NEED_DICT && !dictionary_.empty() &&
+      inflateSetDictionary(&zs,
+                           reinterpret_cast<const Bytef*>(dictionary_.data()),
+                           dictionary_.size()) == Z_OK) {
+    ret = inflate(&zs, Z_FINISH);
+  }
+  if (ret != Z_STREAM_END || zs.avail_out != 0 || zs.avail_in != 0) {
+    out.resize(pos);
+    return false;
+  }
+  return true;
+}
+
+}  // namespace serialV2
+}  // namespace dingodb
@@ -0,0 +1,83 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGO_SERIAL_DEFLATE_V2_H_
+#define DINGO_SERIAL_DEFLATE_V2_H_
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace dingodb {
+namespace serialV2 {
+
+/*
+ * zlib streams kept across calls, so deflating or inflating many values
+ * allocates the zlib state once and only resets it per value. A preset
+ * dictionary primes the window with bytes typical of the data, e.g. sample
+ * values of a table, which lets small values compress. zlib records the
+ * dictionary checksum in the stream, so inflating with another dictionary
+ * fails instead of producing garbage. Copies take the settings only.
+ */
+class Deflater {
+ public:
+  // level as for deflateInit, -1 is zlib's default.
+  explicit Deflater(int level = -1);
+  Deflater(const Deflater& other);
+  Deflater& operator=(const Deflater& other);
+  ~Deflater();
+
+  void SetDictionary(std::string dictionary);
+  const std::string& GetDictionary() const { return dictionary_; }
+
+  // Append the size bytes at in deflated to out. Returns false, with out as
+  // it was, when they take more than max_size bytes.
+  bool Deflate(const char* in, size_t size, size_t max_size,
+               std::string& out);
+
+ private:
+  struct Stream;
+
+  int level_;
+  std::string dictionary_;
+  std::unique_ptr<Stream> stream_;
+};
+
+class Inflater {
+ public:
+  Inflater();
+  Inflater(const Inflater& other);
+  Inflater& operator=(const Inflater& other);
+  ~Inflater();
+
+  void SetDictionary(std::string dictionary);
+  const std::string& GetDictionary() const { return dictionary_; }
+
+  // Append the size bytes at in, which inflate to raw_size bytes, to out.
+  // Returns false, with out as it was, when they are corrupt, inflate to
+  // another size or need another dictionary.
+  bool Inflate(const char* in, size_t size, size_t raw_size,
+               std::string& out);
+
+ private:
+  struct Stream;
+
+  std::string dictionary_;
+  std::unique_ptr<Stream> stream_;
+};
+
+}  // namespace serialV2
+}  // namespace dingodb
+
+#endif
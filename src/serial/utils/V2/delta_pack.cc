@@ -0,0 +1,267 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "delta_pack.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+#include "byte_order.h"
+
+namespace dingodb {
+namespace serialV2 {
+
+namespace {
+
+template <typename T>
+using Unsigned = std::make_unsigned_t<T>;
+
+// first, min delta and width.
+template <typename T>
+constexpr size_t kHeaderSize = 2 * sizeof(T) + 1;
+
+inline size_t PackedBytes(size_t deltas, int width) {
+  return (deltas * width + 7) / 8;
+}
+
+inline int BitWidth(uint64_t data) {
+  return data == 0 ? 0 : 64 - __builtin_clzll(data);
+}
+
+template <typename T>
+inline Unsigned<T> Delta(const T* data, size_t i) {
+  return Unsigned<T>(data[i]) - Unsigned<T>(data[i - 1]);
+}
+
+// Smallest delta of a block and the bits the others take above it.
+template <typename T>
+void BlockFrame(const T* data, size_t count, Unsigned<T>& min, int& width) {
+  min = 0;
+  width = 0;
+  if (count < 2) {
+    return;
+  }
+  T lo = static_cast<T>(Delta(data, 1));
+  T hi = lo;
+  for (size_t i = 2; i < count; ++i) {
+    T delta = static_cast<T>(Delta(data, i));
+    lo = std::min(lo, delta);
+    hi = std::max(hi, delta);
+  }
+  min = Unsigned<T>(lo);
+  width = BitWidth(Unsigned<T>(Unsigned<T>(hi) - min));
+}
+
+template <typename T>
+size_t PackSize(const T* data, size_t count) {
+  size_t size = 0;
+  for (size_t i = 0; i < count; i += kDeltaPackBlock) {
+    size_t n = std::min(kDeltaPackBlock, count - i);
+    Unsigned<T> min;
+    int width;
+    BlockFrame(data + i, n, min, width);
+    size += kHeaderSize<T> + PackedBytes(n - 1, width);
+  }
+  return size;
+}
+
+// Returns the bytes written.
+template <typename T>
+size_t EncodeBlock(const T* data, size_t count, char* out) {
+  Unsigned<T> min;
+  int width;
+  BlockFrame(data, count, min, width);
+  StoreWire<!kHostLe, Unsigned<T>>(out, Unsigned<T>(data[0]));
+  StoreWire<!kHostLe, Unsigned<T>>(out + sizeof(T), min);
+  out[2 * sizeof(T)] = static_cast<char>(width);
+
+  char* p = out + kHeaderSize<T>;
+  uint64_t bits = 0;
+  int used = 0;
+  for (size_t i = 1; i < count; ++i) {
+    uint64_t delta = Unsigned<T>(Delta(data, i) - min);
+    bits |= delta << used;
+    if (used + width >= 64) {
+      StoreWire<!kHostLe, uint64_t>(p, bits);
+      p += 8;
+      bits = used == 0 ? 0 : delta >> (64 - used);
+      used = used + width - 64;
+    } else {
+      used += width;
+    }
+  }
+  for (; used > 0; used -= 8) {
+    *p++ = static_cast<char>(bits);
+    bits >>= 8;
+  }
+  return p - out;
+}
+
+template <typename T>
+void PackEncode(const T* data, size_t count, char* out) {
+  for (size_t i = 0; i < count; i += kDeltaPackBlock) {
+    out += EncodeBlock(data + i, std::min(kDeltaPackBlock, count - i), out);
+  }
+}
+
+// Unpack count values of kWidth bits. Each one is a single unaligned load,
+// plus one byte past it for widths over 56, so 9 bytes past the packed ones
+// must be readable. The constant width lets the compiler unroll and
+// vectorize the loop.
+template <size_t kWidth>
+void Unpack(const uint8_t* in, size_t count, uint64_t* out) {
+  constexpr uint64_t kMask = kWidth == 64 ? ~0ULL : (1ULL << kWidth) - 1;
+  for (size_t i = 0; i < count; ++i) {
+    size_t bit = i * kWidth;
+    const uint8_t* p = in + bit / 8;
+    int shift = bit % 8;
+    uint64_t data =
+        LoadWire<!kHostLe, uint64_t>(reinterpret_cast<const char*>(p)) >>
+        shift;
+    if constexpr (kWidth > 56) {
+      if (shift != 0) {
+        data |= static_cast<uint64_t>(p[8]) << (64 - shift);
+      }
+    }
+    out[i] = data & kMask;
+  }
+}
+
+using UnpackFunc = void (*)(const uint8_t* in, size_t count, uint64_t* out);
+
+template <size_t... kWidths>
+constexpr std::array<UnpackFunc, sizeof...(kWidths)> MakeUnpackTable(
+    std::index_sequence<kWidths...>) {
+  return {&Unpack<kWidths>...};
+}
+
+constexpr auto kUnpack = MakeUnpackTable(std::make_index_sequence<65>());
+
+constexpr size_t kUnpackPadding = 9;
+
+// Bytes of the block of count values at in, 0 when it is cut short or its
+// width does not fit T.
+template <typename T>
+size_t BlockSize(const char* in, size_t size, size_t count, int& width) {
+  if (size < kHeaderSize<T>) {
+    return 0;
+  }
+  width = static_cast<uint8_t>(in[2 * sizeof(T)]);
+  if (width > 8 * static_cast<int>(sizeof(T))) {
+    return 0;
+  }
+  size_t block_size = kHeaderSize<T> + PackedBytes(count - 1, width);
+  return block_size <= size ? block_size : 0;
+}
+
+template <typename T>
+size_t DecodeBlock(const char* in, size_t size, size_t count, T* data) {
+  int width;
+  size_t block_size = BlockSize<T>(in, size, count, width);
+  if (block_size == 0) {
+    return 0;
+  }
+
+  const uint8_t* packed =
+      reinterpret_cast<const uint8_t*>(in + kHeaderSize<T>);
+  // Near the end of the input the packed bytes go through a padded copy.
+  uint8_t copy[kDeltaPackBlock * 8 + kUnpackPadding];
+  if (block_size + kUnpackPadding > size) {
+    size_t packed_size = block_size - kHeaderSize<T>;
+    memcpy(copy, packed, packed_size);
+    memset(copy + packed_size, 0, kUnpackPadding);
+    packed = copy;
+  }
+  uint64_t deltas[kDeltaPackBlock];
+  kUnpack[width](packed, count - 1, deltas);
+
+  Unsigned<T> value = LoadWire<!kHostLe, Unsigned<T>>(in);
+  Unsigned<T> min = LoadWire<!kHostLe, Unsigned<T>>(in + sizeof(T));
+  data[0] = static_cast<T>(value);
+  for (size_t i = 1; i < count; ++i) {
+    value += min + static_cast<Unsigned<T>>(deltas[i - 1]);
+    data[i] = static_cast<T>(value);
+  }
+  return block_size;
+}
+
+template <typename T>
+size_t PackDecode(const char* in, size_t size, size_t count, T* data) {
+  size_t pos = 0;
+  for (size_t i = 0; i < count; i += kDeltaPackBlock) {
+    size_t used = DecodeBlock(in + pos, size - pos,
+                              std::min(kDeltaPackBlock, count - i), data + i);
+    if (used == 0) {
+      return 0;
+    }
+    pos += used;
+  }
+  return pos;
+}
+
+}  // namespace
+
+size_t DeltaPackSize(const int32_t* data, size_t count) {
+  return PackSize(data, count);
+}
+
+size_t DeltaPackSize(const int64_t* data, size_t count) {
+  return PackSize(data, count);
+}
+
+void DeltaPackEncode(const int32_t* data, size_t count, char* out) {
+  PackEncode(data, count, out);
+}
+
+void DeltaPackEncode(const int64_t* data, size_t count, char* out) {
+  PackEncode(data, count, out);
+}
+
+size_t DeltaPackDecode(const char* in, size_t size, size_t count,
+                       int32_t* data) {
+  return PackDecode(in, size, count, data);
+}
+
+size_t DeltaPackDecode(const char* in, size_t size, size_t count,
+                       int64_t* data) {
+  return PackDecode(in, size, count, data);
+}
+
+template <typename T>
+size_t DeltaPackScan(const char* in, size_t size, size_t count) {
+  size_t pos = 0;
+  for (size_t i = 0; i < count; i += kDeltaPackBlock) {
+    int width;
+    size_t used = BlockSize<T>(in + pos, size - pos,
+                               std::min(kDeltaPackBlock, count - i), width);
+    if (used == 0) {
+      return 0;
+    }
+    pos += used;
+  }
+  return pos;
+}
+
+template size_t DeltaPackScan<int32_t>(const char* in, size_t size,
+                                       size_t count);
+template size_t DeltaPackScan<int64_t>(const char* in, size_t size,
+                                       size_t count);
+
+}  // namespace serialV2
+}  // namespace dingodb
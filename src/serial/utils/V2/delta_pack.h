@@ -0,0 +1,155 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGO_SERIAL_DELTA_PACK_V2_H_
+#define DINGO_SERIAL_DELTA_PACK_V2_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#include "byte_order.h"
+
+namespace dingodb {
+namespace serialV2 {
+
+/*
+ * Delta pack for int and long lists that grow steadily, e.g. timestamps.
+ * Values are cut into blocks of kDeltaPackBlock, each one is
+ *   {first: T}|{min delta: T}|{width: 1byte}|{packed deltas}
+ * where the count - 1 deltas between neighbours minus the smallest of them
+ * are bit packed width bits each, low bits first. T is little endian, so the
+ * format does not depend on the le flag. Deltas wrap like unsigned values,
+ * so any list round trips, a regular series packs to width 0.
+ */
+constexpr size_t kDeltaPackBlock = 128;
+
+size_t DeltaPackSize(const int32_t* data, size_t count);
+size_t DeltaPackSize(const int64_t* data, size_t count);
+
+// Encode count values into out, which has DeltaPackSize bytes.
+void DeltaPackEncode(const int32_t* data, size_t count, char* out);
+void DeltaPackEncode(const int64_t* data, size_t count, char* out);
+
+// Decode count values from the size bytes at in, returns the bytes consumed
+// or 0 when in is too short or holds an invalid width. Nothing is consumed
+// for a zero count either.
+size_t DeltaPackDecode(const char* in, size_t size, size_t count,
+                       int32_t* data);
+size_t DeltaPackDecode(const char* in, size_t size, size_t count,
+                       int64_t* data);
+
+// Bytes the count values at in take, checked like DeltaPackDecode but
+// without decoding them.
+template <typename T>
+size_t DeltaPackScan(const char* in, size_t size, size_t count);
+
+/*
+ * Streams a list one block at a time instead of materializing it. It reads
+ * either form a delta list column is written in, delta packed or raw wire
+ * values. The bytes are borrowed and must have been checked, e.g. by
+ * DeltaPackScan, they must outlive the reader.
+ */
+template <typename T>
+class DeltaListReader {
+ public:
+  void ResetDelta(const char* in, size_t size, size_t count) {
+    Reset(in, size, count);
+    raw_ = false;
+  }
+
+  // count values of sizeof(T) bytes in wire order, see byte_order.h.
+  void ResetRaw(const char* in, size_t count, bool le) {
+    Reset(in, count * sizeof(T), count);
+    raw_ = true;
+    le_ = le;
+  }
+
+  size_t Size() const { return count_; }
+  size_t Remaining() const { return count_ - done_; }
+
+  bool Next(T& data) {
+    if (pos_ == block_size_ && !Refill()) {
+      return false;
+    }
+    data = block_[pos_++];
+    ++done_;
+    return true;
+  }
+
+  // Copy up to max of the next values into data, returns how many.
+  size_t Read(T* data, size_t max) {
+    size_t n = 0;
+    while (n < max && (pos_ < block_size_ || Refill())) {
+      size_t k = std::min(max - n, block_size_ - pos_);
+      std::copy(block_ + pos_, block_ + pos_ + k, data + n);
+      pos_ += k;
+      done_ += k;
+      n += k;
+    }
+    return n;
+  }
+
+ private:
+  void Reset(const char* in, size_t size, size_t count) {
+    in_ = in;
+    size_ = size;
+    count_ = count;
+    done_ = 0;
+    block_size_ = 0;
+    pos_ = 0;
+  }
+
+  bool Refill() {
+    size_t n = std::min(kDeltaPackBlock, Remaining());
+    if (n == 0) {
+      return false;
+    }
+    size_t used;
+    if (raw_) {
+      used = n * sizeof(T);
+      if (le_) {
+        LoadWireArray<true>(block_, in_, n);
+      } else {
+        LoadWireArray<false>(block_, in_, n);
+      }
+    } else {
+      used = DeltaPackDecode(in_, size_, n, block_);
+      if (used == 0) {
+        return false;
+      }
+    }
+    in_ += used;
+    size_ -= used;
+    block_size_ = n;
+    pos_ = 0;
+    return true;
+  }
+
+  const char* in_{nullptr};
+  size_t size_{0};
+  size_t count_{0};
+  // Values handed out so far.
+  size_t done_{0};
+  bool raw_{false};
+  bool le_{false};
+  T block_[kDeltaPackBlock];
+  size_t block_size_{0};
+  size_t pos_{0};
+};
+
+}  // namespace serialV2
+}  // namespace dingodb
+
+#endif
@@ -0,0 +1,188 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGO_SERIAL_INT_LIST_V2_H_
+#define DINGO_SERIAL_INT_LIST_V2_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "serial/utils/V2/buf.h"
+#include "serial/utils/V2/buf_view.h"
+#include "serial/utils/V2/compiler.h"
+#include "serial/utils/V2/delta_pack.h"
+#include "serial/utils/V2/varint.h"
+
+namespace dingodb {
+namespace serialV2 {
+
+/*
+ * Value forms shared by the int and long list schemas, T is int32_t or
+ * int64_t:
+ *   raw     {n:4byte}|{value: sizeof(T)}*n, in wire order
+ *   compact {n:4byte}|stream vbyte of the values, see varint.h
+ *   delta   {n | kDeltaListFlag:4byte}|delta pack of the values
+ * The raw and delta forms are read by the same decoders.
+ */
+constexpr uint32_t kDeltaListFlag = 0x80000000;
+
+// Bytes the delta packed count values at the read offset of buf take.
+template <typename T>
+size_t ScanDeltaList(const BufView& buf, size_t count) {
+  size_t used = DeltaPackScan<T>(buf.Data() + buf.ReadOffset(),
+                                 buf.RestReadableSize(), count);
+  if (DINGO_UNLIKELY(used == 0 && count > 0)) {
+    throw std::out_of_range("Out of range.");
+  }
+  return used;
+}
+
+template <typename T>
+void EncodeRawList(const std::vector<T>& data, bool le, Buf& buf) {
+  buf.WriteInt(data.size());
+
+  if (DINGO_LIKELY(le)) {
+    buf.WriteWireArray<true>(data.data(), data.size());
+  } else {
+    buf.WriteWireArray<false>(data.data(), data.size());
+  }
+}
+
+template <typename T>
+int EncodedRawListSize(const std::vector<T>& data) {
+  return data.size() * sizeof(T) + 4;
+}
+
+// Decode a list of the raw or delta form.
+template <typename T>
+void DecodeList(BufView& buf, bool le, std::vector<T>& data) {
+  int size = buf.ReadInt();
+  if (size < 0) {
+    size_t count = static_cast<uint32_t>(size) & ~kDeltaListFlag;
+    size_t used = ScanDeltaList<T>(buf, count);
+    data.resize(count);
+    DeltaPackDecode(buf.Data() + buf.ReadOffset(), buf.RestReadableSize(),
+                    count, data.data());
+    buf.Skip(used);
+    return;
+  }
+
+  if (DINGO_LIKELY(le)) {
+    buf.ReadWireArray<true>(data, size);
+  } else {
+    buf.ReadWireArray<false>(data, size);
+  }
+}
+
+// Skip a list of the raw or delta form, returns the bytes skipped.
+template <typename T>
+int SkipList(BufView& buf) {
+  int size = buf.ReadInt();
+  if (size < 0) {
+    size_t count = static_cast<uint32_t>(size) & ~kDeltaListFlag;
+    size = ScanDeltaList<T>(buf, count);
+  } else {
+    size *= sizeof(T);
+  }
+  buf.Skip(size);
+
+  return size + 4;
+}
+
+template <typename T>
+int EncodeCompactList(const std::vector<T>& data, Buf& buf) {
+  buf.WriteInt(data.size());
+  size_t pos = buf.Size();
+  size_t size = StreamVByteSize(data.data(), data.size());
+  buf.Enlarge(size);
+  StreamVByteEncode(data.data(), data.size(), buf.MutableData() + pos);
+
+  return size + 4;
+}
+
+template <typename T>
+int EncodedCompactListSize(const std::vector<T>& data) {
+  return StreamVByteSize(data.data(), data.size()) + 4;
+}
+
+template <typename T>
+void DecodeCompactList(BufView& buf, std::vector<T>& data) {
+  int size = buf.ReadInt();
+  // Every value takes at least one byte.
+  if (DINGO_UNLIKELY(size < 0 ||
+                     static_cast<size_t>(size) > buf.RestReadableSize())) {
+    throw std::out_of_range("Out of range.");
+  }
+
+  data.resize(size);
+  size_t used = StreamVByteDecode(buf.Data() + buf.ReadOffset(),
+                                  buf.RestReadableSize(), size, data.data());
+  if (DINGO_UNLIKELY(used == 0 && size > 0)) {
+    throw std::out_of_range("Out of range.");
+  }
+  buf.Skip(used);
+}
+
+// Writes the delta form, or the raw form when that is not larger.
+template <typename T>
+int EncodeDeltaList(const std::vector<T>& data, bool le, Buf& buf) {
+  size_t size = DeltaPackSize(data.data(), data.size());
+  if (size >= data.size() * sizeof(T)) {
+    EncodeRawList(data, le, buf);
+    return EncodedRawListSize(data);
+  }
+
+  buf.WriteInt(data.size() | kDeltaListFlag);
+  size_t pos = buf.Size();
+  buf.Enlarge(size);
+  DeltaPackEncode(data.data(), data.size(), buf.MutableData() + pos);
+
+  return size + 4;
+}
+
+template <typename T>
+int EncodedDeltaListSize(const std::vector<T>& data) {
+  return std::min(DeltaPackSize(data.data(), data.size()),
+                  data.size() * sizeof(T)) +
+         4;
+}
+
+// Point reader at a list of the raw or delta form, buf must outlive it.
+template <typename T>
+void DecodeList(BufView& buf, bool le, DeltaListReader<T>& reader) {
+  int size = buf.ReadInt();
+  const char* data = buf.Data() + buf.ReadOffset();
+  if (size < 0) {
+    size_t count = static_cast<uint32_t>(size) & ~kDeltaListFlag;
+    size_t used = ScanDeltaList<T>(buf, count);
+    reader.ResetDelta(data, buf.RestReadableSize(), count);
+    buf.Skip(used);
+    return;
+  }
+
+  if (DINGO_UNLIKELY(static_cast<size_t>(size) >
+                     buf.RestReadableSize() / sizeof(T))) {
+    throw std::out_of_range("Out of range.");
+  }
+  reader.ResetRaw(data, size, le);
+  buf.Skip(size * sizeof(T));
+}
+
+}  // namespace serialV2
+}  // namespace dingodb
+
+#endif
@@ -0,0 +1,261 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "varint.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace dingodb {
+namespace serialV2 {
+
+namespace {
+
+template <typename T>
+struct StreamVByte;
+
+template <>
+struct StreamVByte<int32_t> {
+  using Unsigned = uint32_t;
+  static constexpr int kCodeBits = 2;
+};
+
+template <>
+struct StreamVByte<int64_t> {
+  using Unsigned = uint64_t;
+  static constexpr int kCodeBits = 4;
+};
+
+template <typename T>
+constexpr int kCodesPerByte = 8 / StreamVByte<T>::kCodeBits;
+
+template <typename T>
+constexpr int kCodeMask = (1 << StreamVByte<T>::kCodeBits) - 1;
+
+template <typename T>
+inline size_t ControlSize(size_t count) {
+  return (count + kCodesPerByte<T> - 1) / kCodesPerByte<T>;
+}
+
+template <typename T>
+inline int Code(const uint8_t* control, size_t i) {
+  return (control[i / kCodesPerByte<T>] >>
+          (StreamVByte<T>::kCodeBits * (i % kCodesPerByte<T>))) &
+         kCodeMask<T>;
+}
+
+inline int ByteLength(uint64_t data) {
+  return data == 0 ? 1 : (64 - __builtin_clzll(data) + 7) / 8;
+}
+
+// Per control byte: the shuffle expanding its values from 16 input bytes
+// and the bytes they take, 0 when a code is past the value width.
+struct ControlTable {
+  uint8_t shuffle[256][16];
+  uint8_t length[256];
+};
+
+template <typename T>
+constexpr ControlTable BuildControlTable() {
+  ControlTable table{};
+  for (int control = 0; control < 256; ++control) {
+    int offset = 0;
+    bool valid = true;
+    for (int k = 0; k < kCodesPerByte<T>; ++k) {
+      int length = ((control >> (StreamVByte<T>::kCodeBits * k)) &
+                    kCodeMask<T>) +
+                   1;
+      valid = valid && length <= static_cast<int>(sizeof(T));
+      for (int j = 0; j < static_cast<int>(sizeof(T)); ++j) {
+        table.shuffle[control][k * sizeof(T) + j] =
+            j < length && valid ? offset + j : 0x80;
+      }
+      offset += length;
+    }
+    table.length[control] = valid ? offset : 0;
+  }
+  return table;
+}
+
+template <typename T>
+constexpr ControlTable kControlTable = BuildControlTable<T>();
+
+// Expand whole control bytes while 16 input bytes are readable, returns how
+// many were done and advances pos past their values.
+template <typename T>
+using DecodeBlocksFunc = size_t (*)(const uint8_t* control, size_t blocks,
+                                    const char* in, size_t size, size_t& pos,
+                                    T* data);
+
+template <typename T>
+size_t DecodeBlocksNone(const uint8_t*, size_t, const char*, size_t, size_t&,
+                        T*) {
+  return 0;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+template <typename T>
+__attribute__((target("ssse3"))) size_t DecodeBlocksSsse3(
+    const uint8_t* control, size_t blocks, const char* in, size_t size,
+    size_t& pos, T* data) {
+  const auto& table = kControlTable<T>;
+  const __m128i zero = _mm_setzero_si128();
+  size_t block = 0;
+  for (; block < blocks && pos + 16 <= size; ++block) {
+    uint8_t c = control[block];
+    __m128i bytes =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + pos));
+    __m128i shuffle =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(table.shuffle[c]));
+    __m128i values = _mm_shuffle_epi8(bytes, shuffle);
+    // Zigzag decode, (v >> 1) ^ -(v & 1).
+    if constexpr (sizeof(T) == 4) {
+      __m128i sign =
+          _mm_sub_epi32(zero, _mm_and_si128(values, _mm_set1_epi32(1)));
+      values = _mm_xor_si128(_mm_srli_epi32(values, 1), sign);
+    } else {
+      __m128i sign =
+          _mm_sub_epi64(zero, _mm_and_si128(values, _mm_set1_epi64x(1)));
+      values = _mm_xor_si128(_mm_srli_epi64(values, 1), sign);
+    }
+    _mm_storeu_si128(
+        reinterpret_cast<__m128i*>(data + block * kCodesPerByte<T>), values);
+    pos += table.length[c];
+  }
+  return block;
+}
+
+#endif
+
+template <typename T>
+DecodeBlocksFunc<T> SelectDecodeBlocks() {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("ssse3")) {
+    return DecodeBlocksSsse3<T>;
+  }
+#endif
+  return DecodeBlocksNone<T>;
+}
+
+template <typename T>
+size_t EncodedSize(const T* data, size_t count) {
+  size_t size = ControlSize<T>(count);
+  for (size_t i = 0; i < count; ++i) {
+    size += ByteLength(ZigZagEncode(data[i]));
+  }
+  return size;
+}
+
+template <typename T>
+void Encode(const T* data, size_t count, char* out) {
+  auto* control = reinterpret_cast<uint8_t*>(out);
+  size_t control_size = ControlSize<T>(count);
+  memset(control, 0, control_size);
+  char* p = out + control_size;
+  for (size_t i = 0; i < count; ++i) {
+    auto value = ZigZagEncode(data[i]);
+    int length = ByteLength(value);
+    control[i / kCodesPerByte<T>] |=
+        (length - 1) << (StreamVByte<T>::kCodeBits * (i % kCodesPerByte<T>));
+    for (int j = 0; j < length; ++j) {
+      *p++ = static_cast<char>(value >> (8 * j));
+    }
+  }
+}
+
+template <typename T>
+size_t Decode(const char* in, size_t size, size_t count, T* data) {
+  using Unsigned = typename StreamVByte<T>::Unsigned;
+  const auto& table = kControlTable<T>;
+  const auto* control = reinterpret_cast<const uint8_t*>(in);
+  size_t control_size = ControlSize<T>(count);
+  if (control_size > size) {
+    return 0;
+  }
+
+  // Bytes of all values, the unused codes of a last partial control byte
+  // are not counted.
+  size_t blocks = count / kCodesPerByte<T>;
+  size_t data_size = 0;
+  for (size_t block = 0; block < blocks; ++block) {
+    if (table.length[control[block]] == 0) {
+      return 0;
+    }
+    data_size += table.length[control[block]];
+  }
+  for (size_t i = blocks * kCodesPerByte<T>; i < count; ++i) {
+    int length = Code<T>(control, i) + 1;
+    if (length > static_cast<int>(sizeof(T))) {
+      return 0;
+    }
+    data_size += length;
+  }
+  if (data_size > size - control_size) {
+    return 0;
+  }
+
+  static const DecodeBlocksFunc<T> decode_blocks = SelectDecodeBlocks<T>();
+  size_t pos = control_size;
+  size_t done =
+      decode_blocks(control, blocks, in, size, pos, data) * kCodesPerByte<T>;
+  for (size_t i = done; i < count; ++i) {
+    int length = Code<T>(control, i) + 1;
+    Unsigned value = 0;
+    for (int j = 0; j < length; ++j) {
+      value |= static_cast<Unsigned>(static_cast<uint8_t>(in[pos + j]))
+               << (8 * j);
+    }
+    data[i] = ZigZagDecode(value);
+    pos += length;
+  }
+  return pos;
+}
+
+}  // namespace
+
+size_t StreamVByteSize(const int32_t* data, size_t count) {
+  return EncodedSize(data, count);
+}
+
+size_t StreamVByteSize(const int64_t* data, size_t count) {
+  return EncodedSize(data, count);
+}
+
+void StreamVByteEncode(const int32_t* data, size_t count, char* out) {
+  Encode(data, count, out);
+}
+
+void StreamVByteEncode(const int64_t* data, size_t count, char* out) {
+  Encode(data, count, out);
+}
+
+size_t StreamVByteDecode(const char* in, size_t size, size_t count,
+                         int32_t* data) {
+  return Decode(in, size, count, data);
+}
+
+size_t StreamVByteDecode(const char* in, size_t size, size_t count,
+                         int64_t* data) {
+  return Decode(in, size, count, data);
+}
+
+}  // namespace serialV2
+}  // namespace dingodb
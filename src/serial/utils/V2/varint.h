@@ -0,0 +1,100 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGO_SERIAL_VARINT_V2_H_
+#define DINGO_SERIAL_VARINT_V2_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace dingodb {
+namespace serialV2 {
+
+/*
+ * Compact integer codecs for value columns. Signed values are zigzag mapped
+ * first, so small magnitudes of either sign get short codes. Both formats
+ * are defined byte by byte and do not depend on the le flag.
+ */
+inline uint32_t ZigZagEncode(int32_t data) {
+  return (static_cast<uint32_t>(data) << 1) ^ static_cast<uint32_t>(data >> 31);
+}
+inline uint64_t ZigZagEncode(int64_t data) {
+  return (static_cast<uint64_t>(data) << 1) ^ static_cast<uint64_t>(data >> 63);
+}
+inline int32_t ZigZagDecode(uint32_t data) {
+  return static_cast<int32_t>((data >> 1) ^ (0U - (data & 1)));
+}
+inline int64_t ZigZagDecode(uint64_t data) {
+  return static_cast<int64_t>((data >> 1) ^ (0ULL - (data & 1)));
+}
+
+// LEB128: 7 bits per byte, low group first, the top bit set on every byte
+// but the last.
+constexpr int kMaxVarintSize = 10;
+
+inline int VarintSize(uint64_t data) {
+  return data == 0 ? 1 : (64 - __builtin_clzll(data) + 6) / 7;
+}
+
+inline char* PutVarint(char* p, uint64_t data) {
+  while (data >= 0x80) {
+    *p++ = static_cast<char>(data | 0x80);
+    data >>= 7;
+  }
+  *p++ = static_cast<char>(data);
+  return p;
+}
+
+// Bytes read from the size bytes at p, 0 when they end before the last byte
+// or it is past kMaxVarintSize.
+inline int GetVarint(const char* p, size_t size, uint64_t& data) {
+  data = 0;
+  for (int i = 0; i < kMaxVarintSize && static_cast<size_t>(i) < size; ++i) {
+    uint8_t byte = p[i];
+    data |= static_cast<uint64_t>(byte & 0x7F) << (7 * i);
+    if (byte < 0x80) {
+      return i + 1;
+    }
+  }
+  return 0;
+}
+
+/*
+ * Stream VByte for int and long lists: all length codes come first, then
+ * the value bytes, little endian with leading zero bytes dropped.
+ *   int:  4 codes per control byte, 2 bits each (1 to 4 bytes).
+ *   long: 2 codes per control byte, 4 bits each (1 to 8 bytes).
+ * Code i of a control byte sits in its low bits first. Keeping the lengths
+ * apart lets the decoder expand 16 bytes of values per control byte with one
+ * shuffle, SSSE3 is used when the CPU has it.
+ */
+size_t StreamVByteSize(const int32_t* data, size_t count);
+size_t StreamVByteSize(const int64_t* data, size_t count);
+
+// Encode count values into out, which has StreamVByteSize bytes.
+void StreamVByteEncode(const int32_t* data, size_t count, char* out);
+void StreamVByteEncode(const int64_t* data, size_t count, char* out);
+
+// Decode count values from the size bytes at in, returns the bytes consumed
+// or 0 when in is too short or holds an invalid length code. Nothing is
+// consumed for a zero count either.
+size_t StreamVByteDecode(const char* in, size_t size, size_t count,
+                         int32_t* data);
+size_t StreamVByteDecode(const char* in, size_t size, size_t count,
+                         int64_t* data);
+
+}  // namespace serialV2
+}  // namespace dingodb
+
+#endif
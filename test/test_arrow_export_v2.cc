@@ -0,0 +1,291 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "serial/record/V2/arrow_export.h"
+#include "serial/record/V2/column_vector.h"
+#include "serial/record/V2/record_decoder.h"
+#include "serial/record/V2/record_encoder.h"
+#include "serial/record/V2/value.h"
+#include "serial/schema/V2/base_schema.h"
+#include "serial/utils/V2/keyvalue.h"
+
+using namespace dingodb::serialV2;
+
+template <typename T>
+static BaseSchemaPtr NewSchema(int index, const std::string& name,
+                               bool is_key, bool allow_null) {
+  auto schema = std::make_shared<DingoSchema<T>>();
+  schema->SetIndex(index);
+  schema->SetName(name);
+  schema->SetIsKey(is_key);
+  schema->SetAllowNull(allow_null);
+  return schema;
+}
+
+// Read the exported buffers back the way an Arrow consumer does.
+static bool ArrowIsNull(const ArrowArray* array, int64_t row) {
+  const auto* validity = static_cast<const uint8_t*>(array->buffers[0]);
+  return validity != nullptr && (validity[row >> 3] & (1 << (row & 7))) == 0;
+}
+
+template <typename T>
+static T ArrowValue(const ArrowArray* array, int64_t row) {
+  return static_cast<const T*>(array->buffers[1])[row];
+}
+
+static bool ArrowBool(const ArrowArray* array, int64_t row) {
+  const auto* bits = static_cast<const uint8_t*>(array->buffers[1]);
+  return (bits[row >> 3] & (1 << (row & 7))) != 0;
+}
+
+static std::string_view ArrowString(const ArrowArray* array, int64_t row) {
+  const auto* offsets = static_cast<const int32_t*>(array->buffers[1]);
+  const auto* bytes = static_cast<const char*>(array->buffers[2]);
+  return std::string_view(bytes + offsets[row],
+                          offsets[row + 1] - offsets[row]);
+}
+
+static int32_t ArrowListBegin(const ArrowArray* array, int64_t row) {
+  return static_cast<const int32_t*>(array->buffers[1])[row];
+}
+
+class ArrowExportTest : public testing::Test {
+ public:
+  void SetUp() override {
+    schemas_.push_back(NewSchema<int32_t>(0, "id", true, false));
+    schemas_.push_back(NewSchema<std::string>(1, "name", false, true));
+    schemas_.push_back(NewSchema<int64_t>(2, "score", false, true));
+    schemas_.push_back(NewSchema<double>(3, "salary", false, true));
+    schemas_.push_back(NewSchema<bool>(4, "exist", false, false));
+    schemas_.push_back(
+        NewSchema<std::vector<int32_t>>(5, "int_list", false, true));
+    schemas_.push_back(
+        NewSchema<std::vector<std::string>>(6, "string_list", false, true));
+    schemas_.push_back(
+        NewSchema<std::vector<bool>>(7, "bool_list", false, false));
+  }
+
+  std::vector<Value> Record(int32_t i) {
+    std::vector<Value> record(schemas_.size());
+    record[0] = i;
+    record[1] = std::string(i, 'a' + i % 26);
+    record[2] = int64_t(i) * 1000000007L;
+    record[3] = i * 0.5;
+    record[4] = i % 2 == 0;
+    record[5] = std::vector<int32_t>(i % 4, i);
+    record[6] = std::vector<std::string>{"x", std::to_string(i)};
+    record[7] = std::vector<bool>{true, i % 3 == 0, false};
+    if (i % 5 == 0) {
+      record[1] = Value();
+      record[2] = Value();
+      record[3] = Value();
+      record[5] = Value();
+      record[6] = Value();
+    }
+    return record;
+  }
+
+ protected:
+  std::vector<BaseSchemaPtr> schemas_;
+};
+
+TEST_F(ArrowExportTest, roundTrip) {
+  constexpr int kRows = 37;
+  RecordEncoderV2 re(0, schemas_, 1L);
+  RecordDecoderV2 rd(0, schemas_, 1L);
+
+  std::vector<KeyValue> key_values;
+  for (int32_t i = 0; i < kRows; ++i) {
+    std::string key, value;
+    ASSERT_EQ(0, re.Encode('r', Record(i), key, value));
+    key_values.emplace_back(key, value);
+  }
+
+  std::vector<int> column_indexes{0, 1, 2, 3, 4, 5, 6, 7};
+  std::vector<std::string> names;
+  for (int index : column_indexes) {
+    names.push_back(schemas_[index]->GetName());
+  }
+  std::vector<ColumnVector> columns;
+  ASSERT_EQ(0, rd.DecodeBatch(key_values, column_indexes, columns));
+
+  ArrowSchema schema;
+  ArrowArray array;
+  ASSERT_EQ(0, ExportArrowBatch(std::move(columns), names, &schema, &array));
+
+  EXPECT_STREQ("+s", schema.format);
+  ASSERT_EQ(column_indexes.size(), schema.n_children);
+  const char* formats[] = {"i", "z", "l", "g", "b", "+l", "+l", "+l"};
+  for (int i = 0; i < schema.n_children; ++i) {
+    EXPECT_STREQ(formats[i], schema.children[i]->format);
+    EXPECT_EQ(names[i], schema.children[i]->name);
+    EXPECT_EQ(ARROW_FLAG_NULLABLE, schema.children[i]->flags);
+  }
+  EXPECT_STREQ("i", schema.children[5]->children[0]->format);
+  EXPECT_STREQ("z", schema.children[6]->children[0]->format);
+  EXPECT_STREQ("b", schema.children[7]->children[0]->format);
+
+  EXPECT_EQ(kRows, array.length);
+  ASSERT_EQ(column_indexes.size(), array.n_children);
+  ArrowArray** children = array.children;
+  for (int i = 0; i < array.n_children; ++i) {
+    EXPECT_EQ(kRows, children[i]->length);
+  }
+  int null_rows = (kRows + 4) / 5;
+  EXPECT_EQ(0, children[0]->null_count);
+  EXPECT_EQ(null_rows, children[1]->null_count);
+  EXPECT_EQ(null_rows, children[5]->null_count);
+  EXPECT_EQ(0, children[7]->null_count);
+
+  for (int32_t row = 0; row < kRows; ++row) {
+    auto record = Record(row);
+    EXPECT_EQ(row, ArrowValue<int32_t>(children[0], row));
+    EXPECT_EQ(row % 2 == 0, ArrowBool(children[4], row));
+
+    bool is_null = row % 5 == 0;
+    for (int i : {1, 2, 3, 5, 6}) {
+      EXPECT_EQ(is_null, ArrowIsNull(children[i], row));
+    }
+    if (!is_null) {
+      EXPECT_EQ(std::get<std::string>(record[1]),
+                ArrowString(children[1], row));
+      EXPECT_EQ(std::get<int64_t>(record[2]),
+                ArrowValue<int64_t>(children[2], row));
+      EXPECT_EQ(std::get<double>(record[3]),
+                ArrowValue<double>(children[3], row));
+    }
+
+    const auto* ints = children[5]->children[0];
+    std::vector<int32_t> int_list;
+    for (int32_t j = ArrowListBegin(children[5], row);
+         j < ArrowListBegin(children[5], row + 1); ++j) {
+      int_list.push_back(ArrowValue<int32_t>(ints, j));
+    }
+    EXPECT_EQ(is_null ? std::vector<int32_t>()
+                      : std::get<std::vector<int32_t>>(record[5]),
+              int_list);
+
+    const auto* strings = children[6]->children[0];
+    std::vector<std::string> string_list;
+    for (int32_t j = ArrowListBegin(children[6], row);
+         j < ArrowListBegin(children[6], row + 1); ++j) {
+      string_list.emplace_back(ArrowString(strings, j));
+    }
+    EXPECT_EQ(is_null ? std::vector<std::string>()
+                      : std::get<std::vector<std::string>>(record[6]),
+              string_list);
+
+    const auto* bools = children[7]->children[0];
+    int32_t begin = ArrowListBegin(children[7], row);
+    ASSERT_EQ(begin + 3, ArrowListBegin(children[7], row + 1));
+    EXPECT_TRUE(ArrowBool(bools, begin));
+    EXPECT_EQ(row % 3 == 0, ArrowBool(bools, begin + 1));
+    EXPECT_FALSE(ArrowBool(bools, begin + 2));
+    EXPECT_EQ(0, bools->null_count);
+  }
+
+  // A consumer may move a child out and release it on its own.
+  ArrowArray moved = *children[1];
+  children[1]->release = nullptr;
+  array.release(&array);
+  EXPECT_EQ(nullptr, array.release);
+  EXPECT_EQ(std::get<std::string>(Record(1)[1]), ArrowString(&moved, 1));
+  moved.release(&moved);
+  EXPECT_EQ(nullptr, moved.release);
+
+  schema.release(&schema);
+  EXPECT_EQ(nullptr, schema.release);
+}
+
+TEST_F(ArrowExportTest, dictionary) {
+  constexpr int kRows = 40;
+  RecordEncoderV2 re(0, schemas_, 1L);
+  RecordDecoderV2 rd(0, schemas_, 1L);
+  rd.SetDictionaryBatch(true);
+
+  std::vector<KeyValue> key_values;
+  for (int32_t i = 0; i < kRows; ++i) {
+    // Rows 1 to 3 hold the only distinct names.
+    std::string key, value;
+    ASSERT_EQ(0, re.Encode('r', Record(i % 5 == 0 ? i : 1 + i % 3), key,
+                           value));
+    key_values.emplace_back(key, value);
+  }
+
+  std::vector<ColumnVector> columns;
+  ASSERT_EQ(0, rd.DecodeBatch(key_values, {1, 2}, columns));
+  ASSERT_TRUE(columns[0].dictionary);
+  EXPECT_FALSE(columns[1].dictionary);
+
+  ArrowSchema schema;
+  ArrowArray array;
+  ASSERT_EQ(0, ExportArrowBatch(std::move(columns), {"name", "score"},
+                                &schema, &array));
+  EXPECT_STREQ("i", schema.children[0]->format);
+  ASSERT_NE(nullptr, schema.children[0]->dictionary);
+  EXPECT_STREQ("z", schema.children[0]->dictionary->format);
+  EXPECT_EQ(nullptr, schema.children[1]->dictionary);
+
+  const auto* names = array.children[0];
+  const auto* entries = names->dictionary;
+  ASSERT_NE(nullptr, entries);
+  EXPECT_EQ(3, entries->length);
+  EXPECT_EQ(0, entries->null_count);
+  EXPECT_EQ(kRows / 5, names->null_count);
+  for (int32_t row = 0; row < kRows; ++row) {
+    if (row % 5 == 0) {
+      EXPECT_TRUE(ArrowIsNull(names, row));
+      continue;
+    }
+    EXPECT_EQ(std::get<std::string>(Record(1 + row % 3)[1]),
+              ArrowString(entries, ArrowValue<int32_t>(names, row)));
+  }
+
+  array.release(&array);
+  EXPECT_EQ(nullptr, array.release);
+  schema.release(&schema);
+  EXPECT_EQ(nullptr, schema.release);
+}
+
+TEST_F(ArrowExportTest, mismatch) {
+  std::vector<ColumnVector> columns(2);
+  columns[0].Reset(BaseSchema::kInteger, 3);
+  columns[1].Reset(BaseSchema::kLong, 4);
+
+  ArrowSchema schema;
+  ArrowArray array;
+  EXPECT_EQ(-1, ExportArrowBatch(std::move(columns), {"a"}, &schema, &array));
+
+  columns.resize(2);
+  columns[0].Reset(BaseSchema::kInteger, 3);
+  columns[1].Reset(BaseSchema::kLong, 4);
+  EXPECT_EQ(-1,
+            ExportArrowBatch(std::move(columns), {"a", "b"}, &schema, &array));
+
+  columns.resize(2);
+  columns[0].Reset(BaseSchema::kInteger, 3);
+  columns[1].Reset(BaseSchema::kLong, 3);
+  columns[1].type = static_cast<BaseSchema::Type>(BaseSchema::kStringList + 1);
+  EXPECT_EQ(-1,
+            ExportArrowBatch(std::move(columns), {"a", "b"}, &schema, &array));
+}
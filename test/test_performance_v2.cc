@@ -22,6 +22,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
+#include <map>
 #include <memory>
 #include <optional>
 #include <random>
@@ -32,6 +33,7 @@
 #include "serial/record/V2/common.h"
 #include "serial/record/V2/record_decoder.h"
 #include "serial/record/V2/record_encoder.h"
+#include "serial/record/V2/value_header.h"
 #include "serial/record_decoder.h"
 #include "serial/record_encoder.h"
 #include "serial/schema/V2/base_schema.h"
@@ -157,6 +159,29 @@ std::vector<dingodb::serialV2::BaseSchemaPtr> GenerateSchemas1Column() {
   return schemas;
 }
 
+// int key + column_count nullable int value columns.
+std::vector<dingodb::serialV2::BaseSchemaPtr> GenerateIntSchemas(
+    int column_count) {
+  std::vector<dingodb::serialV2::BaseSchemaPtr> schemas;
+  schemas.resize(column_count + 1);
+
+  auto id = std::make_shared<dingodb::serialV2::DingoSchema<int32_t>>();
+  id->SetIndex(0);
+  id->SetAllowNull(false);
+  id->SetIsKey(true);
+  schemas.at(0) = id;
+
+  for (int i = 1; i <= column_count; ++i) {
+    auto col = std::make_shared<dingodb::serialV2::DingoSchema<int32_t>>();
+    col->SetIndex(i);
+    col->SetAllowNull(true);
+    col->SetIsKey(false);
+    schemas.at(i) = col;
+  }
+
+  return schemas;
+}
+
 std::shared_ptr<std::vector<std::shared_ptr<dingodb::BaseSchema>>>
 GenerateSchemasV1() {
   std::shared_ptr<std::vector<std::shared_ptr<dingodb::BaseSchema>>> schemas =
@@ -752,3 +777,412 @@ TEST_F(PerformanceTestV2, perf) {
   std::cout << "Encode/Decode elapsed time: " << TimestampMs() - start_time
             << "ms" << std::endl;
 }
+
+TEST_F(PerformanceTestV2, valueHeaderLookup) {
+  /*
+   * Parse the value header and locate every column, compared with building
+   * an id -> offset std::map per row.
+   */
+  for (int column_count : {10, 100, 1000}) {
+    const int loop_times = 1000000 / column_count;
+    auto schemas = GenerateIntSchemas(column_count);
+    std::vector<std::any> record(column_count + 1);
+    record[0] = int32_t(1);
+    for (int i = 1; i <= column_count; ++i) {
+      if (i % 5 != 0) {
+        record[i] = int32_t(i);
+      }
+    }
+
+    dingodb::serialV2::RecordEncoderV2 encoder(1, schemas, 100);
+    std::string key;
+    std::string value;
+    ASSERT_EQ(0, encoder.Encode('r', record, key, value));
+    auto plan = dingodb::serialV2::CodecPlan::Build(schemas);
+
+    int64_t checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int loop = 0; loop < loop_times; ++loop) {
+      dingodb::serialV2::BufView value_buf(value);
+      value_buf.Skip(4);
+      dingodb::serialV2::ValueHeader header(value_buf);
+      for (int i = 1; i <= column_count; ++i) {
+        checksum += header.FindOffset(value_buf, plan.columns[i]);
+      }
+    }
+    auto flat_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+
+    int64_t map_checksum = 0;
+    start = std::chrono::steady_clock::now();
+    for (int loop = 0; loop < loop_times; ++loop) {
+      dingodb::serialV2::BufView value_buf(value);
+      value_buf.Skip(4);
+      dingodb::serialV2::ValueHeader header(value_buf);
+      std::map<int, int> id_offset_map;
+      for (int i = 0; i < header.total_col_cnt; ++i) {
+        id_offset_map[header.ColumnId(value_buf, i)] =
+            header.ColumnOffset(value_buf, i);
+      }
+      for (int i = 1; i <= column_count; ++i) {
+        map_checksum += id_offset_map[i];
+      }
+    }
+    auto map_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                      std::chrono::steady_clock::now() - start)
+                      .count();
+
+    EXPECT_EQ(checksum, map_checksum);
+
+    std::cout << "Columns: " << column_count
+              << ", flat header: " << flat_ns / loop_times << "ns/row"
+              << ", std::map header: " << map_ns / loop_times << "ns/row"
+              << std::endl;
+  }
+}
+
+TEST_F(PerformanceTestV2, projection) {
+  /*
+   * Decode two columns of a row through the offset table, compared with a
+   * full decode. The projected cost should not grow with the row width.
+   */
+  const std::vector<int> column_indexes{1, 2};
+  for (int column_count : {10, 2000}) {
+    const int loop_times = 2000;
+    auto schemas = GenerateIntSchemas(column_count);
+    std::vector<std::any> record(column_count + 1);
+    record[0] = int32_t(1);
+    for (int i = 1; i <= column_count; ++i) {
+      if (i % 5 != 0) {
+        record[i] = int32_t(i);
+      }
+    }
+
+    dingodb::serialV2::RecordEncoderV2 encoder(1, schemas, 100);
+    dingodb::serialV2::RecordDecoderV2 decoder(1, schemas, 100);
+    std::string key;
+    std::string value;
+    ASSERT_EQ(0, encoder.Encode('r', record, key, value));
+
+    std::vector<std::any> decoded;
+    auto start = std::chrono::steady_clock::now();
+    for (int loop = 0; loop < loop_times; ++loop) {
+      decoder.Decode(key, value, column_indexes, decoded);
+    }
+    auto projected_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            std::chrono::steady_clock::now() - start)
+                            .count();
+    EXPECT_EQ(2, std::any_cast<int32_t>(decoded.at(1)));
+
+    start = std::chrono::steady_clock::now();
+    for (int loop = 0; loop < loop_times; ++loop) {
+      decoder.Decode(key, value, decoded);
+    }
+    auto full_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+    EXPECT_EQ(2, std::any_cast<int32_t>(decoded.at(2)));
+
+    std::cout << "Columns: " << column_count
+              << ", projection of 2 columns: " << projected_ns / loop_times
+              << "ns/row, full decode: " << full_ns / loop_times << "ns/row"
+              << std::endl;
+  }
+}
+
+TEST_F(PerformanceTestV2, encodeBatch) {
+  /*
+   * Encode the same rows one by one and as one batch.
+   */
+  constexpr int loop_times = 100000;
+  std::vector<std::vector<std::any>> records;
+  records.reserve(loop_times);
+  for (int32_t i = 0; i < loop_times; ++i) {
+    records.push_back(GenerateRecord(i));
+  }
+
+  auto schemas = GenerateSchemas();
+  dingodb::serialV2::RecordEncoderV2 encoder(1, schemas, 100);
+
+  uint64_t start_time = TimestampMs();
+  size_t total_size = 0;
+  for (const auto& record : records) {
+    std::string key;
+    std::string value;
+    encoder.Encode('r', record, key, value);
+    total_size += key.size() + value.size();
+  }
+  std::cout << "Encode per row elapsed time: " << TimestampMs() - start_time
+            << "ms" << std::endl;
+
+  start_time = TimestampMs();
+  dingodb::serialV2::EncodedBatch batch;
+  encoder.EncodeBatch('r', records, batch);
+  std::cout << "EncodeBatch elapsed time: " << TimestampMs() - start_time
+            << "ms" << std::endl;
+
+  EXPECT_EQ(loop_times, batch.Size());
+  EXPECT_EQ(total_size, batch.keys.size() + batch.values.size());
+}
+
+TEST_F(PerformanceTestV2, decodeBatch) {
+  /*
+   * Decode a projection of the same rows one by one and transpose them into
+   * columns, then decode them as one batch straight into column vectors.
+   */
+  constexpr int loop_times = 100000;
+  auto schemas = GenerateSchemas();
+  dingodb::serialV2::RecordEncoderV2 encoder(1, schemas, 100);
+  dingodb::serialV2::RecordDecoderV2 decoder(1, schemas, 100);
+
+  std::vector<dingodb::serialV2::KeyValue> key_values;
+  key_values.reserve(loop_times);
+  for (int32_t i = 0; i < loop_times; ++i) {
+    std::string key;
+    std::string value;
+    encoder.Encode('r', GenerateRecord(i), key, value);
+    key_values.emplace_back(key, value);
+  }
+
+  std::vector<int> column_indexes{0, 3, 4, 8, 9, 10};
+
+  uint64_t start_time = TimestampMs();
+  std::vector<std::vector<std::any>> transposed(column_indexes.size());
+  std::vector<std::any> record;
+  for (const auto& key_value : key_values) {
+    decoder.Decode(key_value, column_indexes, record);
+    for (size_t i = 0; i < record.size(); ++i) {
+      transposed[i].push_back(record[i]);
+    }
+  }
+  std::cout << "Decode per row and transpose elapsed time: "
+            << TimestampMs() - start_time << "ms" << std::endl;
+
+  start_time = TimestampMs();
+  std::vector<dingodb::serialV2::ColumnVector> columns;
+  EXPECT_EQ(0, decoder.DecodeBatch(key_values, column_indexes, columns));
+  std::cout << "DecodeBatch elapsed time: " << TimestampMs() - start_time
+            << "ms" << std::endl;
+
+  EXPECT_EQ(column_indexes.size(), columns.size());
+  for (size_t i = 0; i < columns.size(); ++i) {
+    EXPECT_EQ(loop_times, columns[i].size);
+  }
+}
+
+TEST_F(PerformanceTestV2, aggregate) {
+  /*
+   * COUNT/SUM/MIN/MAX of a long and a double value column, once by decoding
+   * every row and casting the std::any cells, once over the encoded values.
+   */
+  constexpr int loop_times = 100000;
+  auto schemas = GenerateSchemas();
+  dingodb::serialV2::RecordEncoderV2 encoder(1, schemas, 100);
+  dingodb::serialV2::RecordDecoderV2 decoder(1, schemas, 100);
+
+  std::vector<dingodb::serialV2::KeyValue> key_values;
+  key_values.reserve(loop_times);
+  for (int32_t i = 0; i < loop_times; ++i) {
+    std::string key;
+    std::string value;
+    encoder.Encode('r', GenerateRecord(i), key, value);
+    key_values.emplace_back(key, value);
+  }
+
+  for (int column : {9, 10}) {
+    uint64_t start_time = TimestampMs();
+    int64_t count = 0;
+    double sum = 0;
+    double min = 0;
+    double max = 0;
+    std::vector<std::any> record;
+    for (const auto& key_value : key_values) {
+      decoder.Decode(key_value, record);
+      const auto& cell = record.at(column);
+      if (!cell.has_value()) {
+        continue;
+      }
+      double data = column == 9
+                        ? static_cast<double>(std::any_cast<int64_t>(cell))
+                        : std::any_cast<double>(cell);
+      min = count == 0 || data < min ? data : min;
+      max = count == 0 || data > max ? data : max;
+      sum += data;
+      ++count;
+    }
+    std::cout << "Decode then aggregate column " << column
+              << " elapsed time: " << TimestampMs() - start_time << "ms"
+              << std::endl;
+
+    start_time = TimestampMs();
+    dingodb::serialV2::AggregateResult result;
+    EXPECT_EQ(0, decoder.Aggregate(key_values, column, result));
+    std::cout << "Aggregate column " << column
+              << " elapsed time: " << TimestampMs() - start_time << "ms"
+              << std::endl;
+
+    EXPECT_EQ(loop_times, result.rows);
+    EXPECT_EQ(count, result.count);
+  }
+}
+
+TEST_F(PerformanceTestV2, recordView) {
+  /*
+   * Read 3 columns of every row, once through a full Decode, once through a
+   * RecordView decoding only those columns.
+   */
+  constexpr int loop_times = 100000;
+  auto schemas = GenerateSchemas();
+  dingodb::serialV2::RecordEncoderV2 encoder(1, schemas, 100);
+  dingodb::serialV2::RecordDecoderV2 decoder(1, schemas, 100);
+
+  std::vector<dingodb::serialV2::KeyValue> key_values;
+  key_values.reserve(loop_times);
+  for (int32_t i = 0; i < loop_times; ++i) {
+    std::string key;
+    std::string value;
+    encoder.Encode('r', GenerateRecord(i), key, value);
+    key_values.emplace_back(key, value);
+  }
+
+  uint64_t start_time = TimestampMs();
+  int64_t decode_sum = 0;
+  std::vector<std::any> record;
+  for (const auto& key_value : key_values) {
+    decoder.Decode(key_value, record);
+    decode_sum += std::any_cast<int32_t>(record.at(0)) +
+                  std::any_cast<int32_t>(record.at(8)) +
+                  std::any_cast<int64_t>(record.at(9));
+  }
+  std::cout << "Decode elapsed time: " << TimestampMs() - start_time << "ms"
+            << std::endl;
+
+  start_time = TimestampMs();
+  int64_t view_sum = 0;
+  dingodb::serialV2::RecordView view;
+  for (const auto& key_value : key_values) {
+    decoder.View(key_value.GetKey(), key_value.GetValue(), view);
+    view_sum += view.GetInt32(0) + view.GetInt32(8) + view.GetInt64(9);
+  }
+  std::cout << "RecordView elapsed time: " << TimestampMs() - start_time
+            << "ms" << std::endl;
+
+  EXPECT_EQ(decode_sum, view_sum);
+}
+
+TEST_F(PerformanceTestV2, sparseValue) {
+  /*
+   * Wide tables with 20 columns set per row, V2 rows against V3 rows that
+   * are written sparse.
+   */
+  for (int column_count : {100, 1000, 4000}) {
+    const int loop_times = 10000;
+    auto schemas = GenerateIntSchemas(column_count);
+    std::vector<std::vector<dingodb::serialV2::Value>> records(loop_times);
+    for (int32_t i = 0; i < loop_times; ++i) {
+      records[i].resize(column_count + 1);
+      records[i][0] = i;
+      for (int j = 0; j < 20; ++j) {
+        records[i][1 + (i + j * 97) % column_count] = i + j;
+      }
+    }
+
+    dingodb::serialV2::RecordDecoderV2 decoder(1, schemas, 100);
+    for (int version : {dingodb::serialV2::CODEC_VERSION_V2,
+                        dingodb::serialV2::CODEC_VERSION_V3}) {
+      dingodb::serialV2::RecordEncoderV2 encoder(1, schemas, 100);
+      encoder.SetCodecVersion(version);
+
+      std::vector<std::string> keys(loop_times);
+      std::vector<std::string> values(loop_times);
+      uint64_t start_time = TimestampMs();
+      size_t value_bytes = 0;
+      for (int i = 0; i < loop_times; ++i) {
+        encoder.Encode('r', records[i], keys[i], values[i]);
+        value_bytes += values[i].size();
+      }
+      uint64_t encode_ms = TimestampMs() - start_time;
+
+      start_time = TimestampMs();
+      std::vector<dingodb::serialV2::Value> record;
+      for (int i = 0; i < loop_times; ++i) {
+        decoder.Decode(keys[i], values[i], record);
+      }
+      uint64_t decode_ms = TimestampMs() - start_time;
+      EXPECT_EQ(records.back(), record);
+
+      // Look up 3 columns of every row.
+      auto start = std::chrono::steady_clock::now();
+      int64_t nulls = 0;
+      dingodb::serialV2::RecordView view;
+      for (int i = 0; i < loop_times; ++i) {
+        decoder.View(keys[i], values[i], view);
+        nulls += view.IsNull(1) + view.IsNull(column_count / 2) +
+                 view.IsNull(column_count);
+      }
+      auto view_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                         std::chrono::steady_clock::now() - start)
+                         .count();
+      EXPECT_LT(0, nulls);
+
+      std::cout << "Columns: " << column_count << ", V" << version
+                << " value: " << value_bytes / loop_times << " bytes/row"
+                << ", encode: " << encode_ms << "ms"
+                << ", decode: " << decode_ms << "ms"
+                << ", 3 column lookup: " << view_ns / loop_times << "ns/row"
+                << std::endl;
+    }
+  }
+}
+
+TEST_F(PerformanceTestV2, fixedBlockValue) {
+  /*
+   * Aggregate a long column and read 3 value columns through a RecordView,
+   * over V2 rows, V3 dense rows and V3 fixed block rows.
+   */
+  constexpr int loop_times = 100000;
+  auto schemas = GenerateSchemas();
+  dingodb::serialV2::RecordDecoderV2 decoder(1, schemas, 100);
+
+  for (int layout = 0; layout < 3; ++layout) {
+    dingodb::serialV2::RecordEncoderV2 encoder(1, schemas, 100);
+    if (layout > 0) {
+      encoder.SetCodecVersion(dingodb::serialV2::CODEC_VERSION_V3);
+    }
+    if (layout == 1) {
+      encoder.SetDenseValue(true);
+    } else if (layout == 2) {
+      encoder.SetFixedBlockValue(true);
+    }
+
+    std::vector<dingodb::serialV2::KeyValue> key_values;
+    key_values.reserve(loop_times);
+    for (int32_t i = 0; i < loop_times; ++i) {
+      std::string key;
+      std::string value;
+      encoder.Encode('r', GenerateRecord(i), key, value);
+      key_values.emplace_back(key, value);
+    }
+
+    uint64_t start_time = TimestampMs();
+    dingodb::serialV2::AggregateResult result;
+    EXPECT_EQ(0, decoder.Aggregate(key_values, 9, result));
+    uint64_t aggregate_ms = TimestampMs() - start_time;
+    EXPECT_EQ(loop_times, result.rows);
+
+    start_time = TimestampMs();
+    double view_sum = 0;
+    dingodb::serialV2::RecordView view;
+    for (const auto& key_value : key_values) {
+      decoder.View(key_value.GetKey(), key_value.GetValue(), view);
+      view_sum += view.GetInt32(8) + view.GetInt64(9) + view.GetDouble(10);
+    }
+    uint64_t view_ms = TimestampMs() - start_time;
+    EXPECT_NE(0, view_sum);
+
+    const char* names[] = {"V2", "V3 dense", "V3 fixed block"};
+    std::cout << names[layout] << " aggregate: " << aggregate_ms << "ms"
+              << ", 3 column view: " << view_ms << "ms" << std::endl;
+  }
+}
@@ -1277,6 +1277,258 @@ TEST_F(SchemaTest, stringType) {
   }
 }
 
+TEST_F(SchemaTest, boolListPacked) {
+  auto schema = std::make_shared<DingoSchema<std::vector<bool>>>();
+  schema->SetAllowNull(true);
+
+  for (int len = 0; len < 150; ++len) {
+    std::vector<bool> data(len);
+    for (int i = 0; i < len; ++i) {
+      data[i] = (i * 7) % 3 == 0;
+    }
+
+    Buf buf(0);
+    int size = schema->EncodePackedValue(&data, buf);
+    ASSERT_EQ(4 + (len + 7) / 8, size);
+    ASSERT_EQ(size, schema->GetEncodedPackedValueSize(&data));
+    schema->EncodeValue(&data, buf);
+    schema->EncodePackedValue(&data, buf);
+
+    // Either form decodes into the list and into a bitmap.
+    ASSERT_EQ(size, schema->SkipValue(buf));
+    std::vector<bool> actual(3, true);
+    schema->DecodeValue(buf, actual);
+    ASSERT_EQ(data, actual);
+    for (int form = 0; form < 2; ++form) {
+      buf.SetReadOffset(form == 0 ? size : 0);
+      std::vector<uint8_t> bitmap(40, 0xFF);
+      ASSERT_EQ(len, schema->DecodeBitmap(buf, bitmap));
+      ASSERT_EQ((len + 7) / 8, bitmap.size());
+      for (int i = 0; i < len; ++i) {
+        ASSERT_EQ(data[i], ((bitmap[i / 8] >> (i % 8)) & 1) == 1);
+      }
+      if (len % 8 != 0) {
+        ASSERT_EQ(0, bitmap.back() >> (len % 8));
+      }
+    }
+  }
+
+  // Non zero bytes of the one byte form are true.
+  Buf buf(0);
+  buf.WriteInt(10);
+  for (int i = 0; i < 10; ++i) {
+    buf.Write(i % 2 == 0 ? 0 : 0x10 << (i % 4));
+  }
+  std::vector<bool> actual;
+  schema->DecodeValue(buf, actual);
+  EXPECT_EQ(std::vector<bool>({false, true, false, true, false, true, false,
+                               true, false, true}),
+            actual);
+
+  Buf truncated(0);
+  truncated.WriteInt(20 | 0x80000000);
+  truncated.Write(0xFF);
+  EXPECT_THROW(schema->DecodeValue(truncated, actual), std::out_of_range);
+}
+
+TEST_F(SchemaTest, compactValue) {
+  auto int_schema = std::make_shared<DingoSchema<int32_t>>();
+  auto long_schema = std::make_shared<DingoSchema<int64_t>>();
+  EXPECT_FALSE(int_schema->IsCompactValue());
+  int_schema->SetCompactValue(true);
+  EXPECT_TRUE(int_schema->IsCompactValue());
+
+  std::vector<int64_t> longs = {0, 1, -1, 63, -64, 64, INT32_MAX, INT32_MIN,
+                                INT64_MAX, INT64_MIN};
+  Buf buf(0);
+  for (int64_t data : longs) {
+    int32_t narrow = static_cast<int32_t>(data);
+    int size = int_schema->EncodeCompactValue(&narrow, buf);
+    ASSERT_EQ(size, int_schema->GetEncodedCompactValueSize(&narrow));
+    size = long_schema->EncodeCompactValue(&data, buf);
+    ASSERT_EQ(size, long_schema->GetEncodedCompactValueSize(&data));
+  }
+  for (int64_t data : longs) {
+    int32_t narrow;
+    int_schema->DecodeCompactValue(buf, narrow);
+    ASSERT_EQ(static_cast<int32_t>(data), narrow);
+    int64_t actual;
+    long_schema->DecodeCompactValue(buf, actual);
+    ASSERT_EQ(data, actual);
+  }
+  EXPECT_EQ(0, buf.RestReadableSize());
+
+  // Small values take one byte, nulls none.
+  int32_t small = -3;
+  EXPECT_EQ(1, int_schema->GetEncodedCompactValueSize(&small));
+  EXPECT_EQ(0, int_schema->GetEncodedCompactValueSize(nullptr));
+  int_schema->SetAllowNull(false);
+  EXPECT_THROW(int_schema->EncodeCompactValue(nullptr, buf),
+               std::runtime_error);
+
+  // A varint above the int range is rejected.
+  Buf wide(0);
+  wide.WriteVarint(uint64_t(1) << 32);
+  int32_t narrow;
+  EXPECT_THROW(int_schema->DecodeCompactValue(wide, narrow),
+               std::out_of_range);
+}
+
+TEST_F(SchemaTest, compactListValue) {
+  auto int_schema = std::make_shared<DingoSchema<std::vector<int32_t>>>();
+  auto long_schema = std::make_shared<DingoSchema<std::vector<int64_t>>>();
+
+  for (int len = 0; len < 70; ++len) {
+    std::vector<int32_t> ints(len);
+    std::vector<int64_t> longs(len);
+    for (int i = 0; i < len; ++i) {
+      ints[i] = (i % 2 == 0 ? 1 : -1) * (i << (i % 4 * 8));
+      longs[i] = (i % 3 == 0 ? -1 : 1) * (int64_t(i) << (i % 8 * 7));
+    }
+
+    Buf buf(0);
+    int size = int_schema->EncodeCompactValue(&ints, buf);
+    ASSERT_EQ(size, int_schema->GetEncodedCompactValueSize(&ints));
+    ASSERT_LE(size, int_schema->GetEncodedValueSize(&ints) + (len + 3) / 4);
+    size = long_schema->EncodeCompactValue(&longs, buf);
+    ASSERT_EQ(size, long_schema->GetEncodedCompactValueSize(&longs));
+
+    std::vector<int32_t> actual_ints(5, 9);
+    int_schema->DecodeCompactValue(buf, actual_ints);
+    ASSERT_EQ(ints, actual_ints);
+    std::vector<int64_t> actual_longs(5, 9);
+    long_schema->DecodeCompactValue(buf, actual_longs);
+    ASSERT_EQ(longs, actual_longs);
+    ASSERT_EQ(0, buf.RestReadableSize());
+  }
+
+  // Small values take a byte each plus the control bytes.
+  std::vector<int64_t> small(100, -5);
+  EXPECT_EQ(4 + 50 + 100, long_schema->GetEncodedCompactValueSize(&small));
+
+  Buf truncated(0);
+  long_schema->EncodeCompactValue(&small, truncated);
+  std::string bytes = truncated.GetString();
+  bytes.pop_back();
+  Buf short_buf(bytes);
+  std::vector<int64_t> actual;
+  EXPECT_THROW(long_schema->DecodeCompactValue(short_buf, actual),
+               std::out_of_range);
+
+  Buf negative(0);
+  negative.WriteInt(-1);
+  EXPECT_THROW(long_schema->DecodeCompactValue(negative, actual),
+               std::out_of_range);
+}
+
+TEST_F(SchemaTest, deltaListValue) {
+  auto schema = std::make_shared<DingoSchema<std::vector<int64_t>>>();
+  auto int_schema = std::make_shared<DingoSchema<std::vector<int32_t>>>();
+  schema->SetAllowNull(true);
+
+  std::vector<int64_t> steady(1000);
+  std::vector<int64_t> scattered(1000);
+  for (size_t i = 0; i < steady.size(); ++i) {
+    steady[i] = 1700000000000 + i * 1000;
+    uint64_t mixed = 0x9E3779B97F4A7C15ULL * (i + 1);
+    scattered[i] = int64_t((mixed ^ (mixed >> 29)) * 0xBF58476D1CE4E5B9ULL);
+  }
+
+  for (const auto* data : {&steady, &scattered}) {
+    Buf buf(0);
+    int size = schema->EncodeDeltaValue(data, buf);
+    ASSERT_EQ(size, schema->GetEncodedDeltaValueSize(data));
+    // Scattered values fall back to the plain form.
+    if (data == &steady) {
+      ASSERT_LT(size, schema->GetEncodedValueSize(data) / 10);
+    } else {
+      ASSERT_EQ(size, schema->GetEncodedValueSize(data));
+    }
+    schema->EncodeDeltaValue(data, buf);
+    schema->EncodeDeltaValue(data, buf);
+
+    ASSERT_EQ(size, schema->SkipValue(buf));
+    std::vector<int64_t> actual(3, 1);
+    schema->DecodeValue(buf, actual);
+    ASSERT_EQ(*data, actual);
+    DeltaListReader<int64_t> reader;
+    schema->DecodeValue(buf, reader);
+    ASSERT_EQ(0, buf.RestReadableSize());
+    std::vector<int64_t> streamed;
+    int64_t value;
+    while (reader.Next(value)) {
+      streamed.push_back(value);
+    }
+    ASSERT_EQ(*data, streamed);
+  }
+
+  std::vector<int32_t> ints(300, 7);
+  Buf buf(0);
+  int size = int_schema->EncodeDeltaValue(&ints, buf);
+  EXPECT_EQ(4 + 3 * 9, size);
+  EXPECT_EQ(size, int_schema->GetEncodedDeltaValueSize(&ints));
+  EXPECT_EQ(ints, std::any_cast<std::vector<int32_t>>(
+                      int_schema->DecodeValue(buf)));
+  EXPECT_EQ(0, schema->GetEncodedDeltaValueSize(nullptr));
+
+  Buf truncated(0);
+  schema->EncodeDeltaValue(&steady, truncated);
+  std::string bytes = truncated.GetString();
+  bytes.pop_back();
+  Buf short_buf(bytes);
+  std::vector<int64_t> actual;
+  EXPECT_THROW(schema->DecodeValue(short_buf, actual), std::out_of_range);
+  short_buf.SetReadOffset(0);
+  EXPECT_THROW(schema->SkipValue(short_buf), std::out_of_range);
+}
+
+TEST_F(SchemaTest, stringKeyComparable) {
+  auto schema = std::make_shared<DingoSchema<std::string>>();
+  schema->SetAllowNull(true);
+
+  // Cover short strings, the 16 group scan window and its tail.
+  for (int len = 0; len < 400; ++len) {
+    std::string data(len, 0);
+    for (int i = 0; i < len; ++i) {
+      data[i] = static_cast<char>(i % 2 == 0 ? 0xFF : i);
+    }
+
+    Buf buf_key(1024);
+    int size = schema->EncodeKey(&data, buf_key);
+    ASSERT_EQ(1 + (len / 8 + 1) * 9, size);
+    ASSERT_EQ(size, schema->GetEncodedKeySize(&data));
+    schema->EncodeKey(&data, buf_key);
+
+    // Byte level format: full groups marked 255, the last one zero padded.
+    const auto* bytes =
+        reinterpret_cast<const uint8_t*>(buf_key.GetString().data());
+    for (int i = 0; i < len / 8; ++i) {
+      ASSERT_EQ(255, bytes[1 + i * 9 + 8]);
+    }
+    ASSERT_EQ(255 - (8 - len % 8), bytes[size - 1]);
+
+    ASSERT_EQ(size, schema->SkipKey(buf_key));
+    std::string actual("stale");
+    ASSERT_TRUE(schema->DecodeKey(buf_key, actual));
+    ASSERT_EQ(data, actual);
+    ASSERT_EQ(0, buf_key.RestReadableSize());
+  }
+
+  // A key without its last group or with a bad pad is rejected.
+  std::string data(200, 'a');
+  Buf buf_key(1024);
+  int size = schema->EncodeKey(&data, buf_key);
+  std::string encoded = buf_key.GetString();
+
+  Buf truncated(encoded.substr(0, size - 1));
+  EXPECT_THROW(schema->SkipKey(truncated), std::runtime_error);
+
+  encoded[size - 2] = 'x';  // padding byte
+  Buf bad_pad(encoded);
+  std::string actual;
+  EXPECT_THROW(schema->DecodeKey(bad_pad, actual), std::runtime_error);
+}
+
 TEST_F(SchemaTest, stringListType) {
   {
     /*
@@ -1826,3 +1826,29 @@ TEST_F(DingoSerialListTypeTest, recordTest) {
 
   DeleteRecords();
 }
+
+TEST_F(DingoSerialListTypeTest, computeEncodedSize) {
+  InitVector();
+  auto schemas = GetSchemas();
+  InitRecord();
+  auto record = GetRecord();
+
+  RecordEncoderV2 re(0, schemas, 0L);
+  for (int i = 0; i < 2; ++i) {
+    size_t key_size = 0;
+    size_t value_size = 0;
+    ASSERT_EQ(0, re.ComputeEncodedSize(record, key_size, value_size));
+
+    std::string key, value;
+    ASSERT_EQ(0, re.Encode('r', record, key, value));
+    EXPECT_EQ(key.size(), key_size);
+    EXPECT_EQ(value.size(), value_size);
+
+    // Null every nullable column for the second round.
+    for (const auto& schema : schemas) {
+      if (schema->AllowNull()) {
+        record.at(schema->GetIndex()) = std::any();
+      }
+    }
+  }
+}
@@ -15,6 +15,7 @@
 #include <byteswap.h>
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <memory>
 #include <optional>
 #include <string>
@@ -216,3 +217,68 @@ TEST_F(DingoSerialTest, keyvaluecodeStringLoopTest) {
     rd.Decode(key, value, column_indexes, decoded_s_records);
   }
 }
+
+// One int key column followed by n nullable string value columns.
+static std::vector<BaseSchemaPtr> GenWideSchemas(int n) {
+  std::vector<BaseSchemaPtr> schemas(n + 1);
+  auto id = std::make_shared<DingoSchema<int32_t>>();
+  id->SetIndex(0);
+  id->SetAllowNull(false);
+  id->SetIsKey(true);
+  schemas.at(0) = id;
+  for (int i = 1; i <= n; i++) {
+    auto str = std::make_shared<DingoSchema<std::string>>();
+    str->SetIndex(i);
+    str->SetAllowNull(true);
+    str->SetIsKey(false);
+    schemas.at(i) = str;
+  }
+  return schemas;
+}
+
+static std::vector<std::any> GenWideRecord(int n) {
+  std::vector<std::any> record(n + 1);
+  record.at(0) = int32_t(7);
+  for (int i = 1; i <= n; i++) {
+    if (i % 5 != 0) {
+      record.at(i) = "value_" + std::to_string(i);
+    }
+  }
+  return record;
+}
+
+TEST_F(DingoSerialTest, projectionSeeksValueColumns) {
+  int n = 2000;
+  auto schemas = GenWideSchemas(n);
+  auto record = GenWideRecord(n);
+
+  RecordEncoderV2 re(0, schemas, 0L, this->le);
+  std::string key;
+  std::string value;
+  re.Encode('r', record, key, value);
+
+  // Corrupt the length prefix of every value column that is not requested,
+  // a projection that walked the row column by column could not get past
+  // them.
+  std::vector<int> column_indexes{n - 1, 0, n / 2, 10};
+  BufView header(value, this->le);
+  int offset_pos = 8 + 2 * n;
+  for (int i = 1; i <= n; i++) {
+    int offset = header.ReadInt(offset_pos + 4 * (i - 1));
+    bool requested = std::find(column_indexes.begin(), column_indexes.end(),
+                               i) != column_indexes.end();
+    if (offset != -1 && !requested) {
+      value[offset] = 0x7f;
+    }
+  }
+
+  RecordDecoderV2 rd(0, schemas, 0L, this->le);
+  std::vector<std::any> decoded;
+  ASSERT_EQ(0, rd.Decode(key, value, column_indexes, decoded));
+  ASSERT_EQ(column_indexes.size(), decoded.size());
+  EXPECT_EQ(std::any_cast<std::string>(record.at(n - 1)),
+            std::any_cast<std::string>(decoded.at(0)));
+  EXPECT_EQ(7, std::any_cast<int32_t>(decoded.at(1)));
+  EXPECT_FALSE(decoded.at(2).has_value());  // n / 2 is a null column.
+  EXPECT_FALSE(decoded.at(3).has_value());  // so is 10.
+}
@@ -20,13 +20,18 @@
 #include <bitset>
 #include <cstdint>
 #include <cstring>
+#include <functional>
 #include <memory>
 #include <optional>
 #include <string>
 #include <string_view>
 
+#include "serial/record/V2/codec_plan.h"
+#include "serial/record/V2/column_vector.h"
 #include "serial/record/V2/record_decoder.h"
 #include "serial/record/V2/record_encoder.h"
+#include "serial/record/V2/value.h"
+#include "serial/record/V2/value_header.h"
 #include "serial/schema/V2/base_schema.h"
 #include "serial/utils/V2/utils.h"
 
@@ -1544,3 +1549,1533 @@ TEST_F(DingoSerialTest, recordTest) {
   DeleteSchemas();
   DeleteRecords();
 }
+
+TEST_F(DingoSerialTest, codecPlan) {
+  InitVector();
+  auto schemas = GetSchemas();
+
+  CodecPlan plan = CodecPlan::Build(schemas);
+  ASSERT_EQ(11, plan.columns.size());
+  ASSERT_EQ(4, plan.keys.size());
+  ASSERT_EQ(7, plan.values.size());
+
+  for (size_t i = 0; i < plan.keys.size(); ++i) {
+    EXPECT_EQ(i, plan.keys[i].position);
+    EXPECT_TRUE(plan.keys[i].is_key);
+    EXPECT_EQ(-1, plan.keys[i].value_slot);
+  }
+  for (size_t i = 0; i < plan.values.size(); ++i) {
+    EXPECT_EQ(i + 4, plan.values[i].index);
+    EXPECT_FALSE(plan.values[i].is_key);
+    EXPECT_EQ(i, plan.values[i].value_slot);
+    EXPECT_EQ(schemas[i + 4].get(), plan.values[i].schema);
+  }
+
+  EXPECT_EQ(BaseSchema::kLong, plan.columns[3].type);
+  EXPECT_EQ(8, plan.columns[3].fixed_width);
+  EXPECT_EQ(0, plan.columns[4].fixed_width);
+  EXPECT_EQ(1, plan.columns[5].fixed_width);
+  EXPECT_TRUE(plan.columns[7].nullable);
+
+  // Holes in the schema vector take no value slot.
+  schemas[5] = nullptr;
+  plan = CodecPlan::Build(schemas);
+  ASSERT_EQ(11, plan.columns.size());
+  EXPECT_EQ(nullptr, plan.columns[5].schema);
+  EXPECT_EQ(6, plan.values.size());
+  EXPECT_EQ(1, plan.columns[6].value_slot);
+
+  DeleteSchemas();
+}
+
+TEST_F(DingoSerialTest, valueRecord) {
+  InitVector();
+  auto schemas = GetSchemas();
+  InitRecord();
+  const auto& any_record = GetRecord();
+
+  std::vector<Value> record(any_record.size());
+  for (size_t i = 0; i < schemas.size(); ++i) {
+    record[i] = AnyToValue(any_record[i], schemas[i]->GetType());
+  }
+  ASSERT_TRUE(IsNull(record[6]));
+  ASSERT_EQ(BaseSchema::kString, GetValueType(record[1]));
+
+  // Both representations produce the same bytes.
+  RecordEncoderV2 re(0, schemas, 0L, this->le);
+  std::string key, value;
+  ASSERT_EQ(0, re.Encode('r', record, key, value));
+  std::string any_key, any_value;
+  ASSERT_EQ(0, re.Encode('r', any_record, any_key, any_value));
+  EXPECT_EQ(any_key, key);
+  EXPECT_EQ(any_value, value);
+
+  RecordDecoderV2 rd(0, schemas, 0L, this->le);
+  std::vector<Value> decoded;
+  ASSERT_EQ(0, rd.Decode(key, value, decoded));
+  EXPECT_EQ(record, decoded);
+
+  // Decoding again into the same record gives the same result.
+  ASSERT_EQ(0, rd.Decode(key, value, decoded));
+  EXPECT_EQ(record, decoded);
+
+  std::vector<Value> key_record;
+  ASSERT_EQ(0, rd.DecodeKey(key, key_record));
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_EQ(record[i], key_record[i]);
+  }
+
+  std::vector<Value> projected;
+  ASSERT_EQ(0, rd.Decode(key, value, std::vector<int>{10, 6, 1}, projected));
+  ASSERT_EQ(3, projected.size());
+  EXPECT_EQ(record[10], projected[0]);
+  EXPECT_TRUE(IsNull(projected[1]));
+  EXPECT_EQ(record[1], projected[2]);
+
+  // A key requested twice fills both slots.
+  std::vector<Value> repeated;
+  ASSERT_EQ(0, rd.Decode(key, value, std::vector<int>{1, 0, 1}, repeated));
+  EXPECT_EQ(record[1], repeated[0]);
+  EXPECT_EQ(record[0], repeated[1]);
+  EXPECT_EQ(record[1], repeated[2]);
+
+  for (size_t i = 0; i < schemas.size(); ++i) {
+    EXPECT_EQ(any_record[i].has_value(), ValueToAny(decoded[i]).has_value());
+  }
+
+  // A value of the wrong type is rejected.
+  record[8] = int64_t(1);
+  EXPECT_THROW(re.Encode('r', record, key, value), std::runtime_error);
+
+  DeleteSchemas();
+  DeleteRecords();
+}
+
+TEST_F(DingoSerialTest, encodeReusesOutput) {
+  InitVector();
+  auto schemas = GetSchemas();
+  InitRecord();
+  const auto& record = GetRecord();
+
+  RecordEncoderV2 re(0, schemas, 0L, this->le);
+  std::string key, value;
+  ASSERT_EQ(0, re.Encode('r', record, key, value));
+
+  // Encoding again into the same strings reuses their storage.
+  const char* key_storage = key.data();
+  const char* value_storage = value.data();
+  std::string key2 = key, value2 = value;
+  ASSERT_EQ(0, re.Encode('r', record, key, value));
+  EXPECT_EQ(key_storage, key.data());
+  EXPECT_EQ(value_storage, value.data());
+  EXPECT_EQ(key2, key);
+  EXPECT_EQ(value2, value);
+
+  // A fresh output gets exactly the encoded bytes.
+  std::string key3, value3;
+  ASSERT_EQ(0, re.Encode('r', record, key3, value3));
+  EXPECT_EQ(key, key3);
+  EXPECT_EQ(value, value3);
+
+  std::string prefix;
+  ASSERT_EQ(9, re.EncodeMinKeyPrefix('r', prefix));
+  EXPECT_EQ(key.substr(0, 9), prefix);
+
+  DeleteSchemas();
+  DeleteRecords();
+}
+
+TEST_F(DingoSerialTest, computeEncodedSize) {
+  InitVector();
+  auto schemas = GetSchemas();
+  InitRecord();
+  const auto& record = GetRecord();
+
+  std::vector<Value> value_record(record.size());
+  for (size_t i = 0; i < schemas.size(); ++i) {
+    value_record[i] = AnyToValue(record[i], schemas[i]->GetType());
+  }
+
+  RecordEncoderV2 re(0, schemas, 0L, this->le);
+  std::string key, value;
+  ASSERT_EQ(0, re.Encode('r', record, key, value));
+
+  size_t key_size = 0;
+  size_t value_size = 0;
+  ASSERT_EQ(0, re.ComputeEncodedSize(record, key_size, value_size));
+  EXPECT_EQ(key.size(), key_size);
+  EXPECT_EQ(value.size(), value_size);
+
+  key_size = value_size = 0;
+  ASSERT_EQ(0, re.ComputeEncodedSize(value_record, key_size, value_size));
+  EXPECT_EQ(key.size(), key_size);
+  EXPECT_EQ(value.size(), value_size);
+
+  DeleteSchemas();
+  DeleteRecords();
+}
+
+TEST_F(DingoSerialTest, encodeBatch) {
+  InitVector();
+  auto schemas = GetSchemas();
+  InitRecord();
+
+  std::vector<std::vector<std::any>> records;
+  for (int i = 0; i < 10; ++i) {
+    auto record = GetRecord();
+    record.at(0) = int32_t(i);
+    if (i % 3 == 0) {
+      record.at(4) = std::any();
+      record.at(10) = std::any();
+    }
+    records.push_back(record);
+  }
+
+  RecordEncoderV2 re(0, schemas, 0L, this->le);
+  RecordDecoderV2 rd(0, schemas, 0L, this->le);
+  EncodedBatch batch;
+  ASSERT_EQ(0, re.EncodeBatch('r', records, batch));
+  ASSERT_EQ(records.size(), batch.Size());
+
+  for (size_t i = 0; i < records.size(); ++i) {
+    std::string key, value;
+    ASSERT_EQ(0, re.Encode('r', records[i], key, value));
+    EXPECT_EQ(key, batch.GetKey(i));
+    EXPECT_EQ(value, batch.GetValue(i));
+
+    std::vector<std::any> decoded;
+    ASSERT_EQ(0, rd.Decode(batch.GetKey(i), batch.GetValue(i), decoded));
+    EXPECT_EQ(i, std::any_cast<int32_t>(decoded.at(0)));
+    EXPECT_EQ(i % 3 != 0, decoded.at(10).has_value());
+  }
+
+  // A second batch of the same shape reuses the arenas.
+  const char* keys = batch.keys.data();
+  const char* values = batch.values.data();
+  ASSERT_EQ(0, re.EncodeBatch('r', records, batch));
+  EXPECT_EQ(keys, batch.keys.data());
+  EXPECT_EQ(values, batch.values.data());
+
+  ASSERT_EQ(0, re.EncodeBatch('r', std::vector<std::vector<Value>>(), batch));
+  EXPECT_EQ(0, batch.Size());
+
+  DeleteSchemas();
+  DeleteRecords();
+}
+
+TEST_F(DingoSerialTest, decodeBatch) {
+  InitVector();
+  auto schemas = GetSchemas();
+  InitRecord();
+
+  RecordEncoderV2 re(0, schemas, 0L, this->le);
+  RecordDecoderV2 rd(0, schemas, 0L, this->le);
+
+  std::vector<KeyValue> key_values;
+  for (int i = 0; i < 20; ++i) {
+    auto record = GetRecord();
+    record.at(0) = int32_t(i);
+    record.at(1) = std::string(i, 'n');
+    if (i % 3 == 0) {
+      record.at(4) = std::any();
+      record.at(10) = std::any();
+    }
+    std::string key, value;
+    ASSERT_EQ(0, re.Encode('r', record, key, value));
+    key_values.emplace_back(key, value);
+  }
+
+  // Keys out of order and repeated, a null column and an unknown one.
+  std::vector<int> column_indexes{3, 1, 0, 1, 4, 6, 8, 10, 5, 99};
+  std::vector<ColumnVector> columns;
+  ASSERT_EQ(0, rd.DecodeBatch(key_values, column_indexes, columns));
+  ASSERT_EQ(column_indexes.size(), columns.size());
+
+  EXPECT_EQ(BaseSchema::kLong, columns[0].type);
+  EXPECT_EQ(BaseSchema::kString, columns[1].type);
+  EXPECT_EQ(BaseSchema::kInteger, columns[2].type);
+  EXPECT_EQ(BaseSchema::kDouble, columns[7].type);
+  for (size_t i = 0; i < key_values.size(); ++i) {
+    EXPECT_EQ(214748364700L, columns[0].longs[i]);
+    EXPECT_EQ(std::string(i, 'n'), columns[1].GetString(i));
+    EXPECT_EQ(i, columns[2].ints[i]);
+    EXPECT_EQ(std::string(i, 'n'), columns[3].GetString(i));
+    EXPECT_EQ(i % 3 == 0, columns[4].IsNull(i));
+    if (i % 3 != 0) {
+      EXPECT_EQ(std::any_cast<std::string>(GetRecord().at(4)),
+                columns[4].GetString(i));
+    }
+    EXPECT_TRUE(columns[5].IsNull(i));
+    EXPECT_EQ(-20, columns[6].ints[i]);
+    EXPECT_EQ(i % 3 == 0, columns[7].IsNull(i));
+    EXPECT_EQ(i % 3 == 0 ? 0 : 873485.4234, columns[7].doubles[i]);
+    EXPECT_FALSE(columns[8].IsNull(i));
+    EXPECT_FALSE(columns[8].bools[i]);
+    EXPECT_TRUE(columns[9].IsNull(i));
+  }
+
+  // A second batch reuses the column buffers.
+  const int64_t* longs = columns[0].longs.data();
+  ASSERT_EQ(0, rd.DecodeBatch(key_values, column_indexes, columns));
+  EXPECT_EQ(longs, columns[0].longs.data());
+
+  key_values.back().SetKey(key_values.back().GetKey().substr(1));
+  EXPECT_EQ(-1, rd.DecodeBatch(key_values, column_indexes, columns));
+
+  DeleteSchemas();
+  DeleteRecords();
+}
+
+TEST_F(DingoSerialTest, decodeFiltered) {
+  InitVector();
+  auto schemas = GetSchemas();
+  InitRecord();
+
+  RecordEncoderV2 re(0, schemas, 0L, this->le);
+  RecordDecoderV2 rd(0, schemas, 0L, this->le);
+
+  std::vector<KeyValue> key_values;
+  for (int i = 0; i < 30; ++i) {
+    auto record = GetRecord();
+    record.at(0) = int32_t(i);
+    record.at(1) = "n" + std::to_string(i);
+    record.at(3) = int64_t(-1000) * i;
+    record.at(8) = int32_t(i - 10);
+    if (i % 3 == 0) {
+      record.at(4) = std::any();
+      record.at(10) = std::any();
+    }
+    std::string key, value;
+    ASSERT_EQ(0, re.Encode('r', record, key, value));
+    key_values.emplace_back(key, value);
+  }
+  std::string addr = std::any_cast<std::string>(GetRecord().at(4));
+
+  auto filtered_ids = [&](const std::vector<Predicate>& predicates) {
+    std::vector<std::vector<Value>> records;
+    EXPECT_EQ(0, rd.DecodeFiltered(key_values, rd.CompileFilter(predicates),
+                                   {0, 1}, records));
+    std::vector<int32_t> ids;
+    for (const auto& record : records) {
+      ids.push_back(std::get<int32_t>(record[0]));
+      EXPECT_EQ("n" + std::to_string(ids.back()),
+                std::get<std::string>(record[1]));
+    }
+    return ids;
+  };
+  auto expected_ids = [](const std::function<bool(int)>& pass) {
+    std::vector<int32_t> ids;
+    for (int i = 0; i < 30; ++i) {
+      if (pass(i)) {
+        ids.push_back(i);
+      }
+    }
+    return ids;
+  };
+
+  // Key columns.
+  EXPECT_EQ(expected_ids([](int i) { return i >= 5 && i <= 9; }),
+            filtered_ids({{0, Predicate::kBetween, {int32_t(5), int32_t(9)}}}));
+  EXPECT_EQ(expected_ids([](int i) { return i == 3 || i == 17; }),
+            filtered_ids({{1,
+                           Predicate::kIn,
+                           {std::string("n3"), std::string("n17"),
+                            std::string("n100")}}}));
+  EXPECT_EQ(expected_ids([](int i) { return i > 25; }),
+            filtered_ids({{3, Predicate::kLess, {int64_t(-25000)}}}));
+  EXPECT_EQ(expected_ids([](int i) { return i == 4; }),
+            filtered_ids({{1, Predicate::kEqual, {std::string("n4")}},
+                          {1, Predicate::kLessEqual, {std::string("n4")}}}));
+
+  // Value columns.
+  EXPECT_EQ(expected_ids([](int i) { return i % 3 == 0; }),
+            filtered_ids({{4, Predicate::kIsNull, {}}}));
+  EXPECT_EQ(expected_ids([](int i) { return i % 3 != 0; }),
+            filtered_ids({{4, Predicate::kEqual, {addr}}}));
+  EXPECT_EQ(expected_ids([](int i) { return i < 8; }),
+            filtered_ids({{8, Predicate::kLess, {int32_t(-2)}}}));
+  EXPECT_EQ(expected_ids([](int i) { return i % 3 != 0 && i <= 10; }),
+            filtered_ids({{10, Predicate::kEqual, {873485.4234}},
+                          {8, Predicate::kLessEqual, {int32_t(0)}}}));
+
+  // Key and value columns together.
+  EXPECT_EQ(expected_ids([](int i) { return i % 3 == 0 && i >= 20; }),
+            filtered_ids(
+                {{10, Predicate::kIsNull, {}},
+                 {0, Predicate::kBetween, {int32_t(20), int32_t(99)}}}));
+  EXPECT_TRUE(filtered_ids({{0, Predicate::kIsNull, {}}}).empty());
+  EXPECT_EQ(30, filtered_ids({}).size());
+
+  EXPECT_THROW(rd.CompileFilter({{11, Predicate::kIsNull, {}}}),
+               std::runtime_error);
+  EXPECT_THROW(rd.CompileFilter({{0, Predicate::kEqual, {int64_t(1)}}}),
+               std::runtime_error);
+  EXPECT_THROW(rd.CompileFilter({{0, Predicate::kBetween, {int32_t(1)}}}),
+               std::runtime_error);
+  EXPECT_THROW(rd.CompileFilter({{0, Predicate::kEqual, {Value()}}}),
+               std::runtime_error);
+
+  DeleteSchemas();
+  DeleteRecords();
+}
+
+TEST_F(DingoSerialTest, filterNullableKey) {
+  std::vector<BaseSchemaPtr> schemas;
+  auto name = std::make_shared<DingoSchema<std::string>>();
+  name->SetIndex(0);
+  name->SetAllowNull(true);
+  name->SetIsKey(true);
+  schemas.push_back(name);
+  auto id = std::make_shared<DingoSchema<int32_t>>();
+  id->SetIndex(1);
+  id->SetAllowNull(false);
+  id->SetIsKey(true);
+  schemas.push_back(id);
+
+  RecordEncoderV2 re(0, schemas, 0L, this->le);
+  RecordDecoderV2 rd(0, schemas, 0L, this->le);
+
+  std::string key, value;
+  ASSERT_EQ(0, re.Encode('r', std::vector<Value>{Value(), int32_t(1)}, key,
+                         value));
+  auto is_null = rd.CompileFilter({{0, Predicate::kIsNull, {}}});
+  auto less = rd.CompileFilter({{0, Predicate::kLess, {std::string("a")}}});
+  auto id_equal = rd.CompileFilter({{1, Predicate::kEqual, {int32_t(1)}}});
+  EXPECT_EQ(1, rd.Match(key, value, is_null));
+  EXPECT_EQ(0, rd.Match(key, value, less));
+  EXPECT_EQ(1, rd.Match(key, value, id_equal));
+
+  ASSERT_EQ(0, re.Encode('r', std::vector<Value>{std::string(""), int32_t(1)},
+                         key, value));
+  EXPECT_EQ(0, rd.Match(key, value, is_null));
+  EXPECT_EQ(1, rd.Match(key, value, less));
+  EXPECT_EQ(1, rd.Match(key, value, id_equal));
+
+  EXPECT_EQ(-1, rd.Match(key.substr(1), value, id_equal));
+}
+
+TEST_F(DingoSerialTest, aggregate) {
+  InitVector();
+  auto schemas = GetSchemas();
+  InitRecord();
+
+  RecordEncoderV2 re(0, schemas, 0L, this->le);
+  RecordDecoderV2 rd(0, schemas, 0L, this->le);
+
+  std::vector<KeyValue> first;
+  std::vector<KeyValue> second;
+  for (int i = 0; i < 30; ++i) {
+    auto record = GetRecord();
+    record.at(0) = int32_t(i);
+    record.at(3) = int64_t(-1000) * i;
+    record.at(8) = int32_t(i - 10);
+    record.at(10) = i % 3 == 0 ? std::any() : std::any(i * 0.5);
+    std::string key, value;
+    ASSERT_EQ(0, re.Encode('r', record, key, value));
+    (i < 12 ? first : second).emplace_back(key, value);
+  }
+
+  // Batches of one stream accumulate into the same result.
+  AggregateResult age;
+  ASSERT_EQ(0, rd.Aggregate(first, 8, age));
+  ASSERT_EQ(0, rd.Aggregate(second, 8, age));
+  EXPECT_EQ(30, age.rows);
+  EXPECT_EQ(30, age.count);
+  EXPECT_EQ(135, age.long_sum);
+  EXPECT_EQ(-10, std::get<int32_t>(age.min));
+  EXPECT_EQ(19, std::get<int32_t>(age.max));
+
+  AggregateResult salary;
+  ASSERT_EQ(0, rd.Aggregate(first, 10, salary));
+  ASSERT_EQ(0, rd.Aggregate(second, 10, salary));
+  double salary_sum = 0;
+  for (int i = 0; i < 30; ++i) {
+    salary_sum += i % 3 == 0 ? 0 : i * 0.5;
+  }
+  EXPECT_EQ(30, salary.rows);
+  EXPECT_EQ(20, salary.count);
+  EXPECT_DOUBLE_EQ(salary_sum, salary.double_sum);
+  EXPECT_EQ(0.5, std::get<double>(salary.min));
+  EXPECT_EQ(14.5, std::get<double>(salary.max));
+
+  AggregateResult score;
+  ASSERT_EQ(0, rd.Aggregate(second, 3, score));
+  EXPECT_EQ(18, score.count);
+  EXPECT_EQ(-1000L * (12 + 29) * 18 / 2, score.long_sum);
+  EXPECT_EQ(-29000L, std::get<int64_t>(score.min));
+  EXPECT_EQ(-12000L, std::get<int64_t>(score.max));
+
+  AggregateResult none;
+  ASSERT_EQ(0, rd.Aggregate({}, 8, none));
+  EXPECT_EQ(0, none.count);
+  EXPECT_TRUE(IsNull(none.min));
+
+  EXPECT_THROW(rd.Aggregate(first, 4, none), std::runtime_error);
+  EXPECT_THROW(rd.Aggregate(first, 11, none), std::runtime_error);
+
+  DeleteSchemas();
+  DeleteRecords();
+}
+
+TEST_F(DingoSerialTest, recordView) {
+  InitVector();
+  auto schemas = GetSchemas();
+  InitRecord();
+  const auto& record = GetRecord();
+
+  RecordEncoderV2 re(0, schemas, 0L, this->le);
+  RecordDecoderV2 rd(0, schemas, 0L, this->le);
+  std::string key, value;
+  ASSERT_EQ(0, re.Encode('r', record, key, value));
+
+  RecordView view;
+  ASSERT_EQ(0, rd.View(key, value, view));
+
+  // Out of order, so later key columns are located before earlier ones.
+  EXPECT_EQ(std::any_cast<int64_t>(record.at(3)), view.GetInt64(3));
+  EXPECT_EQ(std::any_cast<std::string>(record.at(1)), view.GetString(1));
+  EXPECT_EQ(std::any_cast<int32_t>(record.at(0)), view.GetInt32(0));
+  EXPECT_EQ(std::any_cast<std::string>(record.at(2)), view.GetString(2));
+  EXPECT_EQ(std::any_cast<std::string>(record.at(4)), view.GetString(4));
+  EXPECT_EQ(std::any_cast<bool>(record.at(5)), view.GetBool(5));
+  EXPECT_EQ(std::any_cast<int32_t>(record.at(8)), view.GetInt32(8));
+  EXPECT_EQ(std::any_cast<int64_t>(record.at(9)), view.GetInt64(9));
+  EXPECT_EQ(std::any_cast<double>(record.at(10)), view.GetDouble(10));
+
+  EXPECT_FALSE(view.IsNull(1));
+  EXPECT_FALSE(view.IsNull(4));
+  EXPECT_TRUE(view.IsNull(6));
+  EXPECT_TRUE(view.IsNull(7));
+  EXPECT_TRUE(IsNull(view.GetValue(7)));
+  EXPECT_EQ(std::any_cast<int64_t>(record.at(9)),
+            std::get<int64_t>(view.GetValue(9)));
+  EXPECT_EQ(std::any_cast<std::string>(record.at(2)),
+            std::get<std::string>(view.GetValue(2)));
+
+  EXPECT_THROW(view.GetInt32(7), std::runtime_error);
+  EXPECT_THROW(view.GetInt64(8), std::runtime_error);
+  EXPECT_THROW(view.IsNull(11), std::runtime_error);
+
+  // A corrupt string length is refused instead of read past the value.
+  BufView value_buf(value, this->le);
+  value_buf.Skip(4);
+  auto plan = CodecPlan::Build(schemas);
+  int offset = ValueHeader(value_buf).FindOffset(value_buf, plan.columns[4]);
+  auto filter =
+      rd.CompileFilter({{4, Predicate::kEqual, {std::string("a")}}});
+  for (int32_t size : {-1, 1 << 30}) {
+    Buf size_buf(4, this->le);
+    size_buf.WriteInt(size);
+    std::string corrupt = value;
+    corrupt.replace(offset, 4, size_buf.GetString());
+    ASSERT_EQ(0, rd.View(key, corrupt, view));
+    EXPECT_ANY_THROW(view.GetString(4));
+    EXPECT_ANY_THROW(rd.Match(key, corrupt, filter));
+  }
+
+  // Refilling the view with another row drops the cached key columns.
+  auto other = record;
+  other.at(1) = std::string("other");
+  other.at(7) = int32_t(7);
+  std::string other_key, other_value;
+  ASSERT_EQ(0, re.Encode('r', other, other_key, other_value));
+  ASSERT_EQ(0, rd.View(other_key, other_value, view));
+  EXPECT_EQ("other", view.GetString(1));
+  EXPECT_EQ(7, view.GetInt32(7));
+
+  EXPECT_EQ(-1, rd.View(key.substr(1), value, view));
+
+  DeleteSchemas();
+  DeleteRecords();
+}
+
+TEST_F(DingoSerialTest, compactValueHeader) {
+  InitVector();
+  auto schemas = GetSchemas();
+  InitRecord();
+  const auto& record = GetRecord();
+
+  RecordEncoderV2 re_v2(0, schemas, 0L, this->le);
+  RecordEncoderV2 re_v3(0, schemas, 0L, this->le);
+  re_v3.SetCodecVersion(CODEC_VERSION_V3);
+  EXPECT_THROW(re_v3.SetCodecVersion(CODEC_VERSION_V1), std::runtime_error);
+  RecordDecoderV2 rd(0, schemas, 0L, this->le);
+
+  std::string key_v2, value_v2, key_v3, value_v3;
+  ASSERT_EQ(0, re_v2.Encode('r', record, key_v2, value_v2));
+  ASSERT_EQ(0, re_v3.Encode('r', record, key_v3, value_v3));
+
+  // Same key columns, only the trailing codec version differs. 7 value
+  // columns save 7 id bytes and 14 offset bytes for one units byte.
+  EXPECT_EQ(key_v2.substr(0, key_v2.size() - 4),
+            key_v3.substr(0, key_v3.size() - 4));
+  EXPECT_EQ(value_v2.size() - 7 - 14 + 1, value_v3.size());
+
+  size_t key_size, value_size;
+  re_v3.ComputeEncodedSize(record, key_size, value_size);
+  EXPECT_EQ(key_v3.size(), key_size);
+  EXPECT_EQ(value_v3.size(), value_size);
+
+  std::vector<std::any> decoded_v2, decoded_v3;
+  ASSERT_EQ(0, rd.Decode(key_v2, value_v2, decoded_v2));
+  ASSERT_EQ(0, rd.Decode(key_v3, value_v3, decoded_v3));
+  for (size_t i = 0; i < record.size(); ++i) {
+    EXPECT_EQ(IsNull(record[i]), IsNull(decoded_v3[i]));
+  }
+  EXPECT_EQ(std::any_cast<std::string>(record.at(4)),
+            std::any_cast<std::string>(decoded_v3.at(4)));
+  EXPECT_EQ(std::any_cast<double>(record.at(10)),
+            std::any_cast<double>(decoded_v3.at(10)));
+
+  RecordView view;
+  ASSERT_EQ(0, rd.View(key_v3, value_v3, view));
+  EXPECT_EQ(std::any_cast<int64_t>(record.at(9)), view.GetInt64(9));
+  EXPECT_TRUE(view.IsNull(7));
+
+  // Values of 64KB and more fall back to 4 byte offsets.
+  auto large = record;
+  large.at(4) = std::string(70000, 'x');
+  ASSERT_EQ(0, re_v3.Encode('r', large, key_v3, value_v3));
+  re_v3.ComputeEncodedSize(large, key_size, value_size);
+  EXPECT_EQ(value_v3.size(), value_size);
+  ASSERT_EQ(0, rd.Decode(key_v3, value_v3, decoded_v3));
+  EXPECT_EQ(70000, std::any_cast<std::string>(decoded_v3.at(4)).size());
+  EXPECT_EQ(std::any_cast<int64_t>(record.at(9)),
+            std::any_cast<int64_t>(decoded_v3.at(9)));
+  EXPECT_FALSE(decoded_v3.at(7).has_value());
+
+  EncodedBatch batch;
+  ASSERT_EQ(0, re_v3.EncodeBatch('r', {record, large}, batch));
+  ASSERT_EQ(0, re_v3.Encode('r', record, key_v3, value_v3));
+  EXPECT_EQ(value_v3, batch.GetValue(0));
+
+  DeleteSchemas();
+  DeleteRecords();
+}
+
+TEST_F(DingoSerialTest, compactValueHeaderWideRow) {
+  // Ids of 255 and above need 2 bytes.
+  std::vector<BaseSchemaPtr> schemas;
+  for (int i = 0; i < 300; ++i) {
+    auto column = std::make_shared<DingoSchema<int32_t>>();
+    column->SetIndex(i);
+    column->SetAllowNull(true);
+    column->SetIsKey(i == 0);
+    schemas.push_back(column);
+  }
+  std::vector<Value> record(schemas.size());
+  for (size_t i = 0; i < record.size(); i += 2) {
+    record[i] = int32_t(i);
+  }
+
+  RecordEncoderV2 re(0, schemas, 0L, this->le);
+  re.SetCodecVersion(CODEC_VERSION_V3);
+  RecordDecoderV2 rd(0, schemas, 0L, this->le);
+
+  std::string key, value;
+  ASSERT_EQ(0, re.Encode('r', record, key, value));
+  std::vector<Value> decoded;
+  ASSERT_EQ(0, rd.Decode(key, value, decoded));
+  EXPECT_EQ(record, decoded);
+}
+
+TEST_F(DingoSerialTest, denseValue) {
+  InitVector();
+  auto schemas = GetSchemas();
+  InitRecord();
+  const auto& record = GetRecord();
+
+  RecordEncoderV2 re_v3(0, schemas, 0L, this->le);
+  EXPECT_THROW(re_v3.SetDenseValue(true), std::runtime_error);
+  re_v3.SetCodecVersion(CODEC_VERSION_V3);
+  RecordEncoderV2 re_dense(0, schemas, 0L, this->le);
+  re_dense.SetCodecVersion(CODEC_VERSION_V3);
+  re_dense.SetDenseValue(true);
+  RecordDecoderV2 rd(0, schemas, 0L, this->le);
+
+  std::string key_v3, value_v3, key_dense, value_dense;
+  ASSERT_EQ(0, re_v3.Encode('r', record, key_v3, value_v3));
+  ASSERT_EQ(0, re_dense.Encode('r', record, key_dense, value_dense));
+
+  // No 7 id bytes and no offsets for the 2 null columns, one bitmap byte.
+  EXPECT_EQ(key_v3, key_dense);
+  EXPECT_EQ(value_v3.size() - 7 - 2 * 2 + 1, value_dense.size());
+
+  size_t key_size, value_size;
+  re_dense.ComputeEncodedSize(record, key_size, value_size);
+  EXPECT_EQ(value_dense.size(), value_size);
+
+  std::vector<std::any> decoded;
+  ASSERT_EQ(0, rd.Decode(key_dense, value_dense, decoded));
+  for (size_t i = 0; i < record.size(); ++i) {
+    EXPECT_EQ(IsNull(record[i]), IsNull(decoded[i]));
+  }
+  EXPECT_EQ(std::any_cast<std::string>(record.at(4)),
+            std::any_cast<std::string>(decoded.at(4)));
+  EXPECT_EQ(std::any_cast<int32_t>(record.at(8)),
+            std::any_cast<int32_t>(decoded.at(8)));
+  EXPECT_EQ(std::any_cast<double>(record.at(10)),
+            std::any_cast<double>(decoded.at(10)));
+
+  RecordView view;
+  ASSERT_EQ(0, rd.View(key_dense, value_dense, view));
+  EXPECT_EQ(std::any_cast<int64_t>(record.at(9)), view.GetInt64(9));
+  EXPECT_TRUE(view.IsNull(6));
+  EXPECT_TRUE(view.IsNull(7));
+
+  // A value cut inside its bitmap or offsets is refused up front.
+  for (size_t size : {size_t(9), size_t(10), size_t(12)}) {
+    std::string cut = value_dense.substr(0, size);
+    EXPECT_THROW(rd.Decode(key_dense, cut, decoded), std::out_of_range);
+    EXPECT_THROW(rd.View(key_dense, cut, view), std::out_of_range);
+  }
+
+  // Large values switch to 4 byte offsets, batches match single rows.
+  auto large = record;
+  large.at(4) = std::string(70000, 'x');
+  std::string large_value;
+  ASSERT_LT(0, re_dense.EncodeValue(large, large_value));
+  re_dense.ComputeEncodedSize(large, key_size, value_size);
+  EXPECT_EQ(large_value.size(), value_size);
+  ASSERT_EQ(0, rd.Decode(key_dense, large_value, decoded));
+  EXPECT_EQ(70000, std::any_cast<std::string>(decoded.at(4)).size());
+  EXPECT_EQ(std::any_cast<double>(record.at(10)),
+            std::any_cast<double>(decoded.at(10)));
+
+  EncodedBatch batch;
+  ASSERT_EQ(0, re_dense.EncodeBatch('r', {record, large}, batch));
+  EXPECT_EQ(value_dense, batch.GetValue(0));
+  EXPECT_EQ(large_value, batch.GetValue(1));
+
+  // Back to V2 turns dense values off.
+  re_dense.SetCodecVersion(CODEC_VERSION_V2);
+  EXPECT_FALSE(re_dense.IsDenseValue());
+
+  DeleteSchemas();
+  DeleteRecords();
+}
+
+TEST_F(DingoSerialTest, denseValueWideRow) {
+  // Spans several bitmap words, with a value column appended by a later
+  // schema version that old rows read as null.
+  auto make_schemas = [](int count) {
+    std::vector<BaseSchemaPtr> schemas;
+    for (int i = 0; i < count; ++i) {
+      auto column = std::make_shared<DingoSchema<int64_t>>();
+      column->SetIndex(i);
+      column->SetAllowNull(true);
+      column->SetIsKey(i == 0);
+      schemas.push_back(column);
+    }
+    return schemas;
+  };
+  auto schemas = make_schemas(300);
+  auto appended = make_schemas(301);
+
+  RecordEncoderV2 re(0, schemas, 0L, this->le);
+  re.SetCodecVersion(CODEC_VERSION_V3);
+  re.SetDenseValue(true);
+  RecordDecoderV2 rd(0, schemas, 0L, this->le);
+  RecordDecoderV2 rd_appended(0, appended, 0L, this->le);
+
+  std::vector<KeyValue> key_values;
+  std::vector<std::vector<Value>> records;
+  for (int row = 0; row < 4; ++row) {
+    std::vector<Value> record(schemas.size());
+    record[0] = int64_t(row);
+    for (size_t i = 1; i < record.size(); ++i) {
+      if ((i * 7 + row) % 3 != 0) {
+        record[i] = int64_t(i) * 1000 + row;
+      }
+    }
+    std::string key, value;
+    ASSERT_EQ(0, re.Encode('r', record, key, value));
+    key_values.emplace_back(key, value);
+    records.push_back(record);
+  }
+
+  for (size_t row = 0; row < records.size(); ++row) {
+    std::vector<Value> decoded;
+    ASSERT_EQ(0, rd.Decode(key_values[row].GetKey(),
+                           key_values[row].GetValue(), decoded));
+    EXPECT_EQ(records[row], decoded);
+
+    ASSERT_EQ(0, rd_appended.Decode(key_values[row].GetKey(),
+                                    key_values[row].GetValue(), decoded));
+    ASSERT_EQ(appended.size(), decoded.size());
+    EXPECT_TRUE(IsNull(decoded.back()));
+    decoded.pop_back();
+    EXPECT_EQ(records[row], decoded);
+  }
+
+  AggregateResult result;
+  ASSERT_EQ(0, rd.Aggregate(key_values, 299, result));
+  int64_t sum = 0;
+  int count = 0;
+  for (const auto& record : records) {
+    if (!IsNull(record[299])) {
+      sum += std::get<int64_t>(record[299]);
+      ++count;
+    }
+  }
+  EXPECT_EQ(count, result.count);
+  EXPECT_EQ(sum, result.long_sum);
+}
+
+TEST_F(DingoSerialTest, sparseValue) {
+  // 500 nullable value columns, ids not in schema order, a few set per row.
+  std::vector<BaseSchemaPtr> schemas;
+  auto id = std::make_shared<DingoSchema<int32_t>>();
+  id->SetIndex(0);
+  id->SetIsKey(true);
+  id->SetAllowNull(false);
+  schemas.push_back(id);
+  for (int i = 1; i <= 500; ++i) {
+    auto column = std::make_shared<DingoSchema<int32_t>>();
+    column->SetIndex(501 - i);
+    column->SetAllowNull(true);
+    column->SetIsKey(false);
+    schemas.push_back(column);
+  }
+
+  RecordEncoderV2 re(0, schemas, 0L, this->le);
+  re.SetCodecVersion(CODEC_VERSION_V3);
+  RecordEncoderV2 re_dense(0, schemas, 0L, this->le);
+  re_dense.SetCodecVersion(CODEC_VERSION_V3);
+  re_dense.SetDenseValue(true);
+  RecordDecoderV2 rd(0, schemas, 0L, this->le);
+
+  std::vector<std::vector<Value>> records;
+  for (int row = 0; row < 3; ++row) {
+    std::vector<Value> record(schemas.size());
+    record[0] = int32_t(row);
+    for (size_t i = 1 + row; i < record.size(); i += 37) {
+      record[i] = int32_t(i * 10 + row);
+    }
+    records.push_back(record);
+  }
+  // Records are indexed by id, id 1 is the first entry of the id table.
+  records[0][1] = int32_t(-1);
+
+  std::vector<KeyValue> key_values;
+  for (const auto& record : records) {
+    int cnt_not_null = 0;
+    for (size_t i = 1; i < record.size(); ++i) {
+      cnt_not_null += IsNull(record[i]) ? 0 : 1;
+    }
+
+    std::string key, value, dense_value;
+    ASSERT_EQ(0, re.Encode('r', record, key, value));
+    ASSERT_LT(0, re_dense.EncodeValue(record, dense_value));
+    // schema_version | units | counts | 2 byte ids and offsets | data
+    EXPECT_EQ(4 + 1 + 4 + cnt_not_null * (2 + 2 + 4), value.size());
+    // Dense rows stay dense unless sparse halves their table, which the null
+    // bitmap prevents here.
+    EXPECT_LT(value.size(), dense_value.size());
+
+    size_t key_size, value_size;
+    re.ComputeEncodedSize(record, key_size, value_size);
+    EXPECT_EQ(value.size(), value_size);
+
+    std::vector<Value> decoded;
+    ASSERT_EQ(0, rd.Decode(key, value, decoded));
+    EXPECT_EQ(record, decoded);
+    ASSERT_EQ(0, rd.Decode(key, dense_value, decoded));
+    EXPECT_EQ(record, decoded);
+    key_values.emplace_back(key, value);
+  }
+
+  // Views and aggregates take schema positions, position p holds id 501 - p.
+  RecordView view;
+  ASSERT_EQ(0, rd.View(key_values[0].GetKey(), key_values[0].GetValue(),
+                       view));
+  EXPECT_EQ(-1, view.GetInt32(500));
+  EXPECT_EQ(380, view.GetInt32(501 - 38));
+  EXPECT_TRUE(view.IsNull(501 - 2));
+
+  AggregateResult result;
+  ASSERT_EQ(0, rd.Aggregate(key_values, 501 - 38, result));
+  EXPECT_EQ(1, result.count);
+  EXPECT_EQ(380, result.long_sum);
+
+  EncodedBatch batch;
+  ASSERT_EQ(0, re.EncodeBatch('r', records, batch));
+  for (size_t row = 0; row < records.size(); ++row) {
+    EXPECT_EQ(key_values[row].GetValue(), batch.GetValue(row));
+  }
+
+  // Rows with most columns set keep the full table.
+  std::vector<Value> full(schemas.size(), int32_t(7));
+  std::string key, value;
+  ASSERT_EQ(0, re.Encode('r', full, key, value));
+  EXPECT_EQ(4 + 1 + 4 + 500 * (2 + 2 + 4), value.size());
+  std::vector<Value> decoded;
+  ASSERT_EQ(0, rd.Decode(key, value, decoded));
+  EXPECT_EQ(full, decoded);
+}
+
+TEST_F(DingoSerialTest, fixedBlockValue) {
+  InitVector();
+  auto schemas = GetSchemas();
+  InitRecord();
+  const auto& record = GetRecord();
+
+  RecordEncoderV2 re(0, schemas, 0L, this->le);
+  EXPECT_THROW(re.SetFixedBlockValue(true), std::runtime_error);
+  re.SetCodecVersion(CODEC_VERSION_V3);
+  re.SetFixedBlockValue(true);
+  RecordDecoderV2 rd(0, schemas, 0L, this->le);
+
+  std::string key, value;
+  ASSERT_EQ(0, re.Encode('r', record, key, value));
+
+  // bool, 2 ints, long and double take 25 bytes, the null int included, and
+  // only the 2 strings have offsets.
+  size_t addr_size = std::any_cast<std::string>(record.at(4)).size();
+  EXPECT_EQ(4 + 1 + 4 + 1 + 2 + 25 + 2 * 2 + 4 + addr_size, value.size());
+
+  size_t key_size, value_size;
+  re.ComputeEncodedSize(record, key_size, value_size);
+  EXPECT_EQ(value.size(), value_size);
+
+  std::vector<std::any> decoded;
+  ASSERT_EQ(0, rd.Decode(key, value, decoded));
+  for (size_t i = 0; i < record.size(); ++i) {
+    EXPECT_EQ(IsNull(record[i]), IsNull(decoded[i]));
+  }
+  EXPECT_EQ(std::any_cast<std::string>(record.at(4)),
+            std::any_cast<std::string>(decoded.at(4)));
+  EXPECT_EQ(std::any_cast<bool>(record.at(5)),
+            std::any_cast<bool>(decoded.at(5)));
+  EXPECT_EQ(std::any_cast<int32_t>(record.at(8)),
+            std::any_cast<int32_t>(decoded.at(8)));
+  EXPECT_EQ(std::any_cast<int64_t>(record.at(9)),
+            std::any_cast<int64_t>(decoded.at(9)));
+  EXPECT_EQ(std::any_cast<double>(record.at(10)),
+            std::any_cast<double>(decoded.at(10)));
+
+  // Fixed width columns sit at the same offset whatever the strings hold.
+  auto plan = CodecPlan::Build(schemas);
+  auto large = record;
+  large.at(4) = std::string(70000, 'x');
+  std::string large_value;
+  ASSERT_LT(0, re.EncodeValue(large, large_value));
+  re.ComputeEncodedSize(large, key_size, value_size);
+  EXPECT_EQ(large_value.size(), value_size);
+  for (const auto* bytes : {&value, &large_value}) {
+    BufView value_buf(*bytes, this->le);
+    value_buf.Skip(4);
+    ValueHeader header(value_buf, CODEC_VERSION_V3);
+    EXPECT_TRUE(header.fixed_block);
+    EXPECT_EQ(4 + 1 + 4 + 1 + 2 + plan.columns[9].fixed_offset,
+              header.FindOffset(value_buf, plan.columns[9]));
+    EXPECT_EQ(-1, header.FindOffset(value_buf, plan.columns[7]));
+  }
+  ASSERT_EQ(0, rd.Decode(key, large_value, decoded));
+  EXPECT_EQ(70000, std::any_cast<std::string>(decoded.at(4)).size());
+  EXPECT_EQ(std::any_cast<double>(record.at(10)),
+            std::any_cast<double>(decoded.at(10)));
+
+  RecordView view;
+  ASSERT_EQ(0, rd.View(key, value, view));
+  EXPECT_EQ(std::any_cast<int64_t>(record.at(9)), view.GetInt64(9));
+  EXPECT_TRUE(view.IsNull(6));
+  EXPECT_TRUE(view.IsNull(7));
+
+  // A value cut inside its bitmap or fixed block is refused up front, and a
+  // block too small for the schema when a column is read.
+  for (size_t size : {size_t(9), size_t(11), size_t(20)}) {
+    std::string cut = value.substr(0, size);
+    EXPECT_THROW(rd.Decode(key, cut, decoded), std::out_of_range);
+    EXPECT_THROW(rd.View(key, cut, view), std::out_of_range);
+  }
+  std::string shrunk = value;
+  BufView shrunk_buf(shrunk, this->le);
+  size_t size_pos = 4 + 1 + 4 + 1;
+  int16_t block_size = shrunk_buf.ReadShort(size_pos);
+  Buf size_buf(2, this->le);
+  size_buf.WriteShort(static_cast<int16_t>(block_size - 8));
+  shrunk.replace(size_pos, 2, size_buf.GetString());
+  ASSERT_EQ(0, rd.View(key, shrunk, view));
+  EXPECT_THROW(view.GetDouble(10), std::out_of_range);
+
+  std::vector<KeyValue> key_values = {KeyValue(key, value),
+                                      KeyValue(key, large_value)};
+  AggregateResult result;
+  ASSERT_EQ(0, rd.Aggregate(key_values, 8, result));
+  EXPECT_EQ(2, result.count);
+  EXPECT_EQ(2 * std::any_cast<int32_t>(record.at(8)), result.long_sum);
+
+  EncodedBatch batch;
+  ASSERT_EQ(0, re.EncodeBatch('r', {record, large}, batch));
+  EXPECT_EQ(value, batch.GetValue(0));
+  EXPECT_EQ(large_value, batch.GetValue(1));
+
+  // A long and a string appended by a later schema version read as null.
+  auto appended = schemas;
+  auto extra_long = std::make_shared<DingoSchema<int64_t>>();
+  extra_long->SetIndex(11);
+  extra_long->SetAllowNull(true);
+  appended.push_back(extra_long);
+  auto extra_string = std::make_shared<DingoSchema<std::string>>();
+  extra_string->SetIndex(12);
+  extra_string->SetAllowNull(true);
+  appended.push_back(extra_string);
+  RecordDecoderV2 rd_appended(0, appended, 0L, this->le);
+  ASSERT_EQ(0, rd_appended.Decode(key, value, decoded));
+  EXPECT_FALSE(decoded.at(11).has_value());
+  EXPECT_FALSE(decoded.at(12).has_value());
+  EXPECT_EQ(std::any_cast<std::string>(record.at(4)),
+            std::any_cast<std::string>(decoded.at(4)));
+  EXPECT_EQ(std::any_cast<double>(record.at(10)),
+            std::any_cast<double>(decoded.at(10)));
+
+  // Back to V2 turns fixed block values off.
+  re.SetCodecVersion(CODEC_VERSION_V2);
+  EXPECT_FALSE(re.IsFixedBlockValue());
+
+  DeleteSchemas();
+  DeleteRecords();
+}
+
+TEST_F(DingoSerialTest, packedBoolList) {
+  std::vector<BaseSchemaPtr> schemas;
+  auto id = std::make_shared<DingoSchema<int64_t>>();
+  id->SetIndex(0);
+  id->SetIsKey(true);
+  schemas.push_back(id);
+  for (int i = 1; i < 4; ++i) {
+    auto flags = std::make_shared<DingoSchema<std::vector<bool>>>();
+    flags->SetIndex(i);
+    flags->SetAllowNull(true);
+    schemas.push_back(flags);
+  }
+  auto name = std::make_shared<DingoSchema<std::string>>();
+  name->SetIndex(4);
+  name->SetAllowNull(true);
+  schemas.push_back(name);
+
+  std::vector<bool> flags(1000);
+  for (size_t i = 0; i < flags.size(); ++i) {
+    flags[i] = i % 3 == 0;
+  }
+  std::vector<Value> record = {int64_t(7), flags, Value(),
+                               std::vector<bool>{true}, std::string("n")};
+
+  RecordEncoderV2 re(0, schemas, 0L, this->le);
+  EXPECT_THROW(re.SetPackedBoolList(true), std::runtime_error);
+  re.SetCodecVersion(CODEC_VERSION_V3);
+  RecordDecoderV2 rd(0, schemas, 0L, this->le);
+
+  for (bool fixed_block : {false, true}) {
+    re.SetFixedBlockValue(fixed_block);
+    re.SetPackedBoolList(false);
+    std::string key, plain_value;
+    ASSERT_EQ(0, re.Encode('r', record, key, plain_value));
+    re.SetPackedBoolList(true);
+    std::string value;
+    ASSERT_EQ(0, re.Encode('r', record, key, value));
+    // 1000 flags take 125 bytes, a single one still takes 1.
+    EXPECT_EQ(plain_value.size() - (1000 - 125), value.size());
+
+    size_t key_size, value_size;
+    re.ComputeEncodedSize(record, key_size, value_size);
+    EXPECT_EQ(value.size(), value_size);
+
+    std::vector<Value> decoded;
+    ASSERT_EQ(0, rd.Decode(key, value, decoded));
+    EXPECT_EQ(record, decoded);
+
+    std::vector<std::any> any_decoded;
+    ASSERT_EQ(0, rd.Decode(key, value, {4}, any_decoded));
+    EXPECT_EQ("n", std::any_cast<std::string>(any_decoded.at(0)));
+  }
+
+  re.SetCodecVersion(CODEC_VERSION_V2);
+  EXPECT_FALSE(re.IsPackedBoolList());
+  std::string key, value;
+  ASSERT_EQ(0, re.Encode('r', record, key, value));
+  std::vector<Value> decoded;
+  ASSERT_EQ(0, rd.Decode(key, value, decoded));
+  EXPECT_EQ(record, decoded);
+}
+
+TEST_F(DingoSerialTest, compactValue) {
+  std::vector<BaseSchemaPtr> schemas;
+  auto id = std::make_shared<DingoSchema<int64_t>>();
+  id->SetIndex(0);
+  id->SetIsKey(true);
+  schemas.push_back(id);
+  std::vector<BaseSchemaPtr> compact = {
+      std::make_shared<DingoSchema<int32_t>>(),
+      std::make_shared<DingoSchema<int64_t>>(),
+      std::make_shared<DingoSchema<std::vector<int32_t>>>(),
+      std::make_shared<DingoSchema<std::vector<int64_t>>>()};
+  for (auto& schema : compact) {
+    schema->SetIndex(schemas.size());
+    schema->SetAllowNull(true);
+    schema->SetCompactValue(true);
+    schemas.push_back(schema);
+  }
+  // A plain long and nullable doubles, nulls in the latter make rows sparse.
+  for (int i = 0; i < 9; ++i) {
+    BaseSchemaPtr schema;
+    if (i == 0) {
+      schema = std::make_shared<DingoSchema<int64_t>>();
+    } else {
+      schema = std::make_shared<DingoSchema<double>>();
+    }
+    schema->SetIndex(schemas.size());
+    schema->SetAllowNull(true);
+    schemas.push_back(schema);
+  }
+
+  auto make_record = [&](int i, bool sparse) {
+    std::vector<Value> record(schemas.size());
+    record[0] = int64_t(i);
+    record[1] = int32_t(i % 2 == 0 ? -i : i);
+    record[2] = int64_t(i) * 1000;
+    if (!sparse) {
+      record[3] = std::vector<int32_t>{i, -i, 1 << 20};
+      record[4] = std::vector<int64_t>(20, int64_t(i) - 10);
+      record[5] = int64_t(i) << 40;
+      for (size_t j = 6; j < schemas.size(); ++j) {
+        record[j] = double(i + j);
+      }
+    }
+    return record;
+  };
+
+  RecordEncoderV2 re(0, schemas, 0L, this->le);
+  RecordDecoderV2 rd(0, schemas, 0L, this->le);
+
+  // V2 keeps the fixed width form.
+  std::string key, v2_value;
+  ASSERT_EQ(0, re.Encode('r', make_record(3, false), key, v2_value));
+  std::vector<Value> decoded;
+  ASSERT_EQ(0, rd.Decode(key, v2_value, decoded));
+  EXPECT_EQ(make_record(3, false), decoded);
+
+  re.SetCodecVersion(CODEC_VERSION_V3);
+  for (bool fixed_block : {false, true}) {
+    re.SetFixedBlockValue(fixed_block);
+    std::vector<KeyValue> key_values;
+    for (int i = 0; i < 10; ++i) {
+      auto record = make_record(i, i % 4 == 3);
+      std::string key, value;
+      ASSERT_EQ(0, re.Encode('r', record, key, value));
+      size_t key_size, value_size;
+      re.ComputeEncodedSize(record, key_size, value_size);
+      ASSERT_EQ(value.size(), value_size);
+      if (i == 3 && !fixed_block) {
+        EXPECT_LT(value.size(), v2_value.size());
+      }
+
+      ASSERT_EQ(0, rd.Decode(key, value, decoded));
+      ASSERT_EQ(record, decoded);
+      std::vector<std::any> any_decoded;
+      ASSERT_EQ(0, rd.Decode(key, value, {2, 4, 1}, any_decoded));
+      ASSERT_EQ(int64_t(i) * 1000, std::any_cast<int64_t>(any_decoded[0]));
+      ASSERT_EQ(std::get<int32_t>(record[1]),
+                std::any_cast<int32_t>(any_decoded[2]));
+
+      RecordView view;
+      ASSERT_EQ(0, rd.View(key, value, view));
+      ASSERT_EQ(std::get<int32_t>(record[1]), view.GetInt32(1));
+      ASSERT_EQ(std::get<int64_t>(record[2]), view.GetInt64(2));
+      ASSERT_EQ(record[4], view.GetValue(4));
+      key_values.emplace_back(key, value);
+    }
+
+    std::vector<ColumnVector> columns;
+    ASSERT_EQ(0, rd.DecodeBatch(key_values, {1, 2, 3, 5}, columns));
+    for (size_t i = 0; i < key_values.size(); ++i) {
+      EXPECT_EQ(i % 2 == 0 ? -int32_t(i) : int32_t(i), columns[0].ints[i]);
+      EXPECT_EQ(i * 1000, columns[1].longs[i]);
+      EXPECT_EQ(i % 4 == 3, columns[2].IsNull(i));
+      EXPECT_EQ(i % 4 == 3, columns[3].IsNull(i));
+    }
+
+    auto filter = rd.CompileFilter(
+        {{1, Predicate::kLess, {int32_t(0)}},
+         {2, Predicate::kBetween, {int64_t(2000), int64_t(6000)}}});
+    std::vector<std::vector<Value>> records;
+    ASSERT_EQ(0, rd.DecodeFiltered(key_values, filter, {0}, records));
+    ASSERT_EQ(3, records.size());
+    EXPECT_EQ(int64_t(2), std::get<int64_t>(records[0][0]));
+    EXPECT_EQ(int64_t(6), std::get<int64_t>(records[2][0]));
+
+    AggregateResult result;
+    ASSERT_EQ(0, rd.Aggregate(key_values, 2, result));
+    EXPECT_EQ(10, result.count);
+    EXPECT_EQ(45000, result.long_sum);
+    EXPECT_EQ(int64_t(9000), std::get<int64_t>(result.max));
+  }
+
+  re.SetCodecVersion(CODEC_VERSION_V2);
+  std::string value;
+  ASSERT_EQ(0, re.Encode('r', make_record(3, false), key, value));
+  EXPECT_EQ(v2_value, value);
+}
+
+TEST_F(DingoSerialTest, deltaList) {
+  std::vector<BaseSchemaPtr> schemas;
+  auto id = std::make_shared<DingoSchema<int64_t>>();
+  id->SetIndex(0);
+  id->SetIsKey(true);
+  schemas.push_back(id);
+  auto times = std::make_shared<DingoSchema<std::vector<int64_t>>>();
+  times->SetIndex(1);
+  times->SetAllowNull(true);
+  times->SetDeltaValue(true);
+  schemas.push_back(times);
+  // Delta takes precedence over compact.
+  auto counts = std::make_shared<DingoSchema<std::vector<int32_t>>>();
+  counts->SetIndex(2);
+  counts->SetAllowNull(true);
+  counts->SetDeltaValue(true);
+  counts->SetCompactValue(true);
+  schemas.push_back(counts);
+  auto total = std::make_shared<DingoSchema<int64_t>>();
+  total->SetIndex(3);
+  total->SetAllowNull(true);
+  total->SetCompactValue(true);
+  schemas.push_back(total);
+
+  std::vector<int64_t> steady(500);
+  std::vector<int32_t> counters(500);
+  for (size_t i = 0; i < steady.size(); ++i) {
+    steady[i] = 1700000000000 + i * 1000;
+    counters[i] = i * i;
+  }
+  std::vector<Value> record = {int64_t(1), steady, counters, int64_t(42)};
+
+  RecordEncoderV2 re(0, schemas, 0L, this->le);
+  RecordDecoderV2 rd(0, schemas, 0L, this->le);
+
+  std::string v2_key, v2_value;
+  ASSERT_EQ(0, re.Encode('r', record, v2_key, v2_value));
+  re.SetCodecVersion(CODEC_VERSION_V3);
+  std::string key, value;
+  ASSERT_EQ(0, re.Encode('r', record, key, value));
+  EXPECT_LT(value.size(), v2_value.size() / 4);
+  size_t key_size, value_size;
+  re.ComputeEncodedSize(record, key_size, value_size);
+  EXPECT_EQ(value.size(), value_size);
+
+  for (const auto& [row_key, row_value] :
+       {std::make_pair(&v2_key, &v2_value), std::make_pair(&key, &value)}) {
+    std::vector<Value> decoded;
+    ASSERT_EQ(0, rd.Decode(*row_key, *row_value, decoded));
+    EXPECT_EQ(record, decoded);
+
+    std::vector<std::any> any_decoded;
+    ASSERT_EQ(0, rd.Decode(*row_key, *row_value, {2, 3}, any_decoded));
+    EXPECT_EQ(counters, std::any_cast<std::vector<int32_t>>(any_decoded[0]));
+    EXPECT_EQ(42, std::any_cast<int64_t>(any_decoded[1]));
+
+    RecordView view;
+    ASSERT_EQ(0, rd.View(*row_key, *row_value, view));
+    EXPECT_EQ(record[1], view.GetValue(1));
+    EXPECT_EQ(42, view.GetInt64(3));
+
+    std::vector<ColumnVector> columns;
+    ASSERT_EQ(0, rd.DecodeBatch({KeyValue(*row_key, *row_value)}, {1, 2},
+                                columns));
+    EXPECT_EQ(record[1], columns[0].values[0]);
+    EXPECT_EQ(record[2], columns[1].values[0]);
+  }
+
+  // A second batch decodes into the lists of the first one.
+  std::vector<ColumnVector> columns;
+  ASSERT_EQ(0, rd.DecodeBatch({KeyValue(key, value)}, {1}, columns));
+  const int64_t* list =
+      std::get<std::vector<int64_t>>(columns[0].values[0]).data();
+  ASSERT_EQ(0, rd.DecodeBatch({KeyValue(key, value)}, {1}, columns));
+  EXPECT_EQ(record[1], columns[0].values[0]);
+  EXPECT_EQ(list, std::get<std::vector<int64_t>>(columns[0].values[0]).data());
+
+  // Lists that do not shrink keep the plain form.
+  std::vector<int64_t> scattered(64);
+  for (size_t i = 0; i < scattered.size(); ++i) {
+    scattered[i] = i % 2 == 0 ? INT64_MIN : INT64_MAX;
+  }
+  record[1] = scattered;
+  ASSERT_EQ(0, re.Encode('r', record, key, value));
+  std::vector<Value> decoded;
+  ASSERT_EQ(0, rd.Decode(key, value, decoded));
+  EXPECT_EQ(record, decoded);
+
+  re.SetCodecVersion(CODEC_VERSION_V2);
+  record[1] = steady;
+  ASSERT_EQ(0, re.Encode('r', record, key, value));
+  EXPECT_EQ(v2_key, key);
+  EXPECT_EQ(v2_value, value);
+}
+
+TEST_F(DingoSerialTest, deflateValue) {
+  // 30 nullable strings and a nullable int, enough columns for sparse rows.
+  std::vector<BaseSchemaPtr> schemas;
+  auto id = std::make_shared<DingoSchema<int64_t>>();
+  id->SetIndex(0);
+  id->SetIsKey(true);
+  id->SetAllowNull(false);
+  schemas.push_back(id);
+  for (int i = 1; i <= 30; ++i) {
+    auto column = std::make_shared<DingoSchema<std::string>>();
+    column->SetIndex(i);
+    column->SetAllowNull(true);
+    schemas.push_back(column);
+  }
+  auto amount = std::make_shared<DingoSchema<int32_t>>();
+  amount->SetIndex(31);
+  amount->SetAllowNull(true);
+  schemas.push_back(amount);
+
+  std::vector<std::vector<Value>> records;
+  std::vector<Value> full(schemas.size());
+  full[0] = int64_t(1);
+  for (int i = 1; i <= 30; ++i) {
+    full[i] = "status=active country=NO column=" + std::to_string(i);
+  }
+  full[31] = int32_t(7);
+  records.push_back(full);
+  std::vector<Value> sparse(schemas.size());
+  sparse[0] = int64_t(2);
+  std::string text;
+  for (int i = 0; i < 20; ++i) {
+    text += "status=active country=NO;";
+  }
+  sparse[1] = text;
+  sparse[31] = int32_t(11);
+  records.push_back(sparse);
+  std::vector<Value> small(schemas.size());
+  small[0] = int64_t(3);
+  small[31] = int32_t(5);
+  records.push_back(small);
+
+  RecordEncoderV2 re(0, schemas, 0L, this->le);
+  EXPECT_THROW(re.SetDeflateValue(64), std::runtime_error);
+  re.SetDeflateValue(0);
+  re.SetCodecVersion(CODEC_VERSION_V3);
+  RecordDecoderV2 rd(0, schemas, 0L, this->le);
+  auto filter =
+      rd.CompileFilter({{31, Predicate::kBetween, {int32_t(6), int32_t(99)}}});
+
+  for (int layout = 0; layout < 3; ++layout) {
+    RecordEncoderV2 re_raw(0, schemas, 0L, this->le);
+    re_raw.SetCodecVersion(CODEC_VERSION_V3);
+    re_raw.SetDenseValue(layout == 1);
+    re_raw.SetFixedBlockValue(layout == 2);
+    RecordEncoderV2 re_deflate = re_raw;
+    re_deflate.SetDeflateValue(128);
+    EXPECT_EQ(128, re_deflate.GetDeflateThreshold());
+
+    std::vector<KeyValue> key_values;
+    for (size_t row = 0; row < records.size(); ++row) {
+      const auto& record = records[row];
+      std::string key, value, raw_value;
+      ASSERT_EQ(0, re_deflate.Encode('r', record, key, value));
+      ASSERT_LT(0, re_raw.EncodeValue(record, raw_value));
+      if (row < 2) {
+        EXPECT_EQ(VALUE_DEFLATED, value[4] & VALUE_DEFLATED);
+        EXPECT_LT(value.size(), raw_value.size() / 2);
+      } else {
+        EXPECT_EQ(raw_value, value);
+      }
+      size_t key_size, value_size;
+      re_deflate.ComputeEncodedSize(record, key_size, value_size);
+      EXPECT_LE(value.size(), value_size);
+
+      std::vector<Value> decoded;
+      ASSERT_EQ(0, rd.Decode(key, value, decoded));
+      EXPECT_EQ(record, decoded);
+      ASSERT_EQ(0, rd.Decode(key, value, {31, 1}, decoded));
+      EXPECT_EQ(record[31], decoded[0]);
+      EXPECT_EQ(record[1], decoded[1]);
+      std::vector<std::any> any_decoded;
+      ASSERT_EQ(0, rd.Decode(key, value, any_decoded));
+      EXPECT_EQ(std::get<int32_t>(record[31]),
+                std::any_cast<int32_t>(any_decoded[31]));
+
+      RecordView view;
+      ASSERT_EQ(0, rd.View(key, value, view));
+      EXPECT_EQ(record[1], view.GetValue(1));
+      EXPECT_EQ(record[30], view.GetValue(30));
+      EXPECT_EQ(std::get<int32_t>(record[31]), view.GetInt32(31));
+      EXPECT_EQ(row != 2, rd.Match(key, value, filter));
+      key_values.emplace_back(key, value);
+    }
+
+    std::vector<ColumnVector> columns;
+    ASSERT_EQ(0, rd.DecodeBatch(key_values, {1, 31}, columns));
+    EXPECT_EQ(std::get<std::string>(full[1]), columns[0].GetString(0));
+    EXPECT_EQ(text, columns[0].GetString(1));
+    EXPECT_TRUE(columns[0].IsNull(2));
+    EXPECT_EQ(std::vector<int32_t>({7, 11, 5}), columns[1].ints);
+
+    AggregateResult result;
+    ASSERT_EQ(0, rd.Aggregate(key_values, 31, result));
+    EXPECT_EQ(3, result.count);
+    EXPECT_EQ(23, result.long_sum);
+
+    EncodedBatch batch;
+    ASSERT_EQ(0, re_deflate.EncodeBatch('r', records, batch));
+    for (size_t row = 0; row < records.size(); ++row) {
+      EXPECT_EQ(key_values[row].GetValue(), batch.GetValue(row));
+    }
+  }
+
+  // Views of deflated rows own their inflated copy, so one decoder serves
+  // several live views.
+  {
+    RecordEncoderV2 re_deflate(0, schemas, 0L, this->le);
+    re_deflate.SetCodecVersion(CODEC_VERSION_V3);
+    re_deflate.SetDeflateValue(128);
+    std::string full_key, full_value, sparse_key, sparse_value;
+    ASSERT_EQ(0, re_deflate.Encode('r', full, full_key, full_value));
+    ASSERT_EQ(0, re_deflate.Encode('r', sparse, sparse_key, sparse_value));
+    RecordView full_view, sparse_view;
+    ASSERT_EQ(0, rd.View(full_key, full_value, full_view));
+    ASSERT_EQ(0, rd.View(sparse_key, sparse_value, sparse_view));
+    EXPECT_EQ(std::get<std::string>(full[1]), full_view.GetString(1));
+    EXPECT_EQ(text, sparse_view.GetString(1));
+    EXPECT_EQ(7, full_view.GetInt32(31));
+
+    // Decode and Match reuse the decoder's inflate buffer row after row.
+    std::vector<Value> decoded;
+    ASSERT_EQ(0, rd.Decode(full_key, full_value, decoded));
+    EXPECT_EQ(full, decoded);
+    ASSERT_EQ(0, rd.Decode(sparse_key, sparse_value, decoded));
+    EXPECT_EQ(sparse, decoded);
+    ASSERT_EQ(0, rd.Decode(full_key, full_value, {31, 1}, decoded));
+    EXPECT_EQ(full[31], decoded[0]);
+    EXPECT_EQ(full[1], decoded[1]);
+    ASSERT_EQ(0, rd.Decode(sparse_key, sparse_value, {31, 1}, decoded));
+    EXPECT_EQ(sparse[31], decoded[0]);
+    EXPECT_EQ(sparse[1], decoded[1]);
+    EXPECT_EQ(1, rd.Match(full_key, full_value, filter));
+    EXPECT_EQ(1, rd.Match(sparse_key, sparse_value, filter));
+  }
+
+  // A dictionary of typical bytes lets small values shrink too, decoding
+  // them needs the same dictionary.
+  std::vector<Value> record(schemas.size());
+  record[0] = int64_t(4);
+  record[1] = std::string("status=active country=NO column=1");
+  record[2] = std::string("status=active country=NO column=2");
+  RecordEncoderV2 re_plain = re;
+  re_plain.SetDeflateValue(16);
+  re.SetDeflateValue(16);
+  re.SetValueDictionary(std::get<std::string>(full[1]) +
+                        std::get<std::string>(full[2]));
+  EXPECT_FALSE(re.GetValueDictionary().empty());
+  std::string key, value, plain_value;
+  ASSERT_EQ(0, re.Encode('r', record, key, value));
+  ASSERT_LT(0, re_plain.EncodeValue(record, plain_value));
+  EXPECT_LT(value.size(), plain_value.size());
+  EXPECT_EQ(VALUE_DEFLATED, value[4] & VALUE_DEFLATED);
+  std::vector<Value> decoded;
+  EXPECT_THROW(rd.Decode(key, value, decoded), std::runtime_error);
+  rd.SetValueDictionary(re.GetValueDictionary());
+  ASSERT_EQ(0, rd.Decode(key, value, decoded));
+  EXPECT_EQ(record, decoded);
+
+  // Back to V2 turns deflating off.
+  re.SetCodecVersion(CODEC_VERSION_V2);
+  EXPECT_EQ(0, re.GetDeflateThreshold());
+  ASSERT_EQ(0, re.Encode('r', records[0], key, value));
+  ASSERT_EQ(0, rd.Decode(key, value, decoded));
+  EXPECT_EQ(records[0], decoded);
+}
+
+TEST_F(DingoSerialTest, dictionaryBatch) {
+  std::vector<BaseSchemaPtr> schemas;
+  auto region = std::make_shared<DingoSchema<std::string>>();
+  region->SetIndex(0);
+  region->SetIsKey(true);
+  region->SetAllowNull(false);
+  schemas.push_back(region);
+  auto id = std::make_shared<DingoSchema<int64_t>>();
+  id->SetIndex(1);
+  id->SetIsKey(true);
+  id->SetAllowNull(false);
+  schemas.push_back(id);
+  auto status = std::make_shared<DingoSchema<std::string>>();
+  status->SetIndex(2);
+  status->SetAllowNull(true);
+  schemas.push_back(status);
+  auto note = std::make_shared<DingoSchema<std::string>>();
+  note->SetIndex(3);
+  note->SetAllowNull(true);
+  schemas.push_back(note);
+
+  const std::vector<std::string> statuses = {"active", "blocked", "", "gone"};
+  std::vector<std::vector<Value>> records;
+  for (int i = 0; i < 1000; ++i) {
+    std::vector<Value> record(schemas.size());
+    record[0] = std::string(i % 2 == 0 ? "eu" : "us");
+    record[1] = int64_t(i);
+    if (i % 7 != 3) {
+      record[2] = statuses[i % statuses.size()];
+    }
+    record[3] = std::string(300, 'a' + i % 26) + std::to_string(i);
+    records.push_back(record);
+  }
+
+  // Half the rows deflated, their strings come from the reused inflate
+  // buffer.
+  RecordEncoderV2 re(0, schemas, 0L, this->le);
+  RecordEncoderV2 re_deflate(0, schemas, 0L, this->le);
+  re_deflate.SetCodecVersion(CODEC_VERSION_V3);
+  re_deflate.SetDeflateValue(64);
+  std::vector<KeyValue> key_values;
+  for (size_t i = 0; i < records.size(); ++i) {
+    std::string key, value;
+    auto& encoder = i % 2 == 0 ? re : re_deflate;
+    ASSERT_EQ(0, encoder.Encode('r', records[i], key, value));
+    key_values.emplace_back(key, value);
+  }
+
+  RecordDecoderV2 rd(0, schemas, 0L, this->le);
+  std::vector<ColumnVector> plain;
+  ASSERT_EQ(0, rd.DecodeBatch(key_values, {0, 2, 3}, plain));
+  rd.SetDictionaryBatch(true);
+  EXPECT_TRUE(rd.IsDictionaryBatch());
+  std::vector<ColumnVector> columns;
+  for (int round = 0; round < 2; ++round) {
+    ASSERT_EQ(0, rd.DecodeBatch(key_values, {0, 2, 3, 1}, columns));
+    ASSERT_EQ(4, columns.size());
+    for (int i = 0; i < 3; ++i) {
+      EXPECT_TRUE(columns[i].dictionary);
+    }
+    EXPECT_FALSE(columns[3].dictionary);
+    EXPECT_EQ(2, columns[0].DictionarySize());
+    EXPECT_EQ(statuses.size(), columns[1].DictionarySize());
+    EXPECT_EQ(records.size(), columns[2].DictionarySize());
+
+    for (size_t row = 0; row < records.size(); ++row) {
+      for (int i = 0; i < 3; ++i) {
+        EXPECT_EQ(plain[i].IsNull(row), columns[i].IsNull(row));
+        EXPECT_EQ(plain[i].GetString(row), columns[i].GetString(row));
+      }
+      EXPECT_EQ(row % 2, columns[0].codes[row]);
+      EXPECT_EQ(row, columns[3].longs[row]);
+      if (!columns[1].IsNull(row)) {
+        EXPECT_EQ(columns[1].GetEntry(columns[1].codes[row]),
+                  std::get<std::string>(records[row][2]));
+      }
+    }
+  }
+
+  // Same codes for the same strings, the first one seen gets 0.
+  EXPECT_EQ("active", columns[1].GetEntry(0));
+  EXPECT_EQ(columns[1].codes[4], columns[1].codes[8]);
+
+  rd.SetDictionaryBatch(false);
+  ASSERT_EQ(0, rd.DecodeBatch(key_values, {2}, columns));
+  EXPECT_FALSE(columns[0].dictionary);
+  EXPECT_TRUE(columns[0].codes.empty());
+  EXPECT_EQ(plain[1].offsets, columns[0].offsets);
+  EXPECT_EQ(plain[1].bytes, columns[0].bytes);
+}